@@ -0,0 +1,86 @@
+#include <string.h>
+#include "ScratchMemory.h"
+
+FrameArena::FrameArena(size_t BlockSize) : m_Head(nullptr), m_BlockSize(BlockSize)
+{
+}
+
+FrameArena::~FrameArena()
+{
+	while (m_Head)
+	{
+		Block *next = m_Head->Next;
+		free(m_Head);
+		m_Head = next;
+	}
+}
+
+FrameArena::Block *FrameArena::AllocateBlock(size_t Size)
+{
+	auto block = (Block *)malloc(sizeof(Block) + Size);
+
+	if (!block)
+		throw std::bad_alloc();
+
+	block->Next = nullptr;
+	block->Size = Size;
+	block->Used = 0;
+	return block;
+}
+
+void *FrameArena::Allocate(size_t Size, size_t Alignment)
+{
+	if (m_Head)
+	{
+		uintptr_t base = (uintptr_t)(m_Head + 1);
+		uintptr_t start = (base + m_Head->Used + (Alignment - 1)) & ~(uintptr_t)(Alignment - 1);
+
+		if (start + Size <= base + m_Head->Size)
+		{
+			m_Head->Used = (start + Size) - base;
+			return (void *)start;
+		}
+	}
+
+	// Out of space, chain a new block large enough for this request
+	Block *block = AllocateBlock(std::max(m_BlockSize, Size + Alignment));
+	block->Next = m_Head;
+	m_Head = block;
+
+	return Allocate(Size, Alignment);
+}
+
+const char *FrameArena::Strdup(const char *String)
+{
+	const size_t length = strlen(String) + 1;
+	auto copy = (char *)Allocate(length, 1);
+
+	memcpy(copy, String, length);
+	return copy;
+}
+
+void FrameArena::Reset()
+{
+	if (!m_Head)
+		return;
+
+	if (!m_Head->Next)
+	{
+		m_Head->Used = 0;
+		return;
+	}
+
+	// Several blocks were needed, replace them with one that fits everything next time
+	size_t totalSize = 0;
+
+	while (m_Head)
+	{
+		Block *next = m_Head->Next;
+		totalSize += m_Head->Size;
+		free(m_Head);
+		m_Head = next;
+	}
+
+	m_BlockSize = std::max(m_BlockSize, totalSize);
+	m_Head = AllocateBlock(m_BlockSize);
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+//
+// Vector with room for N elements stored inline. The heap is only touched once more than N elements are added, so the
+// short-lived arrays hooks build on every call usually never allocate.
+//
+template<typename T, size_t N>
+class SmallVector
+{
+private:
+	T *m_Data;
+	size_t m_Size;
+	size_t m_Capacity;
+	alignas(T) uint8_t m_Inline[N * sizeof(T)];
+
+public:
+	SmallVector() : m_Data((T *)m_Inline), m_Size(0), m_Capacity(N)
+	{
+	}
+
+	~SmallVector()
+	{
+		clear();
+
+		if (!IsInline())
+			free(m_Data);
+	}
+
+	SmallVector(const SmallVector&) = delete;
+	SmallVector& operator=(const SmallVector&) = delete;
+
+	T *begin() { return m_Data; }
+	T *end() { return m_Data + m_Size; }
+	const T *begin() const { return m_Data; }
+	const T *end() const { return m_Data + m_Size; }
+
+	T *data() { return m_Data; }
+	const T *data() const { return m_Data; }
+
+	T& operator[](size_t Pos) { return m_Data[Pos]; }
+	const T& operator[](size_t Pos) const { return m_Data[Pos]; }
+
+	T& back() { return m_Data[m_Size - 1]; }
+	const T& back() const { return m_Data[m_Size - 1]; }
+
+	size_t size() const { return m_Size; }
+	size_t capacity() const { return m_Capacity; }
+	bool empty() const { return m_Size == 0; }
+
+	bool IsInline() const
+	{
+		return m_Data == (const T *)m_Inline;
+	}
+
+	void reserve(size_t Count)
+	{
+		if (Count <= m_Capacity)
+			return;
+
+		T *newData = (T *)malloc(Count * sizeof(T));
+
+		if (!newData)
+			throw std::bad_alloc();
+
+		std::uninitialized_move(m_Data, m_Data + m_Size, newData);
+		std::destroy(m_Data, m_Data + m_Size);
+
+		if (!IsInline())
+			free(m_Data);
+
+		m_Data = newData;
+		m_Capacity = Count;
+	}
+
+	template<typename... Args>
+	T& emplace_back(Args&&... Arguments)
+	{
+		if (m_Size == m_Capacity)
+			reserve(std::max<size_t>(m_Capacity * 2, 4));
+
+		return *new (&m_Data[m_Size++]) T(std::forward<Args>(Arguments)...);
+	}
+
+	void push_back(const T& Value)
+	{
+		// Value may live in the buffer that's about to move
+		T copy = Value;
+		emplace_back(std::move(copy));
+	}
+
+	void clear()
+	{
+		std::destroy(m_Data, m_Data + m_Size);
+		m_Size = 0;
+	}
+};
+
+//
+// Bump allocator for temporaries that all die at the same point, i.e. strings copied during a deferred UI update or a
+// batch of log lines. Reset() frees everything at once and keeps a single block sized for the previous frame, so a
+// steady workload stops allocating after the first pass. Not thread safe.
+//
+class FrameArena
+{
+private:
+	struct Block
+	{
+		Block *Next;
+		size_t Size;
+		size_t Used;
+	};
+
+	Block *m_Head;
+	size_t m_BlockSize;
+
+	Block *AllocateBlock(size_t Size);
+
+public:
+	explicit FrameArena(size_t BlockSize = 64 * 1024);
+	~FrameArena();
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	void *Allocate(size_t Size, size_t Alignment = alignof(std::max_align_t));
+	const char *Strdup(const char *String);
+	void Reset();
+};
\ No newline at end of file
@@ -0,0 +1,250 @@
+#include <algorithm>
+#include "CategoryTreeModel.h"
+
+CategoryTreeModel::CategoryTreeModel()
+{
+	Clear();
+}
+
+void CategoryTreeModel::Clear()
+{
+	m_Nodes.clear();
+	m_Lookup.clear();
+	m_Count = 0;
+	m_CreatedCount = 0;
+
+	// The root's children always exist, the control has nowhere else to put them
+	m_Nodes.push_back({ npos, npos, npos, npos, npos, 0, 0, 0, true, false });
+}
+
+uint32_t CategoryTreeModel::Count() const
+{
+	return m_Count;
+}
+
+uint32_t CategoryTreeModel::CreatedCount() const
+{
+	return m_CreatedCount;
+}
+
+bool CategoryTreeModel::IsValid(NodeId Node) const
+{
+	return Node < m_Nodes.size() && !m_Nodes[Node].Removed;
+}
+
+CategoryTreeModel::NodeId CategoryTreeModel::Insert(NodeId Parent, Placement Where, NodeId Sibling)
+{
+	if (!IsValid(Parent))
+		return npos;
+
+	// An unknown or foreign sibling falls back to appending, same as the control does with a bad insert-after
+	if (Where == Placement::After && (!IsValid(Sibling) || Sibling == Root || m_Nodes[Sibling].Parent != Parent))
+		Where = Placement::Last;
+
+	const NodeId node = (NodeId)m_Nodes.size();
+	m_Nodes.push_back({ Parent, npos, npos, npos, npos, 0, 0, 0, true, false });
+
+	auto& parent = m_Nodes[Parent];
+	auto& entry = m_Nodes[node];
+
+	switch (Where)
+	{
+	case Placement::First:
+		entry.NextSibling = parent.FirstChild;
+		break;
+
+	case Placement::Last:
+		entry.PrevSibling = parent.LastChild;
+		break;
+
+	case Placement::After:
+		entry.PrevSibling = Sibling;
+		entry.NextSibling = m_Nodes[Sibling].NextSibling;
+		break;
+	}
+
+	if (entry.PrevSibling != npos)
+		m_Nodes[entry.PrevSibling].NextSibling = node;
+	else
+		parent.FirstChild = node;
+
+	if (entry.NextSibling != npos)
+		m_Nodes[entry.NextSibling].PrevSibling = node;
+	else
+		parent.LastChild = node;
+
+	parent.ChildCount++;
+	m_Count++;
+	return node;
+}
+
+void CategoryTreeModel::Remove(NodeId Node)
+{
+	if (!IsValid(Node))
+		return;
+
+	if (Node == Root)
+	{
+		Clear();
+		return;
+	}
+
+	Unlink(Node);
+
+	ForEach(Node, [this](NodeId Current)
+	{
+		auto& entry = m_Nodes[Current];
+
+		if (entry.Handle != 0)
+			m_Lookup.erase(entry.Handle);
+
+		if (entry.Created != 0)
+		{
+			m_Lookup.erase(entry.Created);
+			m_CreatedCount--;
+		}
+
+		entry.Removed = true;
+		m_Count--;
+	});
+}
+
+void CategoryTreeModel::Unlink(NodeId Node)
+{
+	auto& entry = m_Nodes[Node];
+	auto& parent = m_Nodes[entry.Parent];
+
+	if (entry.PrevSibling != npos)
+		m_Nodes[entry.PrevSibling].NextSibling = entry.NextSibling;
+	else
+		parent.FirstChild = entry.NextSibling;
+
+	if (entry.NextSibling != npos)
+		m_Nodes[entry.NextSibling].PrevSibling = entry.PrevSibling;
+	else
+		parent.LastChild = entry.PrevSibling;
+
+	parent.ChildCount--;
+}
+
+CategoryTreeModel::NodeId CategoryTreeModel::Parent(NodeId Node) const
+{
+	return IsValid(Node) ? m_Nodes[Node].Parent : npos;
+}
+
+CategoryTreeModel::NodeId CategoryTreeModel::FirstChild(NodeId Node) const
+{
+	return IsValid(Node) ? m_Nodes[Node].FirstChild : npos;
+}
+
+CategoryTreeModel::NodeId CategoryTreeModel::NextSibling(NodeId Node) const
+{
+	return IsValid(Node) ? m_Nodes[Node].NextSibling : npos;
+}
+
+CategoryTreeModel::NodeId CategoryTreeModel::PrevSibling(NodeId Node) const
+{
+	return IsValid(Node) ? m_Nodes[Node].PrevSibling : npos;
+}
+
+uint32_t CategoryTreeModel::ChildCount(NodeId Node) const
+{
+	return IsValid(Node) ? m_Nodes[Node].ChildCount : 0;
+}
+
+void CategoryTreeModel::Bind(NodeId Node, uint64_t Handle)
+{
+	if (!IsValid(Node) || Node == Root)
+		return;
+
+	auto& entry = m_Nodes[Node];
+
+	if (entry.Handle != 0 && entry.Handle != entry.Created)
+		m_Lookup.erase(entry.Handle);
+
+	entry.Handle = Handle;
+
+	if (Handle != 0)
+		m_Lookup[Handle] = Node;
+}
+
+void CategoryTreeModel::SetCreated(NodeId Node, uint64_t Created)
+{
+	if (!IsValid(Node) || Node == Root)
+		return;
+
+	auto& entry = m_Nodes[Node];
+
+	if (entry.Created != 0)
+	{
+		if (entry.Created != entry.Handle)
+			m_Lookup.erase(entry.Created);
+
+		m_CreatedCount--;
+	}
+
+	entry.Created = Created;
+
+	if (Created != 0)
+	{
+		m_Lookup[Created] = Node;
+		m_CreatedCount++;
+	}
+}
+
+uint64_t CategoryTreeModel::Handle(NodeId Node) const
+{
+	return IsValid(Node) ? m_Nodes[Node].Handle : 0;
+}
+
+uint64_t CategoryTreeModel::CreatedHandle(NodeId Node) const
+{
+	return IsValid(Node) ? m_Nodes[Node].Created : 0;
+}
+
+bool CategoryTreeModel::IsCreated(NodeId Node) const
+{
+	return Node == Root || (IsValid(Node) && m_Nodes[Node].Created != 0);
+}
+
+CategoryTreeModel::NodeId CategoryTreeModel::Find(uint64_t Handle) const
+{
+	if (Handle == 0)
+		return npos;
+
+	auto itr = m_Lookup.find(Handle);
+	return (itr != m_Lookup.end()) ? itr->second : npos;
+}
+
+bool CategoryTreeModel::ChildrenCreated(NodeId Node) const
+{
+	return IsValid(Node) && m_Nodes[Node].ChildrenCreated;
+}
+
+void CategoryTreeModel::SetChildrenCreated(NodeId Node, bool Created)
+{
+	if (IsValid(Node) && Node != Root)
+		m_Nodes[Node].ChildrenCreated = Created;
+}
+
+bool CategoryTreeModel::HasPendingChildren(NodeId Node) const
+{
+	return IsValid(Node) && m_Nodes[Node].ChildCount > 0 && !m_Nodes[Node].ChildrenCreated;
+}
+
+std::vector<CategoryTreeModel::NodeId> CategoryTreeModel::PendingAncestors(NodeId Node) const
+{
+	std::vector<NodeId> ancestors;
+
+	if (!IsValid(Node))
+		return ancestors;
+
+	for (NodeId parent = m_Nodes[Node].Parent; parent != npos; parent = m_Nodes[parent].Parent)
+	{
+		if (!m_Nodes[parent].ChildrenCreated)
+			ancestors.push_back(parent);
+	}
+
+	std::reverse(ancestors.begin(), ancestors.end());
+	return ancestors;
+}
\ No newline at end of file
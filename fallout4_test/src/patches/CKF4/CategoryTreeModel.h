@@ -0,0 +1,110 @@
+#pragma once
+
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+//
+// Mirror of a tree view's items that lets the control be filled lazily. Every item the editor inserts gets a node
+// here, but only nodes whose parent has had its children created exist in the control. Each node remembers the
+// handle the editor was given for it and, once it exists, the control's own handle. Handles are opaque 64 bit
+// values and there are no Win32 types, so it can be exercised on its own.
+//
+class CategoryTreeModel
+{
+public:
+	using NodeId = uint32_t;
+
+	static constexpr NodeId Root = 0;
+	static constexpr NodeId npos = UINT32_MAX;
+
+	enum class Placement
+	{
+		First,
+		Last,
+		After,
+	};
+
+private:
+	struct Node
+	{
+		NodeId Parent;
+		NodeId FirstChild;
+		NodeId LastChild;
+		NodeId PrevSibling;
+		NodeId NextSibling;
+		uint32_t ChildCount;
+		uint64_t Handle;			// What the editor knows the item as, 0 until bound
+		uint64_t Created;			// Control's handle, 0 until the item exists there
+		bool ChildrenCreated;		// All children exist in the control (or were created directly)
+		bool Removed;
+	};
+
+	std::vector<Node> m_Nodes;
+	std::unordered_map<uint64_t, NodeId> m_Lookup;	// Both kinds of handle -> node
+	uint32_t m_Count = 0;
+	uint32_t m_CreatedCount = 0;
+
+public:
+	CategoryTreeModel();
+
+	void Clear();
+	uint32_t Count() const;
+	uint32_t CreatedCount() const;
+	bool IsValid(NodeId Node) const;
+
+	NodeId Insert(NodeId Parent, Placement Where, NodeId Sibling = npos);
+	void Remove(NodeId Node);
+
+	NodeId Parent(NodeId Node) const;
+	NodeId FirstChild(NodeId Node) const;
+	NodeId NextSibling(NodeId Node) const;
+	NodeId PrevSibling(NodeId Node) const;
+	uint32_t ChildCount(NodeId Node) const;
+
+	void Bind(NodeId Node, uint64_t Handle);
+	void SetCreated(NodeId Node, uint64_t Created);
+	uint64_t Handle(NodeId Node) const;
+	uint64_t CreatedHandle(NodeId Node) const;
+	bool IsCreated(NodeId Node) const;
+	NodeId Find(uint64_t Handle) const;
+
+	bool ChildrenCreated(NodeId Node) const;
+	void SetChildrenCreated(NodeId Node, bool Created);
+	bool HasPendingChildren(NodeId Node) const;
+
+	// Ancestors whose children have to be created, outermost first, before Node can exist in the control
+	std::vector<NodeId> PendingAncestors(NodeId Node) const;
+
+	//
+	// Visits Node and everything below it in pre-order (the root itself is skipped). Removing nodes from inside the
+	// callback isn't allowed.
+	//
+	template<typename Callback>
+	void ForEach(NodeId Node, Callback&& Fn) const
+	{
+		std::vector<NodeId> stack;
+
+		if (Node == Root)
+		{
+			for (NodeId child = m_Nodes[Root].LastChild; child != npos; child = m_Nodes[child].PrevSibling)
+				stack.push_back(child);
+		}
+		else
+			stack.push_back(Node);
+
+		while (!stack.empty())
+		{
+			const NodeId current = stack.back();
+			stack.pop_back();
+
+			Fn(current);
+
+			for (NodeId child = m_Nodes[current].LastChild; child != npos; child = m_Nodes[child].PrevSibling)
+				stack.push_back(child);
+		}
+	}
+
+private:
+	void Unlink(NodeId Node);
+};
\ No newline at end of file
@@ -0,0 +1,191 @@
+#include "../../common.h"
+#include <CommCtrl.h>
+#include <algorithm>
+#include "ComboBoxSearch.h"
+
+namespace ComboBoxSearch
+{
+	struct SearchState
+	{
+		TypeAheadIndex Index;
+		bool Dirty = true;			// Items changed since the index was built
+		std::string Typed;			// Characters typed so far in this burst
+		DWORD LastKeyTime = 0;
+	};
+
+	// Small lists are left to the control
+	constexpr LRESULT MinimumItems = 256;
+
+	// Keystrokes further apart than this start a new search, same as the list box's own type-ahead
+	constexpr DWORD TypeAheadTimeout = 1000;
+
+	bool Enabled;
+	bool SubstringFallback;
+
+	void Initialize(bool Enable, bool MatchSubstrings)
+	{
+		Enabled = Enable;
+		SubstringFallback = MatchSubstrings;
+	}
+
+	SearchState *GetState(HWND ComboBoxHandle)
+	{
+		DWORD_PTR refData = 0;
+
+		if (!GetWindowSubclass(ComboBoxHandle, ComboBoxSubclass, 0, &refData))
+			return nullptr;
+
+		return (SearchState *)refData;
+	}
+
+	void Rebuild(HWND ComboBoxHandle, SearchState *State)
+	{
+		const LRESULT count = SendMessageA(ComboBoxHandle, CB_GETCOUNT, 0, 0);
+		std::vector<char> text;
+
+		State->Index.Clear();
+
+		for (LRESULT i = 0; i < count; i++)
+		{
+			LRESULT length = SendMessageA(ComboBoxHandle, CB_GETLBTEXTLEN, i, 0);
+
+			if (length == CB_ERR)
+				length = 0;
+
+			text.resize(length + 1);
+
+			if (length > 0)
+				length = std::max<LRESULT>(SendMessageA(ComboBoxHandle, CB_GETLBTEXT, i, (LPARAM)text.data()), 0);
+
+			State->Index.Add(text.data(), length);
+		}
+
+		State->Index.Finalize();
+		State->Dirty = false;
+	}
+
+	void Attach(HWND ComboBoxHandle)
+	{
+		if (!Enabled || !ComboBoxHandle)
+			return;
+
+		// Only drop down lists search on WM_CHAR. Owner drawn lists without strings have nothing to search.
+		const LONG_PTR style = GetWindowLongPtrA(ComboBoxHandle, GWL_STYLE);
+
+		if ((style & 0x3) != CBS_DROPDOWNLIST)
+			return;
+
+		if ((style & (CBS_OWNERDRAWFIXED | CBS_OWNERDRAWVARIABLE)) && !(style & CBS_HASSTRINGS))
+			return;
+
+		auto state = GetState(ComboBoxHandle);
+
+		if (!state)
+		{
+			if (SendMessageA(ComboBoxHandle, CB_GETCOUNT, 0, 0) < MinimumItems)
+				return;
+
+			state = new SearchState();
+			SetWindowSubclass(ComboBoxHandle, ComboBoxSubclass, 0, (DWORD_PTR)state);
+		}
+
+		// Called right after a deferred flush, so build now instead of on the first keystroke
+		Rebuild(ComboBoxHandle, state);
+	}
+
+	uint32_t FindWrapped(const TypeAheadIndex& Index, uint32_t Start, uint32_t(TypeAheadIndex:: *Find)(const char *, size_t, uint32_t) const, const std::string& Value)
+	{
+		uint32_t item = (Index.*Find)(Value.data(), Value.size(), Start);
+
+		if (item == TypeAheadIndex::npos && Start > 0)
+			item = (Index.*Find)(Value.data(), Value.size(), 0);
+
+		return item;
+	}
+
+	LRESULT HandleChar(HWND ComboBoxHandle, SearchState *State, char Character)
+	{
+		const DWORD now = GetTickCount();
+
+		if (now - State->LastKeyTime > TypeAheadTimeout)
+			State->Typed.clear();
+
+		State->LastKeyTime = now;
+		State->Typed.push_back(Character);
+
+		if (State->Dirty)
+			Rebuild(ComboBoxHandle, State);
+
+		const auto& index = State->Index;
+		const LRESULT current = DefSubclassProc(ComboBoxHandle, CB_GETCURSEL, 0, 0);
+		const uint32_t start = (current == CB_ERR) ? 0 : (uint32_t)current;
+		uint32_t item = TypeAheadIndex::npos;
+
+		// A single key, or the same key pressed repeatedly, steps to the next item starting with it. Longer strings
+		// keep the current item if it still matches.
+		const bool repeated = std::all_of(State->Typed.begin(), State->Typed.end(), [&](char C)
+		{
+			return TypeAheadIndex::Fold(C) == TypeAheadIndex::Fold(State->Typed[0]);
+		});
+
+		if (repeated)
+			item = FindWrapped(index, (current == CB_ERR) ? 0 : start + 1, &TypeAheadIndex::FindPrefix, State->Typed.substr(0, 1));
+		else
+			item = FindWrapped(index, start, &TypeAheadIndex::FindPrefix, State->Typed);
+
+		if (item == TypeAheadIndex::npos && SubstringFallback)
+			item = FindWrapped(index, start, &TypeAheadIndex::FindSubstring, State->Typed);
+
+		if (item == TypeAheadIndex::npos || item == (uint32_t)current)
+			return 0;
+
+		DefSubclassProc(ComboBoxHandle, CB_SETCURSEL, item, 0);
+		SendMessageA(GetParent(ComboBoxHandle), WM_COMMAND, MAKEWPARAM(GetDlgCtrlID(ComboBoxHandle), CBN_SELCHANGE), (LPARAM)ComboBoxHandle);
+		return 0;
+	}
+
+	LRESULT CALLBACK ComboBoxSubclass(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam, UINT_PTR uIdSubclass, DWORD_PTR dwRefData)
+	{
+		auto state = (SearchState *)dwRefData;
+
+		switch (uMsg)
+		{
+		case WM_NCDESTROY:
+			RemoveWindowSubclass(hWnd, ComboBoxSubclass, uIdSubclass);
+			delete state;
+			break;
+
+		case CB_ADDSTRING:
+		case CB_INSERTSTRING:
+		case CB_DELETESTRING:
+		case CB_RESETCONTENT:
+		case CB_DIR:
+			state->Dirty = true;
+			break;
+
+		case WM_CHAR:
+			// Control characters (enter, escape, backspace) keep their normal behavior
+			if ((uint8_t)wParam >= ' ')
+				return HandleChar(hWnd, state, (char)wParam);
+			break;
+
+		case CB_FINDSTRING:
+		case CB_FINDSTRINGEXACT:
+		{
+			// Rebuilding here could turn a find-then-add loop quadratic, so a stale index defers to the control
+			if (state->Dirty || !lParam)
+				break;
+
+			const std::string value((const char *)lParam);
+			const uint32_t start = ((int)wParam < 0) ? 0 : (uint32_t)wParam + 1;
+			const uint32_t item = (uMsg == CB_FINDSTRING)
+				? FindWrapped(state->Index, start, &TypeAheadIndex::FindPrefix, value)
+				: FindWrapped(state->Index, start, &TypeAheadIndex::FindExact, value);
+
+			return (item != TypeAheadIndex::npos) ? (LRESULT)item : CB_ERR;
+		}
+		}
+
+		return DefSubclassProc(hWnd, uMsg, wParam, lParam);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "../../common.h"
+#include "TypeAheadIndex.h"
+
+namespace ComboBoxSearch
+{
+	void Initialize(bool Enable, bool MatchSubstrings);
+	void Attach(HWND ComboBoxHandle);
+
+	LRESULT CALLBACK ComboBoxSubclass(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam, UINT_PTR uIdSubclass, DWORD_PTR dwRefData);
+}
\ No newline at end of file
@@ -2,9 +2,15 @@
 #include <libdeflate/libdeflate.h>
 #include <xbyak/xbyak.h>
 #include <CommCtrl.h>
-#include <smmintrin.h>
+#include <atomic>
+#include <mutex>
+#include "../../ScratchMemory.h"
+#include "ComboBoxSearch.h"
 #include "Editor.h"
+#include "InflatePipeline.h"
+#include "LazyTreeView.h"
 #include "LogWindow.h"
+#include "PointerSearchIndex.h"
 
 #pragma comment(lib, "libdeflate.lib")
 
@@ -134,32 +140,92 @@ LRESULT WINAPI hk_SendMessageA(HWND hWnd, UINT Msg, WPARAM wParam, LPARAM lParam
 	return SendMessageA(hWnd, Msg, wParam, lParam);
 }
 
+//
+// Records normally arrive whole and go through a single libdeflate call. When a caller feeds a stream in pieces, or
+// its output buffer is too small for a non-finishing call, the stream is handed to the editor's own zlib instead.
+// That's a real incremental decoder, so working memory stays at zlib's window and nothing is decoded twice. Once
+// handed over, the stream owns a zlib state and the editor's unhooked inflateEnd frees it.
+//
+int(*g_EngineInflateInit)(z_stream_s *Stream, const char *Version, int Mode);
+int(*g_EngineInflate)(z_stream_s *Stream, int Flush);
+std::atomic<const char *> g_InflateVersion;
+std::atomic_int g_InflateMode;
+
+uintptr_t GetCallTarget(uintptr_t Target)
+{
+	Assert(*(uint8_t *)Target == 0xE8);
+
+	return Target + *(int32_t *)(Target + 1) + 5;
+}
+
+void PatchInflate(uintptr_t InitCall, uintptr_t InflateCall)
+{
+	// The original functions are still needed for streams that can't be decoded in one call
+	*(uintptr_t *)&g_EngineInflateInit = GetCallTarget(InitCall);
+	*(uintptr_t *)&g_EngineInflate = GetCallTarget(InflateCall);
+
+	XUtil::DetourCall(InitCall, &hk_inflateInit);
+	XUtil::DetourCall(InflateCall, &hk_inflate);
+}
+
 int hk_inflateInit(z_stream_s *Stream, const char *Version, int Mode)
 {
 	// Force inflateEnd to error out and skip frees
 	Stream->state = nullptr;
 
+	// Kept for streams that are handed to zlib later on
+	g_InflateVersion = Version;
+	g_InflateMode = Mode;
+
 	return 0;
 }
 
 int hk_inflate(z_stream_s *Stream, int Flush)
 {
+	ProfileCounterInc("Records Inflated");
+	ProfileTimer("Time Spent Inflating");
+
+	// A stream that was handed to zlib stays there until the editor reinitializes it
+	if (Stream->state)
+		return g_EngineInflate(Stream, Flush);
+
 	size_t outBytes = 0;
-	libdeflate_decompressor *decompressor = libdeflate_alloc_decompressor();
+	libdeflate_result result = LIBDEFLATE_SUCCESS;
 
-	libdeflate_result result = libdeflate_zlib_decompress(decompressor, Stream->next_in, Stream->avail_in, Stream->next_out, Stream->avail_out, &outBytes);
-	libdeflate_free_decompressor(decompressor);
+	// Records may already have been inflated by a worker while the file was scanned, or during an earlier load
+	if (!InflatePipeline::Lookup(Stream->next_in, Stream->avail_in, Stream->next_out, Stream->avail_out, &outBytes))
+	{
+		result = libdeflate_zlib_decompress(InflatePipeline::GetThreadDecompressor(), Stream->next_in, Stream->avail_in, Stream->next_out, Stream->avail_out, &outBytes);
+
+		if (result == LIBDEFLATE_SUCCESS)
+			InflatePipeline::Store(Stream->next_in, Stream->avail_in, Stream->next_out, outBytes);
+	}
 
 	if (result == LIBDEFLATE_SUCCESS)
 	{
 		Assert(outBytes < std::numeric_limits<uint32_t>::max());
 
+		ProfileCounterAdd("Inflate Bytes In", Stream->avail_in);
+		ProfileCounterAdd("Inflate Bytes Out", outBytes);
+
 		Stream->total_in = Stream->avail_in;
 		Stream->total_out = (uint32_t)outBytes;
 
 		return 1;
 	}
 
+	// A non-finishing call means the caller is streaming: the output may be too small or the input only part of the
+	// stream. Nothing has been consumed yet, so zlib can start from the same buffers.
+	if (Flush != 4 /* Z_FINISH */ && (result == LIBDEFLATE_INSUFFICIENT_SPACE || result == LIBDEFLATE_BAD_DATA))
+	{
+		ProfileCounterInc("Records Inflated (Streamed)");
+
+		if (int status = g_EngineInflateInit(Stream, g_InflateVersion, g_InflateMode); status != 0)
+			return status;
+
+		return g_EngineInflate(Stream, Flush);
+	}
+
 	if (result == LIBDEFLATE_INSUFFICIENT_SPACE)
 		return -5;
 
@@ -177,50 +243,64 @@ uint32_t sub_1405B31C0(BSTArray<void *>& Array, const void *&Target)
 	return 0xFFFFFFFF;
 }
 
-uint32_t sub_1405B31C0_SSE41(BSTArray<void *>& Array, const void *&Target)
+uint32_t sub_1405B31C0_Vectorized(BSTArray<void *>& Array, const void *&Target)
 {
-	uint32_t index = 0;
-	__int64 *data = (__int64 *)Array.QBuffer();
+	// Utilize the widest instruction set available, see BSTArrayKernels
+	return Array.find((void *)Target);
+}
 
-	const uint32_t comparesPerIter = 4;
-	const uint32_t vectorizedIterations = (Array.QSize() - index) / comparesPerIter;
+//
+// Plugin loading calls sub_1405B31C0 in loops over the same large arrays, which makes a plain scan quadratic. Arrays past
+// a threshold get a PointerSearchIndex that follows appends and erases and answers hits and misses without scanning.
+//
+constexpr uint32_t PointerSearchIndexThreshold = 1024;
+constexpr size_t MaxPointerSearchIndexes = 256;
 
-	//
-	// Compare 4 pointers per iteration - use SIMD instructions to generate a bit mask. Set
-	// bit 0 if 'array[i + 0]'=='target', set bit 1 if 'array[i + 1]'=='target', set bit X...
-	//
-	// AVX: mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(targets, _mm256_loadu_si256((__m256i *)&data[i]))));
-	//
-	const __m128i targets = _mm_set1_epi64x((__int64)Target);
+decltype(&sub_1405B31C0) g_PointerSearchScan = &sub_1405B31C0;
+std::mutex g_PointerSearchIndexMutex;
+std::unordered_map<const void *, std::unique_ptr<PointerSearchIndex>> g_PointerSearchIndexes;
 
-	for (uint32_t iter = 0; iter < vectorizedIterations; iter++)
-	{
-		__m128i test1 = _mm_cmpeq_epi64(targets, _mm_loadu_si128((__m128i *)&data[index + 0]));
-		__m128i test2 = _mm_cmpeq_epi64(targets, _mm_loadu_si128((__m128i *)&data[index + 2]));
+uint32_t sub_1405B31C0_Indexed(BSTArray<void *>& Array, const void *&Target)
+{
+	if (Array.QSize() < PointerSearchIndexThreshold)
+		return g_PointerSearchScan(Array, Target);
 
-		int mask = _mm_movemask_pd(_mm_castsi128_pd(_mm_or_si128(test1, test2)));
+	std::lock_guard<std::mutex> lock(g_PointerSearchIndexMutex);
 
-		// if (target pointer found) { break into the remainder loop to get the index }
-		if (mask != 0)
-			break;
+	// Arrays aren't tracked past their lifetime, so start over once too many addresses have been seen
+	if (g_PointerSearchIndexes.size() >= MaxPointerSearchIndexes && !g_PointerSearchIndexes.count(&Array))
+		g_PointerSearchIndexes.clear();
 
-		index += comparesPerIter;
-	}
+	auto& index = g_PointerSearchIndexes[&Array];
 
-	// Scan the rest 1-by-1
-	for (; index < Array.QSize(); index++)
-	{
-		if (data[index] == (__int64)Target)
-			return index;
-	}
+	if (!index)
+		index = std::make_unique<PointerSearchIndex>();
 
-	return 0xFFFFFFFF;
+	const uint32_t resyncs = index->Resyncs();
+
+	index->Update((const void *const *)Array.QBuffer(), Array.QSize());
+	const uint32_t result = index->Find(Target);
+
+	if (index->Resyncs() != resyncs)
+		ProfileCounterInc("Pointer Search Index Rebuilds");
+
+	return result;
 }
 
+const RadixSortKey<TESForm_CK *> g_FormRadixSortKeys[2] =
+{
+	{ [](TESForm_CK *const& Form) -> uint64_t { return Form->GetFormID(); }, sizeof(uint32_t) },
+	{ [](TESForm_CK *const& Form) -> uint64_t { return (uintptr_t)Form; }, sizeof(uintptr_t) },
+};
+
+RadixSortVerdicts g_FormRadixSortVerdicts;
+
 void UpdateObjectWindowTreeView(void *Thisptr, HWND ControlHandle, __int64 Unknown)
 {
 	SendMessage(ControlHandle, WM_SETREDRAW, FALSE, 0);
+	LazyTreeView::BeginBuild(ControlHandle);
 	((void(__fastcall *)(void *, HWND, __int64))OFFSET(0x0413EB0, 0))(Thisptr, ControlHandle, Unknown);
+	LazyTreeView::EndBuild(ControlHandle);
 	SendMessage(ControlHandle, WM_SETREDRAW, TRUE, 0);
 	RedrawWindow(ControlHandle, nullptr, nullptr, RDW_ERASE | RDW_INVALIDATE | RDW_NOCHILDREN);
 }
@@ -246,7 +326,23 @@ HWND g_DeferredListView;
 HWND g_DeferredComboBox;
 uintptr_t g_DeferredStringLength;
 bool g_AllowResize;
-std::vector<std::pair<const char *, void *>> g_DeferredMenuItems;
+
+struct DeferredMenuItem
+{
+	const char *Display;	// Owned by g_DeferredMenuStrings
+	uint32_t Length;
+	void *Value;
+};
+
+struct GlyphWidths
+{
+	LOGFONTA Font;			// Handles get recycled once a font is deleted, so hits are checked against this
+	int Widths[UCHAR_MAX + 1];
+};
+
+std::vector<DeferredMenuItem> g_DeferredMenuItems;
+FrameArena g_DeferredMenuStrings;
+std::unordered_map<HFONT, GlyphWidths> g_GlyphWidthCache;
 
 void ResetUIDefer()
 {
@@ -256,6 +352,7 @@ void ResetUIDefer()
 	g_DeferredStringLength = 0;
 	g_AllowResize = false;
 	g_DeferredMenuItems.clear();
+	g_DeferredMenuStrings.Reset();
 }
 
 void BeginUIDefer()
@@ -286,6 +383,49 @@ void SuspendComboBoxUpdates(HWND ComboHandle, bool Suspend)
 	}
 }
 
+const int *GetGlyphWidths(HWND Control)
+{
+	HFONT font = (HFONT)SendMessageA(Control, WM_GETFONT, 0, 0);
+
+	if (!font)
+		font = (HFONT)GetStockObject(SYSTEM_FONT);
+
+	LOGFONTA fontInfo = {};
+	GetObjectA(font, sizeof(fontInfo), &fontInfo);
+
+	if (auto itr = g_GlyphWidthCache.find(font); itr != g_GlyphWidthCache.end() && !memcmp(&itr->second.Font, &fontInfo, sizeof(fontInfo)))
+		return itr->second.Widths;
+
+	HDC hdc = GetDC(Control);
+
+	if (!hdc)
+		return nullptr;
+
+	auto& entry = g_GlyphWidthCache[font];
+	entry.Font = fontInfo;
+
+	HGDIOBJ oldFont = SelectObject(hdc, font);
+
+	// Pre-calculate font widths for resizing, starting with TrueType
+	ABC trueTypeFontWidths[UCHAR_MAX + 1];
+
+	if (!GetCharABCWidthsA(hdc, 0, ARRAYSIZE(trueTypeFontWidths) - 1, trueTypeFontWidths))
+	{
+		BOOL result = GetCharWidthA(hdc, 0, ARRAYSIZE(entry.Widths) - 1, entry.Widths);
+		AssertMsg(result, "Failed to determine any font widths");
+	}
+	else
+	{
+		for (int i = 0; i < ARRAYSIZE(entry.Widths); i++)
+			entry.Widths[i] = trueTypeFontWidths[i].abcB;
+	}
+
+	SelectObject(hdc, oldFont);
+	ReleaseDC(Control, hdc);
+
+	return entry.Widths;
+}
+
 void EndUIDefer()
 {
 	if (!g_UseDeferredDialogInsert)
@@ -308,52 +448,34 @@ void EndUIDefer()
 		if ((style & CBS_SORT) == CBS_SORT)
 		{
 			std::sort(g_DeferredMenuItems.begin(), g_DeferredMenuItems.end(),
-				[](const std::pair<const char *, void *>& a, const std::pair<const char *, void *>& b) -> bool
+				[](const DeferredMenuItem& a, const DeferredMenuItem& b) -> bool
 			{
-				return _stricmp(a.first, b.first) > 0;
+				return _stricmp(a.Display, b.Display) > 0;
 			});
 		}
 
 		SendMessage(control, CB_INITSTORAGE, g_DeferredMenuItems.size(), g_DeferredStringLength * sizeof(char));
 
-		if (HDC hdc = GetDC(control); hdc)
+		if (const int *fontWidths = GetGlyphWidths(control); fontWidths)
 		{
 			SuspendComboBoxUpdates(control, true);
 
-			// Pre-calculate font widths for resizing, starting with TrueType
-			int fontWidths[UCHAR_MAX + 1];
-			ABC trueTypeFontWidths[UCHAR_MAX + 1];
-
-			if (!GetCharABCWidthsA(hdc, 0, ARRAYSIZE(trueTypeFontWidths) - 1, trueTypeFontWidths))
-			{
-				BOOL result = GetCharWidthA(hdc, 0, ARRAYSIZE(fontWidths) - 1, fontWidths);
-				AssertMsg(result, "Failed to determine any font widths");
-			}
-			else
-			{
-				for (int i = 0; i < ARRAYSIZE(fontWidths); i++)
-					fontWidths[i] = trueTypeFontWidths[i].abcB;
-			}
-
 			// Insert everything all at once
-			for (auto [display, value] : g_DeferredMenuItems)
+			for (const auto& item : g_DeferredMenuItems)
 			{
-				LRESULT index = SendMessageA(control, CB_ADDSTRING, 0, (LPARAM)display);
+				LRESULT index = SendMessageA(control, CB_ADDSTRING, 0, (LPARAM)item.Display);
 				int lineSize = 0;
 
 				if (index != CB_ERR && index != CB_ERRSPACE)
-					SendMessageA(control, CB_SETITEMDATA, index, (LPARAM)value);
+					SendMessageA(control, CB_SETITEMDATA, index, (LPARAM)item.Value);
 
-				for (const char *c = display; *c != '\0'; c++)
-					lineSize += fontWidths[*c];
+				for (uint32_t i = 0; i < item.Length; i++)
+					lineSize += fontWidths[(uint8_t)item.Display[i]];
 
 				finalWidth = std::max<int>(finalWidth, lineSize);
-
-				free((void *)display);
 			}
 
 			SuspendComboBoxUpdates(control, false);
-			ReleaseDC(control, hdc);
 		}
 
 		// Resize to fit
@@ -364,6 +486,8 @@ void EndUIDefer()
 			if (finalWidth > currentWidth)
 				SendMessage(control, CB_SETDROPPEDWIDTH, finalWidth, 0);
 		}
+
+		ComboBoxSearch::Attach(control);
 	}
 
 	ResetUIDefer();
@@ -381,12 +505,17 @@ void InsertComboBoxItem(HWND ComboBoxHandle, const char *DisplayText, void *Valu
 	{
 		AssertMsg(!g_DeferredComboBox || (g_DeferredComboBox == ComboBoxHandle), "Got handles to different combo boxes? Reset probably wasn't called.");
 
+		const size_t length = strlen(DisplayText);
+
 		g_DeferredComboBox = ComboBoxHandle;
-		g_DeferredStringLength += strlen(DisplayText) + 1;
+		g_DeferredStringLength += length + 1;
 		g_AllowResize |= AllowResize;
 
-		// A copy must be created since lifetime isn't guaranteed after this function returns
-		g_DeferredMenuItems.emplace_back(_strdup(DisplayText), Value);
+		// A copy must be created since lifetime isn't guaranteed after this function returns. It lives until ResetUIDefer.
+		auto display = (char *)g_DeferredMenuStrings.Allocate(length + 1, 1);
+		memcpy(display, DisplayText, length + 1);
+
+		g_DeferredMenuItems.push_back({ display, (uint32_t)length, Value });
 	}
 	else
 	{
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <tbb/parallel_invoke.h>
+#include <tbb/parallel_sort.h>
 #include "../TES/BSTArray.h"
+#include "RadixSort.h"
+#include "TESForm_CK.h"
 
 struct z_stream_s
 {
@@ -21,11 +25,15 @@ INT_PTR WINAPI hk_DialogBoxParamA(HINSTANCE hInstance, LPCSTR lpTemplateName, HW
 BOOL WINAPI hk_EndDialog(HWND hDlg, INT_PTR nResult);
 LRESULT WINAPI hk_SendMessageA(HWND hWnd, UINT Msg, WPARAM wParam, LPARAM lParam);
 
+void PatchInflate(uintptr_t InitCall, uintptr_t InflateCall);
 int hk_inflateInit(z_stream_s *Stream, const char *Version, int Mode);
 int hk_inflate(z_stream_s *Stream, int Flush);
 
 uint32_t sub_1405B31C0(BSTArray<void *>& Array, const void *&Target);
-uint32_t sub_1405B31C0_SSE41(BSTArray<void *>& Array, const void *&Target);
+uint32_t sub_1405B31C0_Vectorized(BSTArray<void *>& Array, const void *&Target);
+uint32_t sub_1405B31C0_Indexed(BSTArray<void *>& Array, const void *&Target);
+
+extern decltype(&sub_1405B31C0) g_PointerSearchScan;
 
 void UpdateObjectWindowTreeView(void *Thisptr, HWND ControlHandle, __int64 Unknown);
 void UpdateCellViewCellList(void *Thisptr, HWND ControlHandle, __int64 Unknown);
@@ -40,6 +48,32 @@ void QuitHandler();
 void hk_call_140906407(__int64 a1, __int64 a2, __int64 a3);
 void PatchTemplatedFormIterator();
 
+extern const RadixSortKey<TESForm_CK *> g_FormRadixSortKeys[2];
+extern RadixSortVerdicts g_FormRadixSortVerdicts;
+
+constexpr uint32_t ParallelSortThreshold = 16384;
+
+template<typename T, typename Compare>
+void ParallelStableSort(T *First, T *Last, Compare Comp)
+{
+	const size_t count = Last - First;
+
+	if (count < ParallelSortThreshold)
+	{
+		std::stable_sort(First, Last, Comp);
+		return;
+	}
+
+	// Sort both halves concurrently, then merge. Merging keeps equal elements from the left half first.
+	T *middle = First + (count / 2);
+
+	tbb::parallel_invoke(
+		[&] { ParallelStableSort(First, middle, Comp); },
+		[&] { ParallelStableSort(middle, Last, Comp); });
+
+	std::inplace_merge(First, middle, Last, Comp);
+}
+
 template<typename T, bool Stable = false>
 void ArrayQuickSortRecursive(BSTArray<T>& Array, int(*SortFunction)(const void *, const void *))
 {
@@ -48,6 +82,31 @@ void ArrayQuickSortRecursive(BSTArray<T>& Array, int(*SortFunction)(const void *
 		return SortFunction(A, B) == -1;
 	};
 
+	// Form arrays ordered by form ID or address skip comparisons entirely, see RadixSort.h
+	if constexpr (!Stable && std::is_same_v<T, TESForm_CK *>)
+	{
+		T *first = &Array[0];
+		T *last = &Array[Array.QSize()];
+
+		if (Array.QSize() >= RadixSortThreshold && std::find(first, last, nullptr) == last)
+		{
+			if (TryRadixSort(first, last, compare, (uintptr_t)SortFunction, g_FormRadixSortKeys,
+				(uint32_t)std::size(g_FormRadixSortKeys), g_FormRadixSortVerdicts))
+				return;
+		}
+	}
+
+	// Large arrays (i.e. forms in big plugins during save) are split across worker threads
+	if (Array.QSize() >= ParallelSortThreshold)
+	{
+		if constexpr (Stable)
+			ParallelStableSort(&Array[0], &Array[Array.QSize()], compare);
+		else
+			tbb::parallel_sort(&Array[0], &Array[Array.QSize()], compare);
+
+		return;
+	}
+
 	if constexpr (Stable)
 		std::stable_sort(&Array[0], &Array[Array.QSize()], compare);
 	else
@@ -2,10 +2,15 @@
 #include <CommCtrl.h>
 #include <commdlg.h>
 #include <shellapi.h>
+#include "../../ScratchMemory.h"
+#include "../fileio.h"
 #include "EditorUI.h"
 #include "EditorUIDarkMode.h"
+#include "LazyTreeView.h"
 #include "LogWindow.h"
+#include "ObjectWindowFilter.h"
 #include "TESForm_CK.h"
+#include "VirtualListView.h"
 
 #pragma comment(lib, "comctl32.lib")
 
@@ -178,6 +183,7 @@ namespace EditorUI
 					static_assert(sizeof(VersionControlListItem) == 0x28);
 
 					static std::vector<VersionControlListItem> formList;
+					static FrameArena formStrings;
 
 					// Invoke the dialog, building form list
 					void(*callback)(void *, void *, void *, __int64) = [](void *, void *, void *, __int64 Item)
@@ -185,7 +191,7 @@ namespace EditorUI
 						auto data = *(VersionControlListItem **)(Item + 0x28);
 
 						formList.push_back(*data);
-						formList.back().EditorId = _strdup(data->EditorId);
+						formList.back().EditorId = formStrings.Strdup(data->EditorId);
 					};
 
 					XUtil::PatchMemoryNop(OFFSET(0x5A5D51, 0), 6);
@@ -224,11 +230,10 @@ namespace EditorUI
 							item.FileOffset,
 							item.FileLength,
 							item.VersionControlId);
-
-						free((void *)item.EditorId);
 					}
 
 					formList.clear();
+					formStrings.Reset();
 					fclose(f);
 				}
 			}
@@ -275,9 +280,43 @@ namespace EditorUI
 	{
 		if (Message == WM_INITDIALOG)
 		{
+			// Must happen before the editor grabs the handle and adds columns
+			VirtualListView::Convert(DialogHwnd, 1041);
+			LazyTreeView::Attach(DialogHwnd, UI_OBJECT_WINDOW_TREE);
+
 			// Eliminate the flicker when changing categories
 			ListView_SetExtendedListViewStyleEx(GetDlgItem(DialogHwnd, 1041), LVS_EX_DOUBLEBUFFER, LVS_EX_DOUBLEBUFFER);
 		}
+		else if (Message == WM_NOTIFY)
+		{
+			LazyTreeView::TranslateNotification((NMHDR *)lParam);
+
+			if (LRESULT result; VirtualListView::TranslateNotification((NMHDR *)lParam, &result))
+			{
+				SetWindowLongPtrA(DialogHwnd, DWLP_MSGRESULT, result);
+				return TRUE;
+			}
+		}
+		else if (Message == WM_COMMAND && LOWORD(wParam) == UI_OBJECT_WINDOW_FILTER && HIWORD(wParam) == EN_CHANGE)
+		{
+			// Narrowing the filter is handled in the background, anything else goes to the editor as usual
+			if (ObjectWindowFilter::HandleFilterChange(DialogHwnd, (HWND)lParam))
+				return TRUE;
+		}
+		else if (Message == UI_OBJECT_WINDOW_FILTER_RESULTS)
+		{
+			ObjectWindowFilter::ApplyResults(DialogHwnd);
+			return TRUE;
+		}
+		else if (Message == UI_OBJECT_WINDOW_FILTER_SNAPSHOT)
+		{
+			ObjectWindowFilter::BuildPendingSnapshot(DialogHwnd);
+			return TRUE;
+		}
+		else if (Message == WM_DESTROY)
+		{
+			ObjectWindowFilter::Reset();
+		}
 		/*
 		else if (Message == WM_COMMAND)
 		{
@@ -310,19 +349,34 @@ namespace EditorUI
 			return 1;
 		}
 		*/
-		return OldObjectWindowProc(DialogHwnd, Message, wParam, lParam);
+		const INT_PTR result = OldObjectWindowProc(DialogHwnd, Message, wParam, lParam);
+
+		// Catches the editor refilling the list and the filter box gaining focus
+		ObjectWindowFilter::ScheduleSnapshot(DialogHwnd);
+		return result;
 	}
 	
 	INT_PTR CALLBACK CellViewProc(HWND DialogHwnd, UINT Message, WPARAM wParam, LPARAM lParam)
 	{
 		if (Message == WM_INITDIALOG)
 		{
+			VirtualListView::Convert(DialogHwnd, 1155);
+			VirtualListView::Convert(DialogHwnd, 1156);
+
 			// Eliminate the flicker when changing cells
 			ListView_SetExtendedListViewStyleEx(GetDlgItem(DialogHwnd, 1155), LVS_EX_DOUBLEBUFFER, LVS_EX_DOUBLEBUFFER);
 			ListView_SetExtendedListViewStyleEx(GetDlgItem(DialogHwnd, 1156), LVS_EX_DOUBLEBUFFER, LVS_EX_DOUBLEBUFFER);
 
 			ShowWindow(GetDlgItem(DialogHwnd, 1007), SW_HIDE);
 		}
+		else if (Message == WM_NOTIFY)
+		{
+			if (LRESULT result; VirtualListView::TranslateNotification((NMHDR *)lParam, &result))
+			{
+				SetWindowLongPtrA(DialogHwnd, DWLP_MSGRESULT, result);
+				return TRUE;
+			}
+		}
 		/*
 		else if (Message == WM_SIZE)
 		{
@@ -385,9 +439,9 @@ namespace EditorUI
 		{
 			if (enableLipGeneration)
 			{
-				if (GetFileAttributes("CreationKit32.exe") == INVALID_FILE_ATTRIBUTES ||
-					GetFileAttributes("GFSDK_GodraysLib.Win32.dll") == INVALID_FILE_ATTRIBUTES || 
-					GetFileAttributes("ssce5532.dll") == INVALID_FILE_ATTRIBUTES)
+				if (GetFileAttributesCached("CreationKit32.exe") == INVALID_FILE_ATTRIBUTES ||
+					GetFileAttributesCached("GFSDK_GodraysLib.Win32.dll") == INVALID_FILE_ATTRIBUTES || 
+					GetFileAttributesCached("ssce5532.dll") == INVALID_FILE_ATTRIBUTES)
 					enableLipGeneration = false;
 
 				if (!enableLipGeneration)
@@ -417,7 +471,7 @@ namespace EditorUI
 					auto topic = ((__int64(__fastcall *)(__int64, uint32_t))OFFSET(0x0B99420, 0))(*(__int64 *)(data + 0x28), *(uint8_t *)(*(__int64 *)(data + 0x18) + 0x1A));
 
 					// The sound file must exist on disk, not in archives
-					if (GetFileAttributes(audioFilePath) == INVALID_FILE_ATTRIBUTES)
+					if (GetFileAttributesCached(audioFilePath) == INVALID_FILE_ATTRIBUTES)
 					{
 						LogWindow::LogWarning(7, "'%s' was not found on disk. Trying WAV extension fallback.", audioFilePath);
 
@@ -425,7 +479,7 @@ namespace EditorUI
 						*strrchr(audioFilePath, '.') = '\0';
 						strcat_s(audioFilePath, ".wav");
 
-						if (GetFileAttributes(audioFilePath) == INVALID_FILE_ATTRIBUTES)
+						if (GetFileAttributesCached(audioFilePath) == INVALID_FILE_ATTRIBUTES)
 						{
 							MessageBoxA(DialogHwnd, audioFilePath, "Unable to find audio file on disk", MB_ICONERROR);
 							return 1;
@@ -441,7 +495,10 @@ namespace EditorUI
 					*strrchr(lipFileTarget, '.') = '\0';
 					strcat_s(lipFileTarget, ".lip");
 
-					if (GetFileAttributes(lipFileTarget) == INVALID_FILE_ATTRIBUTES)
+					// Written by the external process, so any cached result is stale
+					InvalidateFileAttributeCache(lipFileTarget);
+
+					if (GetFileAttributesCached(lipFileTarget) == INVALID_FILE_ATTRIBUTES)
 						LogWindow::LogWarning(7, "LIP generation failed", lipFileTarget);
 					else
 						*(uint32_t *)(item + 0x114) = 1;
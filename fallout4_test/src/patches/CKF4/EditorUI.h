@@ -7,6 +7,10 @@
 
 #define UI_OBJECT_WINDOW_ADD_ITEM		2579
 #define UI_OBJECT_WINDOW_CHECKBOX		2580	// See: resource.rc
+#define UI_OBJECT_WINDOW_FILTER			2581	// See: resource.rc
+#define UI_OBJECT_WINDOW_FILTER_RESULTS	(WM_APP + 10)
+#define UI_OBJECT_WINDOW_FILTER_SNAPSHOT	(WM_APP + 11)
+#define UI_OBJECT_WINDOW_TREE			2093	// See: resource.rc
 
 #define UI_CELL_VIEW_ADD_CELL_ITEM		2579
 #define UI_CELL_VIEW_CHECKBOX			2580	// See: resource.rc
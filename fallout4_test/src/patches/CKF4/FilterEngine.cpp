@@ -0,0 +1,145 @@
+#include "FilterEngine.h"
+
+namespace
+{
+	char Fold(char C)
+	{
+		return (C >= 'A' && C <= 'Z') ? (C - 'A' + 'a') : C;
+	}
+}
+
+void FilterSnapshot::Reserve(size_t Rows, size_t TextBytes)
+{
+	m_Rows.reserve(Rows);
+	m_Text.reserve(TextBytes);
+}
+
+void FilterSnapshot::Add(uint32_t FormID, const char *EditorID, size_t Length, uint32_t Type, uint32_t Flags)
+{
+	m_Rows.push_back({ FormID, Type, Flags, (uint32_t)m_Text.size(), (uint32_t)Length });
+
+	for (size_t i = 0; i < Length; i++)
+		m_Text.push_back(Fold(EditorID[i]));
+}
+
+uint32_t FilterSnapshot::Count() const
+{
+	return (uint32_t)m_Rows.size();
+}
+
+const FilterSnapshot::Row& FilterSnapshot::GetRow(uint32_t Index) const
+{
+	return m_Rows[Index];
+}
+
+std::string_view FilterSnapshot::GetEditorID(uint32_t Index) const
+{
+	return std::string_view(m_Text.data() + m_Rows[Index].TextOffset, m_Rows[Index].TextLength);
+}
+
+FilterEngine::FilterEngine() : m_Generation(0), m_Exit(false)
+{
+	m_Worker = std::thread(&FilterEngine::WorkerThread, this);
+}
+
+FilterEngine::~FilterEngine()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Exit = true;
+		m_Generation++;
+	}
+
+	m_Wake.notify_all();
+	m_Worker.join();
+}
+
+uint64_t FilterEngine::Submit(std::shared_ptr<const FilterSnapshot> Snapshot, FilterQuery Query, Callback OnComplete)
+{
+	uint64_t generation;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		// Bumping the generation is what tells a running evaluation to stop
+		generation = ++m_Generation;
+		m_Pending = std::make_unique<Request>(Request { generation, std::move(Snapshot), std::move(Query), std::move(OnComplete) });
+	}
+
+	m_Wake.notify_one();
+	return generation;
+}
+
+void FilterEngine::Cancel()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	m_Generation++;
+	m_Pending.reset();
+}
+
+uint64_t FilterEngine::CurrentGeneration() const
+{
+	return m_Generation.load();
+}
+
+bool FilterEngine::Evaluate(const FilterSnapshot& Snapshot, const FilterQuery& Query, std::vector<uint32_t>& Rows,
+	const std::atomic<uint64_t> *Generation, uint64_t Expected)
+{
+	// Same as the editor's own filter: the whole text, spaces included, is a case-insensitive part of the editor ID
+	std::string needle;
+	needle.reserve(Query.Text.size());
+
+	for (char c : Query.Text)
+		needle.push_back(Fold(c));
+
+	Rows.clear();
+
+	for (uint32_t i = 0; i < Snapshot.Count(); i++)
+	{
+		if (Generation && (i % CheckInterval) == 0 && Generation->load(std::memory_order_relaxed) != Expected)
+			return false;
+
+		const auto& row = Snapshot.GetRow(i);
+
+		if (Query.Type != 0 && row.Type != Query.Type)
+			continue;
+
+		if ((row.Flags & Query.FlagsSet) != Query.FlagsSet || (row.Flags & Query.FlagsClear) != 0)
+			continue;
+
+		if (Snapshot.GetEditorID(i).find(needle) != std::string_view::npos)
+			Rows.push_back(i);
+	}
+
+	return true;
+}
+
+void FilterEngine::WorkerThread()
+{
+	std::vector<uint32_t> rows;
+
+	while (true)
+	{
+		std::unique_ptr<Request> request;
+
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Wake.wait(lock, [this]() { return m_Exit || m_Pending; });
+
+			if (m_Exit)
+				return;
+
+			request = std::move(m_Pending);
+		}
+
+		if (!Evaluate(*request->Snapshot, request->Query, rows, &m_Generation, request->Generation))
+			continue;
+
+		// One last check so a query superseded during the final stretch doesn't report
+		if (m_Generation.load() == request->Generation && request->OnComplete)
+			request->OnComplete(request->Generation, std::move(rows));
+
+		rows.clear();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+//
+// Immutable table of (form ID, editor ID, type, flags) rows that filter queries run against. Editor IDs are stored
+// lowercased and packed into one buffer so a full scan stays cache friendly.
+//
+class FilterSnapshot
+{
+public:
+	struct Row
+	{
+		uint32_t FormID;
+		uint32_t Type;
+		uint32_t Flags;
+		uint32_t TextOffset;
+		uint32_t TextLength;
+	};
+
+private:
+	std::vector<Row> m_Rows;
+	std::string m_Text;
+
+public:
+	void Reserve(size_t Rows, size_t TextBytes);
+	void Add(uint32_t FormID, const char *EditorID, size_t Length, uint32_t Type, uint32_t Flags);
+
+	uint32_t Count() const;
+	const Row& GetRow(uint32_t Index) const;
+	std::string_view GetEditorID(uint32_t Index) const;
+};
+
+struct FilterQuery
+{
+	std::string Text;				// Literal editor ID substring
+	uint32_t Type = 0;				// 0 for any
+	uint32_t FlagsSet = 0;			// Flags that must be present
+	uint32_t FlagsClear = 0;		// Flags that must be absent
+};
+
+//
+// Runs filter queries on a worker thread. Submitting a query supersedes any query still queued or running, and the
+// superseded one is abandoned without calling back. Results are row indices into the snapshot, in ascending order.
+// The callback runs on the worker thread.
+//
+class FilterEngine
+{
+public:
+	using Callback = std::function<void(uint64_t Generation, std::vector<uint32_t>&& Rows)>;
+
+private:
+	struct Request
+	{
+		uint64_t Generation;
+		std::shared_ptr<const FilterSnapshot> Snapshot;
+		FilterQuery Query;
+		Callback OnComplete;
+	};
+
+	std::mutex m_Mutex;
+	std::condition_variable m_Wake;
+	std::unique_ptr<Request> m_Pending;
+	std::atomic<uint64_t> m_Generation;
+	bool m_Exit;
+	std::thread m_Worker;
+
+	// Rows between cancellation checks
+	static constexpr uint32_t CheckInterval = 4096;
+
+public:
+	FilterEngine();
+	~FilterEngine();
+
+	FilterEngine(const FilterEngine&) = delete;
+	FilterEngine& operator=(const FilterEngine&) = delete;
+
+	uint64_t Submit(std::shared_ptr<const FilterSnapshot> Snapshot, FilterQuery Query, Callback OnComplete);
+	void Cancel();
+	uint64_t CurrentGeneration() const;
+
+	// Synchronous evaluation. Returns false if Generation stopped matching Expected partway through.
+	static bool Evaluate(const FilterSnapshot& Snapshot, const FilterQuery& Query, std::vector<uint32_t>& Rows,
+		const std::atomic<uint64_t> *Generation = nullptr, uint64_t Expected = 0);
+
+private:
+	void WorkerThread();
+};
\ No newline at end of file
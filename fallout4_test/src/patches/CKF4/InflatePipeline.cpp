@@ -0,0 +1,322 @@
+#include "../../common.h"
+#include <libdeflate/libdeflate.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include "InflatePipeline.h"
+#include "ReadyRecordQueue.h"
+
+namespace InflatePipeline
+{
+	constexpr uint32_t RecordHeaderSize = 24;
+	constexpr uint32_t RecordFlagCompressed = 0x00040000;
+
+	struct ThreadDecompressor
+	{
+		libdeflate_decompressor *Decompressor = nullptr;
+
+		~ThreadDecompressor()
+		{
+			// Runs on thread exit
+			if (Decompressor)
+				libdeflate_free_decompressor(Decompressor);
+		}
+
+		libdeflate_decompressor *Get()
+		{
+			// Allocating one initializes tens of KB of tables, so it's kept for the lifetime of the thread
+			if (!Decompressor)
+				Decompressor = libdeflate_alloc_decompressor();
+
+			AssertMsg(Decompressor, "Failed to allocate a libdeflate decompressor");
+			return Decompressor;
+		}
+	};
+
+	//
+	// Cached buffers use the same layout as ready records: decompressed bytes followed by a copy of the compressed input.
+	// Keys are only a hash, so a hit is confirmed against the input before anything is handed out.
+	//
+	struct CachedRecord
+	{
+		uint64_t Key;
+		uint32_t Length;
+		uint32_t InputLength;
+		std::unique_ptr<uint8_t[]> Data;
+	};
+
+	struct FileJob
+	{
+		const uint8_t *Data;
+		uint64_t Length;
+		std::atomic_bool Cancel;
+		std::thread Scanner;
+		tbb::task_group Tasks;
+	};
+
+	bool Enabled;
+	ReadyRecordQueue ReadyRecords;
+
+	size_t CacheBudget;
+	size_t CacheBytes;
+	std::mutex CacheMutex;
+	std::list<CachedRecord> CacheOrder;			// Most recently used first
+	std::unordered_map<uint64_t, std::list<CachedRecord>::iterator> CacheIndex;
+
+	libdeflate_decompressor *GetThreadDecompressor()
+	{
+		thread_local ThreadDecompressor decompressor;
+
+		return decompressor.Get();
+	}
+
+	bool IsEnabled()
+	{
+		return Enabled;
+	}
+
+	void Initialize(size_t PipelineBudget, size_t CacheBudgetBytes)
+	{
+		ReadyRecords.SetBudget(PipelineBudget);
+		Enabled = PipelineBudget > 0;
+		CacheBudget = CacheBudgetBytes;
+	}
+
+	uint64_t GetRecordKey(const void *Input, uint32_t InputLength)
+	{
+		// The loader hands over the same compressed bytes the scanner saw
+		return XUtil::MurmurHash64A(Input, InputLength, InputLength);
+	}
+
+	std::unique_ptr<uint8_t[]> AllocateRecord(size_t Length, const void *Input, uint32_t InputLength)
+	{
+		// Nothing needs zeroing, the output half is decompressed or copied over right away
+		auto buffer = std::make_unique_for_overwrite<uint8_t[]>(Length + InputLength);
+		memcpy(buffer.get() + Length, Input, InputLength);
+
+		return buffer;
+	}
+
+	//
+	// Decompressed records are kept around after use. Reopening a plugin, saving, or reloading the data dialog reads
+	// the exact same compressed bytes again.
+	//
+	void CacheRecord(uint64_t Key, uint32_t Length, uint32_t InputLength, std::unique_ptr<uint8_t[]> Data)
+	{
+		const size_t size = (size_t)Length + InputLength;
+
+		if (CacheBudget == 0 || size > CacheBudget)
+			return;
+
+		std::lock_guard<std::mutex> lock(CacheMutex);
+
+		if (CacheIndex.count(Key))
+			return;
+
+		CacheOrder.push_front({ Key, Length, InputLength, std::move(Data) });
+		CacheIndex.emplace(Key, CacheOrder.begin());
+		CacheBytes += size;
+
+		while (CacheBytes > CacheBudget)
+		{
+			auto& oldest = CacheOrder.back();
+
+			CacheBytes -= (size_t)oldest.Length + oldest.InputLength;
+			CacheIndex.erase(oldest.Key);
+			CacheOrder.pop_back();
+		}
+	}
+
+	bool CopyCachedRecord(uint64_t Key, const void *Input, uint32_t InputLength, void *Output, uint32_t OutputLength, size_t *OutputBytes)
+	{
+		if (CacheBudget == 0)
+			return false;
+
+		std::lock_guard<std::mutex> lock(CacheMutex);
+		auto itr = CacheIndex.find(Key);
+
+		if (itr == CacheIndex.end() || itr->second->Length > OutputLength)
+			return false;
+
+		if (auto& record = *itr->second; !ReadyRecordQueue::MatchesInput(record.Data.get(), record.Length, record.InputLength, Input, InputLength))
+		{
+			ProfileCounterInc("Inflate Key Collisions");
+			return false;
+		}
+
+		// Move to the front of the eviction order
+		CacheOrder.splice(CacheOrder.begin(), CacheOrder, itr->second);
+
+		memcpy(Output, itr->second->Data.get(), itr->second->Length);
+		*OutputBytes = itr->second->Length;
+
+		ProfileCounterInc("Inflate Cache Hits");
+		return true;
+	}
+
+	void InflateRecord(FileJob *Job, uint64_t Sequence, const uint8_t *Input, uint32_t InputLength, uint32_t OutputLength)
+	{
+		const uint32_t reserved = OutputLength + InputLength;
+
+		if (Job->Cancel)
+		{
+			ReadyRecords.Release(reserved);
+			return;
+		}
+
+		// The input copy sits right after the declared size, so a record that inflates to anything else isn't kept
+		auto buffer = AllocateRecord(OutputLength, Input, InputLength);
+		size_t outBytes = 0;
+
+		if (libdeflate_zlib_decompress(GetThreadDecompressor(), Input, InputLength, buffer.get(), OutputLength, &outBytes) != LIBDEFLATE_SUCCESS ||
+			outBytes != OutputLength)
+		{
+			// Left for the loader to report
+			ReadyRecords.Release(reserved);
+			return;
+		}
+
+		if (ReadyRecords.Publish(GetRecordKey(Input, InputLength), { Job, Sequence, (uint32_t)outBytes, InputLength, reserved, std::move(buffer) }))
+			ProfileCounterInc("Records Inflated Ahead");
+	}
+
+	void ScanFile(FileJob *Job)
+	{
+		const uint8_t *data = Job->Data;
+		const bool inlineInflate = tbb::this_task_arena::max_concurrency() <= 1;
+		uint64_t offset = 0;
+
+		while (offset + RecordHeaderSize <= Job->Length && !Job->Cancel)
+		{
+			const uint8_t *header = &data[offset];
+			const uint32_t dataSize = *(const uint32_t *)&header[4];
+
+			// Groups only wrap other records, so step inside instead of over them
+			if (!memcmp(header, "GRUP", 4))
+			{
+				offset += RecordHeaderSize;
+				continue;
+			}
+
+			const uint32_t flags = *(const uint32_t *)&header[8];
+			offset += RecordHeaderSize + (uint64_t)dataSize;
+
+			if (!(flags & RecordFlagCompressed) || dataSize <= sizeof(uint32_t) || offset > Job->Length)
+				continue;
+
+			// Payload is the decompressed size followed by a zlib stream. Records that can't fit are left to the loader.
+			const uint8_t *payload = header + RecordHeaderSize;
+			const uint32_t decompressedSize = *(const uint32_t *)payload;
+			const uint64_t reserved = (uint64_t)decompressedSize + (dataSize - sizeof(uint32_t));
+
+			if (decompressedSize == 0 || reserved > ReadyRecords.GetBudget() || reserved > UINT32_MAX)
+				continue;
+
+			uint64_t sequence;
+
+			if (!ReadyRecords.Reserve((uint32_t)reserved, Job->Cancel, &sequence))
+				break;
+
+			// Without worker threads nothing would pick the task up while this thread waits for space
+			if (inlineInflate)
+			{
+				InflateRecord(Job, sequence, payload + sizeof(uint32_t), dataSize - sizeof(uint32_t), decompressedSize);
+				continue;
+			}
+
+			Job->Tasks.run([Job, sequence, payload, dataSize, decompressedSize]()
+			{
+				InflateRecord(Job, sequence, payload + sizeof(uint32_t), dataSize - sizeof(uint32_t), decompressedSize);
+			});
+		}
+
+		// Tasks spawned here live in this thread's arena, so help finish them before leaving it
+		Job->Tasks.wait();
+	}
+
+	FileJob *QueueFile(const void *Data, uint64_t Length)
+	{
+		if (!Enabled)
+			return nullptr;
+
+		auto job = new FileJob;
+		job->Data = (const uint8_t *)Data;
+		job->Length = Length;
+		job->Cancel = false;
+		job->Scanner = std::thread([job]()
+		{
+			XUtil::SetThreadName(GetCurrentThreadId(), "Inflate Scanner");
+			ScanFile(job);
+		});
+
+		return job;
+	}
+
+	void CancelFile(FileJob *Job)
+	{
+		if (!Job)
+			return;
+
+		Job->Cancel = true;
+		ReadyRecords.WakeAll();
+
+		// Both reference the mapped view, which is about to go away
+		Job->Scanner.join();
+		Job->Tasks.wait();
+
+		// Whatever the loader didn't take would otherwise stay charged against the budget and stall the next file
+		ReadyRecords.DropOwner(Job);
+		delete Job;
+	}
+
+	bool TakeReadyRecord(uint64_t Key, const void *Input, uint32_t InputLength, void *Output, uint32_t OutputLength, size_t *OutputBytes)
+	{
+		ReadyRecordQueue::Record record;
+		const auto result = ReadyRecords.Take(Key, Input, InputLength, OutputLength, &record);
+
+		if (result == ReadyRecordQueue::TakeResult::Collision)
+			ProfileCounterInc("Inflate Key Collisions");
+
+		if (result != ReadyRecordQueue::TakeResult::Taken)
+			return false;
+
+		memcpy(Output, record.Data.get(), record.Length);
+		*OutputBytes = record.Length;
+
+		// The buffer is already ours, hand it to the cache instead of freeing it
+		CacheRecord(Key, record.Length, record.InputLength, std::move(record.Data));
+		return true;
+	}
+
+	bool Lookup(const void *Input, uint32_t InputLength, void *Output, uint32_t OutputLength, size_t *OutputBytes)
+	{
+		const bool pipelineActive = Enabled && !ReadyRecords.Empty();
+
+		// Skip hashing when there's nowhere to look
+		if (!pipelineActive && CacheBudget == 0)
+			return false;
+
+		const uint64_t key = GetRecordKey(Input, InputLength);
+
+		if (pipelineActive && TakeReadyRecord(key, Input, InputLength, Output, OutputLength, OutputBytes))
+			return true;
+
+		return CopyCachedRecord(key, Input, InputLength, Output, OutputLength, OutputBytes);
+	}
+
+	void Store(const void *Input, uint32_t InputLength, const void *Output, size_t OutputBytes)
+	{
+		if (CacheBudget == 0 || OutputBytes + InputLength > CacheBudget)
+			return;
+
+		auto buffer = AllocateRecord(OutputBytes, Input, InputLength);
+		memcpy(buffer.get(), Output, OutputBytes);
+
+		CacheRecord(GetRecordKey(Input, InputLength), (uint32_t)OutputBytes, InputLength, std::move(buffer));
+	}
+}
\ No newline at end of file
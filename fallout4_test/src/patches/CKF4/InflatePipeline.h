@@ -0,0 +1,21 @@
+#pragma once
+
+#include "../../common.h"
+
+struct libdeflate_decompressor;
+
+namespace InflatePipeline
+{
+	struct FileJob;
+
+	libdeflate_decompressor *GetThreadDecompressor();
+
+	bool IsEnabled();
+	void Initialize(size_t PipelineBudget, size_t CacheBudgetBytes);
+
+	FileJob *QueueFile(const void *Data, uint64_t Length);
+	void CancelFile(FileJob *Job);
+
+	bool Lookup(const void *Input, uint32_t InputLength, void *Output, uint32_t OutputLength, size_t *OutputBytes);
+	void Store(const void *Input, uint32_t InputLength, const void *Output, size_t OutputBytes);
+}
\ No newline at end of file
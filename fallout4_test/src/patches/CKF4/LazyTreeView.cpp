@@ -0,0 +1,761 @@
+#include "../../common.h"
+#include <CommCtrl.h>
+#include "LazyTreeView.h"
+
+namespace LazyTreeView
+{
+	using NodeId = CategoryTreeModel::NodeId;
+
+	struct PendingItem
+	{
+		TVITEMEXA Item;				// As the editor inserted it. pszText is only kept to tell callbacks apart.
+		std::string Text;
+	};
+
+	struct TreeState
+	{
+		CategoryTreeModel Nodes;
+		std::unordered_map<NodeId, PendingItem> Pending;	// Items that aren't in the control yet
+		std::vector<NodeId> NeedButtons;					// Items that were given their first pending child mid-build
+		bool Building = false;								// Inside UpdateObjectWindowTreeView
+		bool Passthrough = false;							// Messages sent from here go straight to the control
+	};
+
+	// Given to the editor for items that don't exist in the control yet. Never a valid pointer and never one of the
+	// TVI_* constants.
+	constexpr uint64_t PendingHandleTag = 0x7FFF000000000000;
+	constexpr uint64_t PendingHandleMask = 0xFFFF000000000000;
+
+	// Fields a pending item can answer or accept without being created
+	constexpr UINT PendingItemFields = TVIF_HANDLE | TVIF_TEXT | TVIF_IMAGE | TVIF_SELECTEDIMAGE | TVIF_PARAM | TVIF_STATE | TVIF_CHILDREN;
+
+	bool Enabled;
+
+	void Initialize(bool Enable)
+	{
+		Enabled = Enable;
+	}
+
+	TreeState *GetState(HWND TreeViewHandle)
+	{
+		DWORD_PTR refData = 0;
+
+		if (!TreeViewHandle || !GetWindowSubclass(TreeViewHandle, TreeViewSubclass, 0, &refData))
+			return nullptr;
+
+		return (TreeState *)refData;
+	}
+
+	void Attach(HWND DialogHwnd, int ControlId)
+	{
+		HWND treeView = GetDlgItem(DialogHwnd, ControlId);
+
+		if (!Enabled || !treeView || GetState(treeView))
+			return;
+
+		SetWindowSubclass(treeView, TreeViewSubclass, 0, (DWORD_PTR)new TreeState());
+	}
+
+	void BeginBuild(HWND TreeViewHandle)
+	{
+		if (auto state = GetState(TreeViewHandle); state)
+			state->Building = true;
+	}
+
+	bool IsPendingHandle(HTREEITEM Item)
+	{
+		return ((uint64_t)Item & PendingHandleMask) == PendingHandleTag;
+	}
+
+	NodeId FindNode(TreeState *State, HTREEITEM Item)
+	{
+		if (!Item || Item == TVI_ROOT)
+			return CategoryTreeModel::Root;
+
+		return State->Nodes.Find((uint64_t)Item);
+	}
+
+	HTREEITEM EditorHandle(TreeState *State, NodeId Node)
+	{
+		if (Node == CategoryTreeModel::Root || Node == CategoryTreeModel::npos)
+			return nullptr;
+
+		return (HTREEITEM)State->Nodes.Handle(Node);
+	}
+
+	// Control handle -> the handle the editor was given for the same item
+	HTREEITEM ToEditor(TreeState *State, HTREEITEM Item)
+	{
+		const NodeId node = State->Nodes.Find((uint64_t)Item);
+
+		if (node == CategoryTreeModel::npos)
+			return Item;
+
+		return EditorHandle(State, node);
+	}
+
+	LRESULT Forward(HWND TreeViewHandle, TreeState *State, UINT Message, WPARAM wParam, LPARAM lParam)
+	{
+		const bool previous = State->Passthrough;
+
+		State->Passthrough = true;
+		const LRESULT result = SendMessageA(TreeViewHandle, Message, wParam, lParam);
+		State->Passthrough = previous;
+
+		return result;
+	}
+
+	void SetButton(HWND TreeViewHandle, TreeState *State, NodeId Node, bool Show)
+	{
+		TVITEMA item = {};
+		item.mask = TVIF_HANDLE | TVIF_CHILDREN;
+		item.hItem = (HTREEITEM)State->Nodes.CreatedHandle(Node);
+		item.cChildren = Show ? 1 : 0;
+
+		Forward(TreeViewHandle, State, TVM_SETITEMA, 0, (LPARAM)&item);
+	}
+
+	void CreateChildren(HWND TreeViewHandle, TreeState *State, NodeId Parent)
+	{
+		auto& nodes = State->Nodes;
+
+		if (!nodes.IsValid(Parent) || !nodes.IsCreated(Parent) || nodes.ChildrenCreated(Parent))
+			return;
+
+		nodes.SetChildrenCreated(Parent, true);
+
+		const HTREEITEM parentHandle = (HTREEITEM)nodes.CreatedHandle(Parent);
+		std::vector<NodeId> expanded;
+
+		for (NodeId child = nodes.FirstChild(Parent); child != CategoryTreeModel::npos; child = nodes.NextSibling(child))
+		{
+			auto itr = State->Pending.find(child);
+
+			if (itr == State->Pending.end())
+				continue;
+
+			const auto& pending = itr->second;
+
+			TVINSERTSTRUCTA insert = {};
+			insert.hParent = parentHandle;
+			insert.hInsertAfter = TVI_LAST;
+			insert.itemex = pending.Item;
+
+			if ((insert.itemex.mask & TVIF_TEXT) && insert.itemex.pszText != LPSTR_TEXTCALLBACKA)
+				insert.itemex.pszText = const_cast<char *>(pending.Text.c_str());
+
+			// Its own children come later, so the control has to be told there will be some
+			if (nodes.ChildCount(child) > 0)
+			{
+				if (!(insert.itemex.mask & TVIF_CHILDREN) || insert.itemex.cChildren != I_CHILDRENCALLBACK)
+					insert.itemex.cChildren = 1;
+
+				insert.itemex.mask |= TVIF_CHILDREN;
+			}
+
+			const auto created = (HTREEITEM)Forward(TreeViewHandle, State, TVM_INSERTITEMA, 0, (LPARAM)&insert);
+
+			if (!created)
+				continue;
+
+			nodes.SetCreated(child, (uint64_t)created);
+			nodes.SetChildrenCreated(child, nodes.ChildCount(child) == 0);
+
+			if ((pending.Item.mask & TVIF_STATE) && (pending.Item.state & pending.Item.stateMask & TVIS_EXPANDED))
+				expanded.push_back(child);
+
+			State->Pending.erase(itr);
+		}
+
+		// Items inserted already expanded need their children right away
+		for (NodeId child : expanded)
+			CreateChildren(TreeViewHandle, State, child);
+	}
+
+	void CreateSubtree(HWND TreeViewHandle, TreeState *State, NodeId Node)
+	{
+		// Pre-order, so every parent exists before its children are asked for
+		CreateChildren(TreeViewHandle, State, Node);
+
+		State->Nodes.ForEach(Node, [&](NodeId Current)
+		{
+			CreateChildren(TreeViewHandle, State, Current);
+		});
+	}
+
+	// Editor handle -> control handle, creating the item (and whatever is above it) first if needed
+	HTREEITEM ToControl(HWND TreeViewHandle, TreeState *State, HTREEITEM Item)
+	{
+		if (!IsPendingHandle(Item))
+			return Item;
+
+		const NodeId node = State->Nodes.Find((uint64_t)Item);
+
+		if (node == CategoryTreeModel::npos)
+			return nullptr;
+
+		for (NodeId ancestor : State->Nodes.PendingAncestors(node))
+			CreateChildren(TreeViewHandle, State, ancestor);
+
+		return (HTREEITEM)State->Nodes.CreatedHandle(node);
+	}
+
+	void EndBuild(HWND TreeViewHandle)
+	{
+		auto state = GetState(TreeViewHandle);
+
+		if (!state)
+			return;
+
+		for (NodeId node : state->NeedButtons)
+		{
+			if (state->Nodes.IsCreated(node) && state->Nodes.HasPendingChildren(node))
+				SetButton(TreeViewHandle, state, node, true);
+		}
+
+		state->NeedButtons.clear();
+		state->Building = false;
+	}
+
+	bool HasPendingText(const PendingItem& Pending)
+	{
+		return (Pending.Item.mask & TVIF_TEXT) && Pending.Item.pszText != LPSTR_TEXTCALLBACKA;
+	}
+
+	NodeId SortedPosition(TreeState *State, NodeId Parent, const char *Text)
+	{
+		// Same order TVI_SORT gives, only looked at for pending siblings since created ones are the control's business
+		NodeId after = CategoryTreeModel::npos;
+
+		for (NodeId child = State->Nodes.FirstChild(Parent); child != CategoryTreeModel::npos; child = State->Nodes.NextSibling(child))
+		{
+			auto itr = State->Pending.find(child);
+			const char *childText = (itr != State->Pending.end() && HasPendingText(itr->second)) ? itr->second.Text.c_str() : "";
+
+			if (lstrcmpiA(Text, childText) < 0)
+				break;
+
+			after = child;
+		}
+
+		return after;
+	}
+
+	LRESULT InsertItem(HWND TreeViewHandle, TreeState *State, UINT Message, WPARAM wParam, TVINSERTSTRUCTA *Insert)
+	{
+		auto& nodes = State->Nodes;
+		const NodeId parent = Insert ? FindNode(State, Insert->hParent) : CategoryTreeModel::npos;
+
+		// Items under something inserted before the subclass was attached aren't tracked
+		if (parent == CategoryTreeModel::npos)
+			return DefSubclassProc(TreeViewHandle, Message, wParam, (LPARAM)Insert);
+
+		// Only ANSI inserts are kept around. Anything else puts the siblings it lands between into the control first.
+		const bool wide = (Message == TVM_INSERTITEMW);
+		const bool deferred = !wide && !nodes.ChildrenCreated(parent);
+
+		if (wide && !nodes.ChildrenCreated(parent))
+		{
+			ToControl(TreeViewHandle, State, Insert->hParent);
+			CreateChildren(TreeViewHandle, State, parent);
+		}
+
+		auto where = CategoryTreeModel::Placement::Last;
+		NodeId sibling = CategoryTreeModel::npos;
+
+		if (Insert->hInsertAfter == TVI_FIRST)
+		{
+			where = CategoryTreeModel::Placement::First;
+		}
+		else if (Insert->hInsertAfter == TVI_SORT)
+		{
+			const bool hasText = (Insert->itemex.mask & TVIF_TEXT) && Insert->itemex.pszText && Insert->itemex.pszText != LPSTR_TEXTCALLBACKA;
+
+			if (deferred)
+			{
+				sibling = SortedPosition(State, parent, hasText ? Insert->itemex.pszText : "");
+				where = (sibling != CategoryTreeModel::npos) ? CategoryTreeModel::Placement::After : CategoryTreeModel::Placement::First;
+			}
+		}
+		else if (Insert->hInsertAfter && Insert->hInsertAfter != TVI_LAST)
+		{
+			sibling = FindNode(State, Insert->hInsertAfter);
+			where = CategoryTreeModel::Placement::After;
+		}
+
+		const NodeId node = nodes.Insert(parent, where, sibling);
+
+		if (!deferred)
+		{
+			TVINSERTSTRUCTA insert = *Insert;
+
+			if (parent != CategoryTreeModel::Root)
+				insert.hParent = (HTREEITEM)nodes.CreatedHandle(parent);
+
+			insert.hInsertAfter = ToControl(TreeViewHandle, State, Insert->hInsertAfter);
+
+			const LRESULT result = DefSubclassProc(TreeViewHandle, Message, wParam, (LPARAM)&insert);
+
+			if (!result)
+			{
+				nodes.Remove(node);
+				return 0;
+			}
+
+			nodes.Bind(node, (uint64_t)result);
+			nodes.SetCreated(node, (uint64_t)result);
+
+			// During a build only the top level goes into the control. Everything below waits for an expansion.
+			nodes.SetChildrenCreated(node, !State->Building);
+			return result;
+		}
+
+		PendingItem pending;
+		pending.Item = Insert->itemex;
+
+		if (HasPendingText(pending))
+		{
+			pending.Text = Insert->itemex.pszText ? Insert->itemex.pszText : "";
+			pending.Item.pszText = nullptr;
+		}
+
+		const uint64_t handle = PendingHandleTag | node;
+
+		State->Pending.emplace(node, std::move(pending));
+		nodes.Bind(node, handle);
+		nodes.SetChildrenCreated(node, false);
+
+		// The parent went into the control without children, so it needs an expand button
+		if (parent != CategoryTreeModel::Root && nodes.IsCreated(parent) && nodes.ChildCount(parent) == 1)
+		{
+			if (State->Building)
+				State->NeedButtons.push_back(parent);
+			else
+				SetButton(TreeViewHandle, State, parent, true);
+		}
+
+		return (LRESULT)handle;
+	}
+
+	void NotifyPendingDeleted(HWND TreeViewHandle, TreeState *State, NodeId Node)
+	{
+		// The control only announces items it holds. The rest are announced here since the editor may free their data.
+		std::vector<std::pair<HTREEITEM, LPARAM>> deleted;
+
+		State->Nodes.ForEach(Node, [&](NodeId Current)
+		{
+			if (auto itr = State->Pending.find(Current); itr != State->Pending.end())
+			{
+				const auto& item = itr->second.Item;
+				deleted.emplace_back(EditorHandle(State, Current), (item.mask & TVIF_PARAM) ? item.lParam : 0);
+			}
+		});
+
+		const int controlId = GetDlgCtrlID(TreeViewHandle);
+
+		for (auto& [handle, param] : deleted)
+		{
+			NMTREEVIEWA info = {};
+			info.hdr.hwndFrom = TreeViewHandle;
+			info.hdr.idFrom = controlId;
+			info.hdr.code = TVN_DELETEITEMA;
+			info.itemOld.mask = TVIF_HANDLE | TVIF_PARAM;
+			info.itemOld.hItem = handle;
+			info.itemOld.lParam = param;
+
+			SendMessageA(GetParent(TreeViewHandle), WM_NOTIFY, controlId, (LPARAM)&info);
+		}
+	}
+
+	LRESULT DeleteItem(HWND TreeViewHandle, TreeState *State, HTREEITEM Item)
+	{
+		auto& nodes = State->Nodes;
+		const NodeId node = FindNode(State, Item);
+
+		if (node == CategoryTreeModel::npos)
+		{
+			// Passing a stale pending handle along would be read as "delete everything"
+			if (IsPendingHandle(Item))
+				return FALSE;
+
+			return DefSubclassProc(TreeViewHandle, TVM_DELETEITEM, 0, (LPARAM)Item);
+		}
+
+		NotifyPendingDeleted(TreeViewHandle, State, node);
+
+		// The model has to outlive this call, the control's own notifications are translated through it
+		LRESULT result = TRUE;
+
+		if (nodes.IsCreated(node))
+		{
+			const HTREEITEM created = (node == CategoryTreeModel::Root) ? Item : (HTREEITEM)nodes.CreatedHandle(node);
+			result = DefSubclassProc(TreeViewHandle, TVM_DELETEITEM, 0, (LPARAM)created);
+		}
+
+		if (node == CategoryTreeModel::Root)
+		{
+			nodes.Clear();
+			State->Pending.clear();
+			State->NeedButtons.clear();
+			return result;
+		}
+
+		const NodeId parent = nodes.Parent(node);
+
+		nodes.ForEach(node, [&](NodeId Current)
+		{
+			State->Pending.erase(Current);
+		});
+
+		nodes.Remove(node);
+
+		// A button added by hand doesn't go away with the last child
+		if (parent != CategoryTreeModel::Root && nodes.IsCreated(parent) && !nodes.ChildrenCreated(parent) && nodes.ChildCount(parent) == 0)
+			SetButton(TreeViewHandle, State, parent, false);
+
+		return result;
+	}
+
+	LRESULT GetNextItem(HWND TreeViewHandle, TreeState *State, WPARAM Flag, HTREEITEM Item)
+	{
+		auto& nodes = State->Nodes;
+		const NodeId node = FindNode(State, Item);
+
+		// NULL would mean the root to the control
+		if (node == CategoryTreeModel::npos && IsPendingHandle(Item))
+			return 0;
+
+		// Walking the tree is answered from the model so it doesn't create anything
+		if (node != CategoryTreeModel::npos)
+		{
+			switch (Flag)
+			{
+			case TVGN_CHILD:
+				if (!nodes.ChildrenCreated(node))
+					return (LRESULT)EditorHandle(State, nodes.FirstChild(node));
+				break;
+
+			case TVGN_NEXT:
+				if (!nodes.IsCreated(node))
+					return (LRESULT)EditorHandle(State, nodes.NextSibling(node));
+				break;
+
+			case TVGN_PREVIOUS:
+				if (!nodes.IsCreated(node))
+					return (LRESULT)EditorHandle(State, nodes.PrevSibling(node));
+				break;
+
+			case TVGN_PARENT:
+				if (!nodes.IsCreated(node))
+					return (LRESULT)EditorHandle(State, nodes.Parent(node));
+				break;
+			}
+		}
+
+		const LRESULT result = DefSubclassProc(TreeViewHandle, TVM_GETNEXTITEM, Flag, (LPARAM)ToControl(TreeViewHandle, State, Item));
+		return (LRESULT)ToEditor(State, (HTREEITEM)result);
+	}
+
+	bool GetPendingItem(TreeState *State, NodeId Node, TVITEMA *Item)
+	{
+		auto itr = State->Pending.find(Node);
+
+		if (itr == State->Pending.end() || (Item->mask & ~PendingItemFields))
+			return false;
+
+		const auto& pending = itr->second;
+		const auto& source = pending.Item;
+
+		// Values the editor hands out through callbacks need the real item
+		if ((Item->mask & TVIF_TEXT) && (source.mask & TVIF_TEXT) && source.pszText == LPSTR_TEXTCALLBACKA)
+			return false;
+
+		if ((Item->mask & TVIF_IMAGE) && (source.mask & TVIF_IMAGE) && source.iImage == I_IMAGECALLBACK)
+			return false;
+
+		if ((Item->mask & TVIF_SELECTEDIMAGE) && (source.mask & TVIF_SELECTEDIMAGE) && source.iSelectedImage == I_IMAGECALLBACK)
+			return false;
+
+		if ((Item->mask & TVIF_CHILDREN) && (source.mask & TVIF_CHILDREN) && source.cChildren == I_CHILDRENCALLBACK)
+			return false;
+
+		if ((Item->mask & TVIF_TEXT) && Item->pszText && Item->cchTextMax > 0)
+			strncpy_s(Item->pszText, Item->cchTextMax, pending.Text.c_str(), _TRUNCATE);
+
+		if (Item->mask & TVIF_IMAGE)
+			Item->iImage = (source.mask & TVIF_IMAGE) ? source.iImage : 0;
+
+		if (Item->mask & TVIF_SELECTEDIMAGE)
+			Item->iSelectedImage = (source.mask & TVIF_SELECTEDIMAGE) ? source.iSelectedImage : 0;
+
+		if (Item->mask & TVIF_PARAM)
+			Item->lParam = (source.mask & TVIF_PARAM) ? source.lParam : 0;
+
+		if (Item->mask & TVIF_STATE)
+			Item->state = ((source.mask & TVIF_STATE) ? (source.state & source.stateMask) : 0) & Item->stateMask;
+
+		if (Item->mask & TVIF_CHILDREN)
+			Item->cChildren = (State->Nodes.ChildCount(Node) > 0) ? 1 : ((source.mask & TVIF_CHILDREN) ? source.cChildren : 0);
+
+		return true;
+	}
+
+	bool SetPendingItem(TreeState *State, NodeId Node, const TVITEMA *Item)
+	{
+		auto itr = State->Pending.find(Node);
+
+		if (itr == State->Pending.end() || (Item->mask & ~PendingItemFields))
+			return false;
+
+		auto& pending = itr->second;
+		auto& target = pending.Item;
+
+		if (Item->mask & TVIF_TEXT)
+		{
+			if (Item->pszText == LPSTR_TEXTCALLBACKA)
+			{
+				target.pszText = LPSTR_TEXTCALLBACKA;
+				pending.Text.clear();
+			}
+			else
+			{
+				target.pszText = nullptr;
+				pending.Text = Item->pszText ? Item->pszText : "";
+			}
+		}
+
+		if (Item->mask & TVIF_IMAGE)
+			target.iImage = Item->iImage;
+
+		if (Item->mask & TVIF_SELECTEDIMAGE)
+			target.iSelectedImage = Item->iSelectedImage;
+
+		if (Item->mask & TVIF_PARAM)
+			target.lParam = Item->lParam;
+
+		if (Item->mask & TVIF_CHILDREN)
+			target.cChildren = Item->cChildren;
+
+		if (Item->mask & TVIF_STATE)
+		{
+			const UINT previousMask = (target.mask & TVIF_STATE) ? target.stateMask : 0;
+			const UINT previousState = (target.mask & TVIF_STATE) ? target.state : 0;
+
+			target.state = (previousState & ~Item->stateMask) | (Item->state & Item->stateMask);
+			target.stateMask = previousMask | Item->stateMask;
+		}
+
+		target.mask |= Item->mask & ~TVIF_HANDLE;
+		return true;
+	}
+
+	void TranslateNotification(NMHDR *Header)
+	{
+		auto state = GetState(Header->hwndFrom);
+
+		if (!state)
+			return;
+
+		switch (Header->code)
+		{
+		case TVN_ITEMEXPANDINGA:
+		case TVN_ITEMEXPANDINGW:
+		{
+			// Children are created right before the control has to show them
+			auto info = (NMTREEVIEWA *)Header;
+
+			if (info->action & TVE_EXPAND)
+				CreateChildren(Header->hwndFrom, state, state->Nodes.Find((uint64_t)info->itemNew.hItem));
+		}
+		[[fallthrough]];
+
+		case TVN_ITEMEXPANDEDA:
+		case TVN_ITEMEXPANDEDW:
+		case TVN_SELCHANGINGA:
+		case TVN_SELCHANGINGW:
+		case TVN_SELCHANGEDA:
+		case TVN_SELCHANGEDW:
+		case TVN_BEGINDRAGA:
+		case TVN_BEGINDRAGW:
+		case TVN_BEGINRDRAGA:
+		case TVN_BEGINRDRAGW:
+		case TVN_DELETEITEMA:
+		case TVN_DELETEITEMW:
+		case TVN_SINGLEEXPAND:
+		{
+			auto info = (NMTREEVIEWA *)Header;
+			info->itemOld.hItem = ToEditor(state, info->itemOld.hItem);
+			info->itemNew.hItem = ToEditor(state, info->itemNew.hItem);
+		}
+		break;
+
+		case TVN_GETDISPINFOA:
+		case TVN_GETDISPINFOW:
+		case TVN_SETDISPINFOA:
+		case TVN_SETDISPINFOW:
+		case TVN_BEGINLABELEDITA:
+		case TVN_BEGINLABELEDITW:
+		case TVN_ENDLABELEDITA:
+		case TVN_ENDLABELEDITW:
+		{
+			auto info = (NMTVDISPINFOA *)Header;
+			info->item.hItem = ToEditor(state, info->item.hItem);
+		}
+		break;
+
+		case TVN_GETINFOTIPA:
+		case TVN_GETINFOTIPW:
+		{
+			auto info = (NMTVGETINFOTIPA *)Header;
+			info->hItem = ToEditor(state, info->hItem);
+		}
+		break;
+
+		case NM_CUSTOMDRAW:
+		{
+			auto info = (NMTVCUSTOMDRAW *)Header;
+
+			if (info->nmcd.dwDrawStage & CDDS_ITEM)
+				info->nmcd.dwItemSpec = (DWORD_PTR)ToEditor(state, (HTREEITEM)info->nmcd.dwItemSpec);
+		}
+		break;
+		}
+	}
+
+	LRESULT CALLBACK TreeViewSubclass(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam, UINT_PTR uIdSubclass, DWORD_PTR dwRefData)
+	{
+		auto state = (TreeState *)dwRefData;
+
+		if (state->Passthrough && uMsg != WM_NCDESTROY)
+			return DefSubclassProc(hWnd, uMsg, wParam, lParam);
+
+		switch (uMsg)
+		{
+		case WM_DESTROY:
+			NotifyPendingDeleted(hWnd, state, CategoryTreeModel::Root);
+			state->Pending.clear();
+			break;
+
+		case WM_NCDESTROY:
+			RemoveWindowSubclass(hWnd, TreeViewSubclass, uIdSubclass);
+			delete state;
+			break;
+
+		case TVM_INSERTITEMA:
+		case TVM_INSERTITEMW:
+			return InsertItem(hWnd, state, uMsg, wParam, (TVINSERTSTRUCTA *)lParam);
+
+		case TVM_DELETEITEM:
+			return DeleteItem(hWnd, state, (HTREEITEM)lParam);
+
+		case TVM_GETNEXTITEM:
+			return GetNextItem(hWnd, state, wParam, (HTREEITEM)lParam);
+
+		case TVM_GETCOUNT:
+			return DefSubclassProc(hWnd, uMsg, wParam, lParam) + (state->Nodes.Count() - state->Nodes.CreatedCount());
+
+		case TVM_GETITEMA:
+		case TVM_SETITEMA:
+		case TVM_GETITEMW:
+		case TVM_SETITEMW:
+		{
+			auto item = (TVITEMA *)lParam;
+
+			if (!item)
+				break;
+
+			if (IsPendingHandle(item->hItem) && (uMsg == TVM_GETITEMA || uMsg == TVM_SETITEMA))
+			{
+				const NodeId node = state->Nodes.Find((uint64_t)item->hItem);
+
+				if (node != CategoryTreeModel::npos && !state->Nodes.IsCreated(node))
+				{
+					if (uMsg == TVM_GETITEMA ? GetPendingItem(state, node, item) : SetPendingItem(state, node, item))
+						return TRUE;
+				}
+			}
+
+			const HTREEITEM original = item->hItem;
+			item->hItem = ToControl(hWnd, state, original);
+
+			const LRESULT result = DefSubclassProc(hWnd, uMsg, wParam, lParam);
+			item->hItem = original;
+
+			return result;
+		}
+
+		case TVM_EXPAND:
+		{
+			const HTREEITEM item = ToControl(hWnd, state, (HTREEITEM)lParam);
+
+			// Expanding an item that was expanded once before doesn't notify, so don't rely on TVN_ITEMEXPANDING
+			if (wParam & TVE_EXPAND)
+				CreateChildren(hWnd, state, FindNode(state, item));
+
+			return DefSubclassProc(hWnd, uMsg, wParam, (LPARAM)item);
+		}
+
+		case TVM_SORTCHILDREN:
+		{
+			const HTREEITEM item = ToControl(hWnd, state, (HTREEITEM)lParam);
+
+			if (wParam)
+				CreateSubtree(hWnd, state, FindNode(state, item));
+			else
+				CreateChildren(hWnd, state, FindNode(state, item));
+
+			return DefSubclassProc(hWnd, uMsg, wParam, (LPARAM)item);
+		}
+
+		case TVM_SORTCHILDRENCB:
+		{
+			auto sort = (TVSORTCB *)lParam;
+
+			if (!sort)
+				break;
+
+			const HTREEITEM original = sort->hParent;
+			sort->hParent = ToControl(hWnd, state, original);
+
+			if (wParam)
+				CreateSubtree(hWnd, state, FindNode(state, sort->hParent));
+			else
+				CreateChildren(hWnd, state, FindNode(state, sort->hParent));
+
+			const LRESULT result = DefSubclassProc(hWnd, uMsg, wParam, lParam);
+			sort->hParent = original;
+
+			return result;
+		}
+
+		case TVM_SELECTITEM:
+		case TVM_ENSUREVISIBLE:
+		case TVM_EDITLABELA:
+		case TVM_EDITLABELW:
+		case TVM_SETINSERTMARK:
+		case TVM_CREATEDRAGIMAGE:
+			return DefSubclassProc(hWnd, uMsg, wParam, (LPARAM)ToControl(hWnd, state, (HTREEITEM)lParam));
+
+		case TVM_GETITEMSTATE:
+			return DefSubclassProc(hWnd, uMsg, (WPARAM)ToControl(hWnd, state, (HTREEITEM)wParam), lParam);
+
+		case TVM_GETITEMRECT:
+			// The handle is passed in the first bytes of the rectangle, which the control overwrites anyway
+			if (lParam)
+				*(HTREEITEM *)lParam = ToControl(hWnd, state, *(HTREEITEM *)lParam);
+			break;
+
+		case TVM_HITTEST:
+		{
+			const LRESULT result = DefSubclassProc(hWnd, uMsg, wParam, lParam);
+
+			if (auto info = (TVHITTESTINFO *)lParam; info)
+				info->hItem = ToEditor(state, info->hItem);
+
+			return (LRESULT)ToEditor(state, (HTREEITEM)result);
+		}
+		}
+
+		return DefSubclassProc(hWnd, uMsg, wParam, lParam);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "../../common.h"
+#include <CommCtrl.h>
+#include "CategoryTreeModel.h"
+
+namespace LazyTreeView
+{
+	void Initialize(bool Enable);
+
+	void Attach(HWND DialogHwnd, int ControlId);
+	void BeginBuild(HWND TreeViewHandle);
+	void EndBuild(HWND TreeViewHandle);
+
+	void TranslateNotification(NMHDR *Header);
+	LRESULT CALLBACK TreeViewSubclass(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam, UINT_PTR uIdSubclass, DWORD_PTR dwRefData);
+}
\ No newline at end of file
@@ -0,0 +1,233 @@
+#include "ListRowModel.h"
+
+uint32_t ListRowModel::Count() const
+{
+	return (uint32_t)(m_Filtered ? m_Visible.size() : m_Rows.size());
+}
+
+uint32_t ListRowModel::TotalCount() const
+{
+	return (uint32_t)m_Rows.size();
+}
+
+bool ListRowModel::IsFiltered() const
+{
+	return m_Filtered;
+}
+
+uint64_t ListRowModel::Version() const
+{
+	return m_Version;
+}
+
+ListRowModel::Row ListRowModel::At(uint32_t Index) const
+{
+	uint32_t row = RowIndex(Index);
+
+	return (row != npos) ? m_Rows[row] : nullptr;
+}
+
+ListRowModel::Row ListRowModel::AtRow(uint32_t RowIndex) const
+{
+	return (RowIndex < m_Rows.size()) ? m_Rows[RowIndex] : nullptr;
+}
+
+uint32_t ListRowModel::RowIndex(uint32_t Index) const
+{
+	if (Index >= Count())
+		return npos;
+
+	return m_Filtered ? m_Visible[Index] : Index;
+}
+
+uint32_t ListRowModel::VisibleIndex(uint32_t RowIndex) const
+{
+	if (RowIndex >= m_Rows.size())
+		return npos;
+
+	if (!m_Filtered)
+		return RowIndex;
+
+	auto itr = std::lower_bound(m_Visible.begin(), m_Visible.end(), RowIndex);
+
+	if (itr == m_Visible.end() || *itr != RowIndex)
+		return npos;
+
+	return (uint32_t)(itr - m_Visible.begin());
+}
+
+uint32_t ListRowModel::Insert(uint32_t Index, Row Value)
+{
+	const uint32_t row = (Index < Count()) ? RowIndex(Index) : (uint32_t)m_Rows.size();
+	const bool append = row == m_Rows.size();
+
+	m_Rows.insert(m_Rows.begin() + row, Value);
+	m_Version++;
+
+	if (append)
+	{
+		// Appends keep every existing index valid, so the lookup table can be patched instead of thrown away
+		if (m_LookupValid)
+			m_Lookup.emplace(Value, row);
+	}
+	else
+		m_LookupValid = false;
+
+	if (!m_Filtered)
+		return row;
+
+	auto itr = std::lower_bound(m_Visible.begin(), m_Visible.end(), row);
+
+	for (auto shift = itr; shift != m_Visible.end(); shift++)
+		(*shift)++;
+
+	if (!Accepts(Value))
+		return npos;
+
+	return (uint32_t)(m_Visible.insert(itr, row) - m_Visible.begin());
+}
+
+void ListRowModel::Append(const Row *Values, size_t Count)
+{
+	const uint32_t first = (uint32_t)m_Rows.size();
+
+	m_Rows.insert(m_Rows.end(), Values, Values + Count);
+	m_Version++;
+
+	for (uint32_t i = first; i < (uint32_t)m_Rows.size(); i++)
+	{
+		if (m_LookupValid)
+			m_Lookup.emplace(m_Rows[i], i);
+
+		if (m_Filtered && Accepts(m_Rows[i]))
+			m_Visible.push_back(i);
+	}
+}
+
+bool ListRowModel::Set(uint32_t Index, Row Value)
+{
+	const uint32_t row = RowIndex(Index);
+
+	if (row == npos)
+		return false;
+
+	m_Rows[row] = Value;
+	m_LookupValid = false;
+	m_Version++;
+	return true;
+}
+
+bool ListRowModel::Remove(uint32_t Index)
+{
+	const uint32_t row = RowIndex(Index);
+
+	if (row == npos)
+		return false;
+
+	m_Rows.erase(m_Rows.begin() + row);
+	m_LookupValid = false;
+	m_Version++;
+
+	if (m_Filtered)
+	{
+		auto itr = m_Visible.erase(m_Visible.begin() + Index);
+
+		for (; itr != m_Visible.end(); itr++)
+			(*itr)--;
+	}
+
+	return true;
+}
+
+void ListRowModel::Clear()
+{
+	// The filter itself stays, it applies to whatever gets added next
+	m_Rows.clear();
+	m_Visible.clear();
+	m_Lookup.clear();
+	m_LookupValid = false;
+	m_Version++;
+}
+
+uint32_t ListRowModel::Find(Row Value, uint32_t Start) const
+{
+	if (m_Rows.size() >= LookupThreshold)
+	{
+		BuildLookup();
+
+		auto itr = m_Lookup.find(Value);
+
+		if (itr == m_Lookup.end())
+			return npos;
+
+		// The table only knows the first occurrence. Anything past Start has to be scanned for.
+		if (uint32_t index = VisibleIndex(itr->second); index != npos && index >= Start)
+			return index;
+	}
+
+	for (uint32_t i = Start; i < Count(); i++)
+	{
+		if (At(i) == Value)
+			return i;
+	}
+
+	return npos;
+}
+
+void ListRowModel::Filter(RowPredicate Predicate)
+{
+	if (!Predicate)
+	{
+		ClearFilter();
+		return;
+	}
+
+	m_Predicate = std::move(Predicate);
+	m_Filtered = true;
+	m_Visible.clear();
+
+	for (uint32_t i = 0; i < (uint32_t)m_Rows.size(); i++)
+	{
+		if (m_Predicate(m_Rows[i]))
+			m_Visible.push_back(i);
+	}
+}
+
+void ListRowModel::SetVisibleRows(std::vector<uint32_t> RowIndices)
+{
+	std::sort(RowIndices.begin(), RowIndices.end());
+	RowIndices.erase(std::unique(RowIndices.begin(), RowIndices.end()), RowIndices.end());
+	RowIndices.erase(std::lower_bound(RowIndices.begin(), RowIndices.end(), (uint32_t)m_Rows.size()), RowIndices.end());
+
+	m_Predicate = nullptr;
+	m_Filtered = true;
+	m_Visible = std::move(RowIndices);
+}
+
+void ListRowModel::ClearFilter()
+{
+	m_Predicate = nullptr;
+	m_Filtered = false;
+	m_Visible.clear();
+	m_Visible.shrink_to_fit();
+}
+
+bool ListRowModel::Accepts(Row Value) const
+{
+	// Rows added under an externally supplied visible set are shown until the next update replaces it
+	return !m_Predicate || m_Predicate(Value);
+}
+
+void ListRowModel::BuildLookup() const
+{
+	if (m_LookupValid)
+		return;
+
+	m_Lookup.clear();
+	m_Lookup.reserve(m_Rows.size());
+
+	for (uint32_t i = 0; i < (uint32_t)m_Rows.size(); i++)
+		m_Lookup.emplace(m_Rows[i], i);
+
+	m_LookupValid = true;
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+//
+// Backing store for an owner data (virtual) list view. Holds the row values in display order plus an optional filter
+// selecting which of them are shown. Every index taken or returned here is a visible index unless the name says
+// otherwise. No window handles or Win32 types so it can be exercised on its own.
+//
+class ListRowModel
+{
+public:
+	using Row = void *;
+	using RowPredicate = std::function<bool(Row)>;
+
+	static constexpr uint32_t npos = UINT32_MAX;
+
+private:
+	std::vector<Row> m_Rows;				// All rows, display order
+	std::vector<uint32_t> m_Visible;		// Ascending indices into m_Rows when filtered
+	bool m_Filtered = false;
+	RowPredicate m_Predicate;				// Empty when the visible set was supplied directly
+	uint64_t m_Version = 0;					// Bumped whenever rows change, but not when the filter does
+
+	// Value -> first row index, built on demand for lookups in long lists
+	mutable std::unordered_map<Row, uint32_t> m_Lookup;
+	mutable bool m_LookupValid = false;
+
+	static constexpr uint32_t LookupThreshold = 64;
+
+public:
+	uint32_t Count() const;
+	uint32_t TotalCount() const;
+	bool IsFiltered() const;
+	uint64_t Version() const;
+
+	Row At(uint32_t Index) const;
+	Row AtRow(uint32_t RowIndex) const;
+	uint32_t RowIndex(uint32_t Index) const;
+	uint32_t VisibleIndex(uint32_t RowIndex) const;
+
+	uint32_t Insert(uint32_t Index, Row Value);
+	void Append(const Row *Values, size_t Count);
+	bool Set(uint32_t Index, Row Value);
+	bool Remove(uint32_t Index);
+	void Clear();
+
+	uint32_t Find(Row Value, uint32_t Start = 0) const;
+
+	void Filter(RowPredicate Predicate);
+	void SetVisibleRows(std::vector<uint32_t> RowIndices);
+	void ClearFilter();
+
+	//
+	// Stable sort of every row, hidden ones included. Compare receives two row indices as they were before the sort
+	// began.
+	//
+	template<typename Compare>
+	void SortRows(Compare&& Cmp)
+	{
+		std::vector<uint32_t> order(m_Rows.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [&Cmp](uint32_t A, uint32_t B)
+		{
+			return Cmp(A, B);
+		});
+
+		std::vector<Row> sorted(m_Rows.size());
+		std::vector<uint32_t> newPosition(m_Rows.size());
+
+		for (uint32_t i = 0; i < (uint32_t)order.size(); i++)
+		{
+			sorted[i] = m_Rows[order[i]];
+			newPosition[order[i]] = i;
+		}
+
+		m_Rows = std::move(sorted);
+		m_LookupValid = false;
+		m_Version++;
+
+		if (m_Filtered)
+		{
+			// Same rows stay visible, now in their new order
+			for (uint32_t& index : m_Visible)
+				index = newPosition[index];
+
+			std::sort(m_Visible.begin(), m_Visible.end());
+		}
+	}
+
+	template<typename Compare>
+	void Sort(Compare&& Cmp)
+	{
+		SortRows([this, &Cmp](uint32_t A, uint32_t B)
+		{
+			return Cmp(m_Rows[A], m_Rows[B]);
+		});
+	}
+
+private:
+	bool Accepts(Row Value) const;
+	void BuildLookup() const;
+};
\ No newline at end of file
@@ -1,7 +1,8 @@
 #include "../../common.h"
-#include <tbb/concurrent_vector.h>
 #include <Richedit.h>
+#include <mutex>
 #include <unordered_set>
+#include "../../ScratchMemory.h"
 #include "EditorUI.h"
 #include "EditorUIDarkMode.h"
 #include "LogWindow.h"
@@ -13,7 +14,19 @@ namespace LogWindow
 	HANDLE ExternalPipeWriterHandle;
 	FILE *OutputFileHandle;
 
-	tbb::concurrent_vector<const char *> PendingMessages;
+	//
+	// Lines are copied into one of two batches. Writers append to the active batch while the window drains the other,
+	// so a line costs a bump allocation instead of a heap round-trip.
+	//
+	struct PendingBatch
+	{
+		FrameArena Strings;
+		std::vector<const char *> Messages;
+	};
+
+	std::mutex PendingMutex;
+	PendingBatch PendingBatches[2];
+	uint32_t PendingBatchIndex;
 	std::unordered_set<uint64_t> MessageBlacklist;
 
 	HWND GetWindow()
@@ -298,7 +311,7 @@ namespace LogWindow
 			if (wParam != UI_LOG_CMD_ADDTEXT)
 				break;
 
-			if (PendingMessages.size() <= 0)
+			if (std::lock_guard<std::mutex> lock(PendingMutex); PendingBatches[PendingBatchIndex].Messages.empty())
 				break;
 
 			return WndProc(Hwnd, UI_LOG_CMD_ADDTEXT, 0, 0);
@@ -315,10 +328,15 @@ namespace LogWindow
 			if (!autoScroll)
 				SendMessageA(richEditHwnd, EM_GETSCROLLPOS, 0, (WPARAM)&scrollRange);
 
-			// Get a copy of all elements and clear the global list
-			auto messages(std::move(PendingMessages));
+			// Swap batches so writers aren't blocked while this one is drained
+			PendingBatch *batch;
+			{
+				std::lock_guard<std::mutex> lock(PendingMutex);
+				batch = &PendingBatches[PendingBatchIndex];
+				PendingBatchIndex ^= 1;
+			}
 
-			for (const char *message : messages)
+			for (const char *message : batch->Messages)
 			{
 				// Move caret to the end, then write
 				CHARRANGE range
@@ -329,10 +347,11 @@ namespace LogWindow
 
 				SendMessageA(richEditHwnd, EM_EXSETSEL, 0, (LPARAM)&range);
 				SendMessageA(richEditHwnd, EM_REPLACESEL, FALSE, (LPARAM)message);
-
-				free((void *)message);
 			}
 
+			batch->Messages.clear();
+			batch->Strings.Reset();
+
 			if (!autoScroll)
 				SendMessageA(richEditHwnd, EM_SETSCROLLPOS, 0, (WPARAM)&scrollRange);
 
@@ -378,8 +397,11 @@ namespace LogWindow
 			fflush(OutputFileHandle);
 		}
 
-		if (PendingMessages.size() < 50000)
-			PendingMessages.push_back(_strdup(buffer));
+		std::lock_guard<std::mutex> lock(PendingMutex);
+		auto& batch = PendingBatches[PendingBatchIndex];
+
+		if (batch.Messages.size() < 50000)
+			batch.Messages.push_back(batch.Strings.Strdup(buffer));
 	}
 
 	void Log(const char *Format, ...)
@@ -0,0 +1,284 @@
+#include "../../common.h"
+#include <CommCtrl.h>
+#include <mutex>
+#include "EditorUI.h"
+#include "FilterEngine.h"
+#include "ObjectWindowFilter.h"
+#include "VirtualListView.h"
+
+namespace ObjectWindowFilter
+{
+	constexpr int ObjectListId = 1041;
+
+	struct FilterState
+	{
+		std::string LastText;						// Filter box contents as of the previous change
+		std::string PopulatedText;					// Filter the editor applied when it last filled the list
+		uint64_t KnownVersion = 0;					// Row model version at the previous change
+
+		std::shared_ptr<const FilterSnapshot> Snapshot;
+		uint64_t SnapshotVersion = UINT64_MAX;
+		bool SnapshotQueued = false;
+
+		std::mutex ResultMutex;
+		uint64_t ResultGeneration = 0;
+		uint64_t ResultVersion = 0;
+		std::vector<uint32_t> Results;
+	};
+
+	bool Enabled;
+	std::unique_ptr<FilterEngine> Engine;
+	FilterState State;
+
+	void Initialize(bool Enable)
+	{
+		// Filtering swaps the visible row set, which only an owner data list can do cheaply
+		Enabled = Enable && VirtualListView::IsEnabled();
+
+		if (Enabled)
+			Engine = std::make_unique<FilterEngine>();
+	}
+
+	void Reset()
+	{
+		if (!Enabled)
+			return;
+
+		Engine->Cancel();
+
+		State.LastText.clear();
+		State.PopulatedText.clear();
+		State.KnownVersion = 0;
+		State.Snapshot.reset();
+		State.SnapshotVersion = UINT64_MAX;
+		State.SnapshotQueued = false;
+	}
+
+	bool ContainsNoCase(const std::string& Text, const std::string& Part)
+	{
+		auto itr = std::search(Text.begin(), Text.end(), Part.begin(), Part.end(), [](char A, char B)
+		{
+			return tolower((uint8_t)A) == tolower((uint8_t)B);
+		});
+
+		return itr != Text.end() || Part.empty();
+	}
+
+	void GetCellText(HWND DialogHwnd, HWND ListViewHandle, void *Form, int Index, int Column, char *Buffer, int BufferSize)
+	{
+		// Same request the list makes while painting, aimed at a row that may not be visible
+		NMLVDISPINFOA info = {};
+		info.hdr.hwndFrom = ListViewHandle;
+		info.hdr.idFrom = GetDlgCtrlID(ListViewHandle);
+		info.hdr.code = LVN_GETDISPINFOA;
+		info.item.mask = LVIF_TEXT;
+		info.item.iItem = Index;
+		info.item.iSubItem = Column;
+		info.item.lParam = (LPARAM)Form;
+		info.item.pszText = Buffer;
+		info.item.cchTextMax = BufferSize;
+
+		Buffer[0] = '\0';
+		SendMessageA(DialogHwnd, WM_NOTIFY, info.hdr.idFrom, (LPARAM)&info);
+
+		// Handlers are allowed to point at their own storage instead of copying
+		if (info.item.pszText && info.item.pszText != Buffer && info.item.pszText != LPSTR_TEXTCALLBACKA)
+			strncpy_s(Buffer, BufferSize, info.item.pszText, _TRUNCATE);
+	}
+
+	std::shared_ptr<const FilterSnapshot> BuildSnapshot(HWND DialogHwnd, HWND ListViewHandle, const ListRowModel& Rows)
+	{
+		ProfileTimer("Object Window Filter Snapshot");
+
+		int editorIdColumn = 0;
+		int formIdColumn = -1;
+		const int columnCount = Header_GetItemCount(ListView_GetHeader(ListViewHandle));
+
+		for (int i = 0; i < columnCount; i++)
+		{
+			char name[64] = {};
+			LVCOLUMNA column = {};
+			column.mask = LVCF_TEXT;
+			column.pszText = name;
+			column.cchTextMax = ARRAYSIZE(name);
+
+			if (!ListView_GetColumn(ListViewHandle, i, &column))
+				continue;
+
+			if (!_stricmp(name, "Editor ID"))
+				editorIdColumn = i;
+			else if (!_stricmp(name, "Form ID"))
+				formIdColumn = i;
+		}
+
+		// Types and flags aren't shown in the list, so they're left as 0 and queries don't restrict them
+		auto snapshot = std::make_shared<FilterSnapshot>();
+		snapshot->Reserve(Rows.TotalCount(), Rows.TotalCount() * 24);
+
+		for (uint32_t row = 0; row < Rows.TotalCount(); row++)
+		{
+			void *form = Rows.AtRow(row);
+			const uint32_t visibleIndex = Rows.VisibleIndex(row);
+			const int index = (visibleIndex != ListRowModel::npos) ? (int)visibleIndex : 0;
+
+			char editorId[512];
+			GetCellText(DialogHwnd, ListViewHandle, form, index, editorIdColumn, editorId, ARRAYSIZE(editorId));
+
+			uint32_t formId = 0;
+
+			if (formIdColumn != -1)
+			{
+				char text[64];
+				GetCellText(DialogHwnd, ListViewHandle, form, index, formIdColumn, text, ARRAYSIZE(text));
+				formId = strtoul(text, nullptr, 16);
+			}
+
+			snapshot->Add(formId, editorId, strlen(editorId), 0, 0);
+		}
+
+		return snapshot;
+	}
+
+	void UpdateSnapshot(HWND DialogHwnd, HWND ListViewHandle, const ListRowModel& Rows)
+	{
+		if (State.SnapshotVersion == Rows.Version())
+			return;
+
+		State.Snapshot = BuildSnapshot(DialogHwnd, ListViewHandle, Rows);
+		State.SnapshotVersion = Rows.Version();
+	}
+
+	//
+	// Reading every row back costs two LVN_GETDISPINFO round trips each, which is too slow to do inside a keystroke on
+	// big lists. It's queued instead once the rows have changed and the filter box has focus, so the work lands between
+	// the editor filling the list (or the user clicking into the box) and the first character typed.
+	//
+	void ScheduleSnapshot(HWND DialogHwnd)
+	{
+		if (!Enabled || State.SnapshotQueued || GetFocus() != GetDlgItem(DialogHwnd, UI_OBJECT_WINDOW_FILTER))
+			return;
+
+		auto rows = VirtualListView::GetRows(GetDlgItem(DialogHwnd, ObjectListId));
+
+		if (!rows || rows->Version() == State.SnapshotVersion)
+			return;
+
+		State.SnapshotQueued = true;
+		PostMessageA(DialogHwnd, UI_OBJECT_WINDOW_FILTER_SNAPSHOT, 0, 0);
+	}
+
+	void BuildPendingSnapshot(HWND DialogHwnd)
+	{
+		if (!Enabled)
+			return;
+
+		State.SnapshotQueued = false;
+
+		HWND listView = GetDlgItem(DialogHwnd, ObjectListId);
+
+		if (auto rows = VirtualListView::GetRows(listView))
+			UpdateSnapshot(DialogHwnd, listView, *rows);
+	}
+
+	void ShowAllRows(HWND ListViewHandle, ListRowModel *Rows)
+	{
+		if (!Rows->IsFiltered())
+			return;
+
+		EditorUI::ListViewCustomSetItemState(ListViewHandle, -1, 0, LVIS_SELECTED);
+		Rows->ClearFilter();
+		VirtualListView::Refresh(ListViewHandle);
+	}
+
+	bool HandleFilterChange(HWND DialogHwnd, HWND EditHandle)
+	{
+		HWND listView = GetDlgItem(DialogHwnd, ObjectListId);
+		auto rows = VirtualListView::GetRows(listView);
+
+		if (!Enabled || !rows)
+			return false;
+
+		char buffer[512] = {};
+		GetWindowTextA(EditHandle, buffer, ARRAYSIZE(buffer));
+		const std::string text(buffer);
+
+		// The editor refilled the list since the last change (new category, or it handled the previous change itself)
+		// using what the box held then
+		if (rows->Version() != State.KnownVersion)
+		{
+			State.PopulatedText = State.LastText;
+			State.KnownVersion = rows->Version();
+		}
+
+		State.LastText = text;
+
+		// Rows the editor already filtered out can't be brought back from here. Let it rebuild the list.
+		if (!ContainsNoCase(text, State.PopulatedText))
+		{
+			Engine->Cancel();
+			ShowAllRows(listView, rows);
+
+			State.PopulatedText = text;
+			State.KnownVersion = rows->Version();
+			return false;
+		}
+
+		if (text.size() == State.PopulatedText.size())
+		{
+			Engine->Cancel();
+			ShowAllRows(listView, rows);
+			return true;
+		}
+
+		// Normally prepared ahead of time, see ScheduleSnapshot
+		UpdateSnapshot(DialogHwnd, listView, *rows);
+
+		const uint64_t version = rows->Version();
+
+		Engine->Submit(State.Snapshot, { text }, [DialogHwnd, version](uint64_t Generation, std::vector<uint32_t>&& Rows)
+		{
+			{
+				std::lock_guard<std::mutex> lock(State.ResultMutex);
+
+				State.ResultGeneration = Generation;
+				State.ResultVersion = version;
+				State.Results = std::move(Rows);
+			}
+
+			PostMessageA(DialogHwnd, UI_OBJECT_WINDOW_FILTER_RESULTS, 0, 0);
+		});
+
+		return true;
+	}
+
+	void ApplyResults(HWND DialogHwnd)
+	{
+		if (!Enabled)
+			return;
+
+		std::vector<uint32_t> results;
+		uint64_t resultVersion;
+
+		{
+			std::lock_guard<std::mutex> lock(State.ResultMutex);
+
+			// Superseded by a newer keystroke while the message was queued
+			if (State.ResultGeneration != Engine->CurrentGeneration())
+				return;
+
+			results = std::move(State.Results);
+			resultVersion = State.ResultVersion;
+		}
+
+		HWND listView = GetDlgItem(DialogHwnd, ObjectListId);
+		auto rows = VirtualListView::GetRows(listView);
+
+		// Row indices are meaningless if the editor refilled the list in the meantime
+		if (!rows || rows->Version() != resultVersion)
+			return;
+
+		EditorUI::ListViewCustomSetItemState(listView, -1, 0, LVIS_SELECTED);
+		rows->SetVisibleRows(std::move(results));
+		VirtualListView::Refresh(listView);
+	}
+}
\ No newline at end of file
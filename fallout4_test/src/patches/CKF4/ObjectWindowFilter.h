@@ -0,0 +1,15 @@
+#pragma once
+
+#include "../../common.h"
+
+namespace ObjectWindowFilter
+{
+	void Initialize(bool Enable);
+	void Reset();
+
+	void ScheduleSnapshot(HWND DialogHwnd);
+	void BuildPendingSnapshot(HWND DialogHwnd);
+
+	bool HandleFilterChange(HWND DialogHwnd, HWND EditHandle);
+	void ApplyResults(HWND DialogHwnd);
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include <algorithm>
+#include "PointerSearchIndex.h"
+
+void PointerSearchIndex::Update(const void *const *Data, uint32_t Size)
+{
+	const uint32_t indexed = this->Size();
+
+	// A reallocated buffer normally brings its contents along, so compare instead of starting over
+	if (Data != m_Data)
+	{
+		m_Data = Data;
+		Resync(Size);
+		return;
+	}
+
+	// Erased or truncated
+	if (Size < indexed)
+	{
+		Resync(Size);
+		return;
+	}
+
+	// Same size or appended to. If the last element indexed moved, something was erased before the append.
+	if (indexed > 0 && Data[indexed - 1] != m_Elements[indexed - 1])
+	{
+		Resync(Size);
+		return;
+	}
+
+	Append(Size);
+}
+
+uint32_t PointerSearchIndex::Find(const void *Key)
+{
+	auto itr = m_Lowest.find(Key);
+
+	if (itr == m_Lowest.end())
+		return npos;
+
+	if (m_Data[itr->second] == Key)
+		return itr->second;
+
+	// Written in place since the last update
+	Resync(Size());
+
+	itr = m_Lowest.find(Key);
+	return (itr != m_Lowest.end()) ? itr->second : npos;
+}
+
+uint32_t PointerSearchIndex::Size() const
+{
+	return (uint32_t)m_Elements.size();
+}
+
+uint32_t PointerSearchIndex::Resyncs() const
+{
+	return m_Resyncs;
+}
+
+void PointerSearchIndex::Resync(uint32_t Size)
+{
+	const uint32_t first = FirstMismatch(Size);
+
+	if (first < this->Size())
+	{
+		m_Resyncs++;
+		Truncate(first);
+	}
+
+	Append(Size);
+}
+
+void PointerSearchIndex::Truncate(uint32_t Index)
+{
+	// Values that also appear before Index keep their entry, everything else is dropped
+	for (uint32_t i = Index; i < Size(); i++)
+	{
+		if (auto itr = m_Lowest.find(m_Elements[i]); itr != m_Lowest.end() && itr->second >= Index)
+			m_Lowest.erase(itr);
+	}
+
+	m_Elements.resize(Index);
+}
+
+void PointerSearchIndex::Append(uint32_t Size)
+{
+	// Indices only increase here, so an existing entry is always the lower one
+	for (uint32_t i = this->Size(); i < Size; i++)
+	{
+		m_Elements.push_back(m_Data[i]);
+		m_Lowest.try_emplace(m_Data[i], i);
+	}
+}
+
+uint32_t PointerSearchIndex::FirstMismatch(uint32_t Size) const
+{
+	const uint32_t count = std::min(Size, this->Size());
+
+	if (count == 0)
+		return 0;
+
+	return (uint32_t)(std::mismatch(m_Elements.begin(), m_Elements.begin() + count, m_Data).first - m_Elements.begin());
+}
\ No newline at end of file
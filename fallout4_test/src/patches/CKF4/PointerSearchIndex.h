@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+//
+// Pointer -> lowest index table for one array of pointers, answering the same question as a front to back scan. The
+// array is only observed, never told about, so Update compares it against a copy of what was indexed. Appends are
+// indexed as they show up. Erases and truncation are found from the first element that no longer matches the copy and
+// only the tail after it is reindexed. Everything else (a moved buffer, a hit that points at another value) triggers a
+// full comparison. A value replaced in place while the size and last element stay the same isn't seen until then.
+// Not thread safe.
+//
+class PointerSearchIndex
+{
+public:
+	static constexpr uint32_t npos = 0xFFFFFFFF;
+
+private:
+	const void *const *m_Data = nullptr;
+	std::vector<const void *> m_Elements;					// Array contents as indexed
+	std::unordered_map<const void *, uint32_t> m_Lowest;	// Value -> first index holding it
+	uint32_t m_Resyncs = 0;
+
+public:
+	void Update(const void *const *Data, uint32_t Size);
+	uint32_t Find(const void *Key);
+
+	uint32_t Size() const;
+	uint32_t Resyncs() const;
+
+private:
+	void Resync(uint32_t Size);
+	void Truncate(uint32_t Index);
+	void Append(uint32_t Size);
+	uint32_t FirstMismatch(uint32_t Size) const;
+};
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+//
+// LSD radix sort for arrays whose comparator turns out to order elements by a plain integer key (form ID, pointer).
+// The editor only hands us an opaque comparator, so nothing is assumed: TryRadixSort sorts by each candidate key and
+// then checks the result with the comparator itself (n - 1 calls instead of n log n). A key that fails the check is
+// remembered for that comparator and never tried again. Results are only valid where any ordering of equal elements is
+// acceptable, i.e. unstable sorts.
+//
+constexpr uint32_t RadixSortThreshold = 256;
+
+template<typename T>
+struct RadixSortKey
+{
+	uint64_t(*Get)(const T& Element);
+	uint32_t Bytes;
+};
+
+class RadixSortVerdicts
+{
+private:
+	std::mutex m_Lock;
+	std::vector<std::pair<uintptr_t, uint32_t>> m_Rejected;
+
+public:
+	bool IsRejected(uintptr_t Comparator, uint32_t KeyIndex)
+	{
+		std::lock_guard lock(m_Lock);
+		return std::find(m_Rejected.begin(), m_Rejected.end(), std::make_pair(Comparator, KeyIndex)) != m_Rejected.end();
+	}
+
+	void Reject(uintptr_t Comparator, uint32_t KeyIndex)
+	{
+		std::lock_guard lock(m_Lock);
+		m_Rejected.emplace_back(Comparator, KeyIndex);
+	}
+};
+
+template<typename T>
+void RadixSortByKey(T *First, T *Last, const RadixSortKey<T>& Key)
+{
+	struct Entry
+	{
+		uint64_t Key;
+		T Value;
+	};
+
+	const size_t count = Last - First;
+
+	if (count <= 1)
+		return;
+
+	std::vector<Entry> entries(count);
+	std::vector<Entry> scratch(count);
+
+	for (size_t i = 0; i < count; i++)
+		entries[i] = { Key.Get(First[i]), First[i] };
+
+	for (uint32_t shift = 0; shift < Key.Bytes * 8; shift += 8)
+	{
+		size_t offsets[256] = {};
+
+		for (auto& entry : entries)
+			offsets[(entry.Key >> shift) & 0xFF]++;
+
+		// Every key shares this byte, the pass wouldn't change anything
+		if (offsets[(entries[0].Key >> shift) & 0xFF] == count)
+			continue;
+
+		for (size_t i = 0, total = 0; i < 256; i++)
+		{
+			size_t bucketSize = offsets[i];
+			offsets[i] = total;
+			total += bucketSize;
+		}
+
+		for (auto& entry : entries)
+			scratch[offsets[(entry.Key >> shift) & 0xFF]++] = entry;
+
+		std::swap(entries, scratch);
+	}
+
+	for (size_t i = 0; i < count; i++)
+		First[i] = entries[i].Value;
+}
+
+template<typename T, typename Compare>
+bool TryRadixSort(T *First, T *Last, Compare Comp, uintptr_t Comparator, const RadixSortKey<T> *Keys, uint32_t KeyCount,
+	RadixSortVerdicts& Verdicts)
+{
+	for (uint32_t i = 0; i < KeyCount; i++)
+	{
+		if (Verdicts.IsRejected(Comparator, i))
+			continue;
+
+		RadixSortByKey(First, Last, Keys[i]);
+
+		if (std::is_sorted(First, Last, Comp))
+			return true;
+
+		// Elements are only permuted, the caller's comparison sort still gets every one of them
+		Verdicts.Reject(Comparator, i);
+	}
+
+	return false;
+}
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include "ReadyRecordQueue.h"
+
+void ReadyRecordQueue::SetBudget(size_t Budget)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Budget = Budget;
+}
+
+size_t ReadyRecordQueue::GetBudget() const
+{
+	return m_Budget;
+}
+
+bool ReadyRecordQueue::Reserve(uint32_t Size, const std::atomic_bool& Cancel, uint64_t *Sequence)
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+
+	while (m_Bytes + Size > m_Budget && !Cancel)
+	{
+		EvictConsumedRecords();
+
+		if (m_Bytes + Size <= m_Budget)
+			break;
+
+		m_SpaceAvailable.wait_for(lock, std::chrono::milliseconds(50));
+	}
+
+	if (Cancel)
+		return false;
+
+	m_Bytes += Size;
+	*Sequence = m_NextSequence++;
+	return true;
+}
+
+void ReadyRecordQueue::Release(uint32_t Size)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Bytes -= Size;
+	}
+
+	m_SpaceAvailable.notify_one();
+}
+
+bool ReadyRecordQueue::Publish(uint64_t Key, Record&& Value)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		auto [itr, inserted] = m_Records.try_emplace(Key);
+
+		if (inserted)
+		{
+			itr->second = std::move(Value);
+			return true;
+		}
+
+		// Identical payload (or a key collision) already waiting. Either way the loader can inflate this one inline.
+		m_Bytes -= Value.Reserved;
+	}
+
+	m_SpaceAvailable.notify_one();
+	return false;
+}
+
+ReadyRecordQueue::TakeResult ReadyRecordQueue::Take(uint64_t Key, const void *Input, uint32_t InputLength, uint32_t OutputLength, Record *Value)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		auto itr = m_Records.find(Key);
+
+		if (itr == m_Records.end() || itr->second.Length > OutputLength)
+			return TakeResult::Missing;
+
+		// Same hash, different record. Leave it for its owner.
+		if (!MatchesInput(itr->second.Data.get(), itr->second.Length, itr->second.InputLength, Input, InputLength))
+			return TakeResult::Collision;
+
+		*Value = std::move(itr->second);
+		m_Records.erase(itr);
+
+		m_Bytes -= Value->Reserved;
+		m_LastTakenSequence = std::max(m_LastTakenSequence, Value->Sequence);
+	}
+
+	m_SpaceAvailable.notify_one();
+	return TakeResult::Taken;
+}
+
+void ReadyRecordQueue::DropOwner(const void *Owner)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		for (auto itr = m_Records.begin(); itr != m_Records.end();)
+		{
+			if (itr->second.Owner == Owner)
+			{
+				m_Bytes -= itr->second.Reserved;
+				itr = m_Records.erase(itr);
+			}
+			else
+				itr++;
+		}
+	}
+
+	m_SpaceAvailable.notify_all();
+}
+
+void ReadyRecordQueue::WakeAll()
+{
+	m_SpaceAvailable.notify_all();
+}
+
+bool ReadyRecordQueue::Empty()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Records.empty();
+}
+
+size_t ReadyRecordQueue::ReservedBytes()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Bytes;
+}
+
+bool ReadyRecordQueue::MatchesInput(const uint8_t *Data, uint32_t Length, uint32_t StoredInputLength, const void *Input, uint32_t InputLength)
+{
+	return StoredInputLength == InputLength && !memcmp(Data + Length, Input, InputLength);
+}
+
+void ReadyRecordQueue::EvictConsumedRecords()
+{
+	// Anything scanned before the last record the loader took was either skipped or already inflated inline
+	for (auto itr = m_Records.begin(); itr != m_Records.end();)
+	{
+		if (itr->second.Sequence < m_LastTakenSequence)
+		{
+			m_Bytes -= itr->second.Reserved;
+			itr = m_Records.erase(itr);
+		}
+		else
+			itr++;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+//
+// Decompressed records waiting for the loader, bounded by one byte budget shared by every open file. Space is reserved
+// before a record is inflated so in-flight work counts against the budget too. Each record remembers the file job that
+// scanned it, and closing a file drops whatever the loader never took. Record buffers hold the decompressed bytes
+// followed by a copy of the compressed input, since keys are only a hash. There are no Win32 types, so it can be
+// exercised on its own.
+//
+class ReadyRecordQueue
+{
+public:
+	struct Record
+	{
+		const void *Owner;				// File job that scanned it
+		uint64_t Sequence;				// Scan order, used to drop records the loader already went past
+		uint32_t Length;				// Decompressed bytes
+		uint32_t InputLength;			// Compressed bytes stored after them
+		uint32_t Reserved;				// Bytes charged against the budget
+		std::unique_ptr<uint8_t[]> Data;
+	};
+
+	enum class TakeResult
+	{
+		Missing,
+		Collision,
+		Taken,
+	};
+
+private:
+	std::mutex m_Mutex;
+	std::condition_variable m_SpaceAvailable;
+	std::unordered_map<uint64_t, Record> m_Records;
+	size_t m_Budget = 0;
+	size_t m_Bytes = 0;
+	uint64_t m_NextSequence = 0;
+	uint64_t m_LastTakenSequence = 0;
+
+public:
+	void SetBudget(size_t Budget);
+	size_t GetBudget() const;
+
+	bool Reserve(uint32_t Size, const std::atomic_bool& Cancel, uint64_t *Sequence);
+	void Release(uint32_t Size);
+	bool Publish(uint64_t Key, Record&& Value);
+	TakeResult Take(uint64_t Key, const void *Input, uint32_t InputLength, uint32_t OutputLength, Record *Value);
+	void DropOwner(const void *Owner);
+	void WakeAll();
+
+	bool Empty();
+	size_t ReservedBytes();
+
+	static bool MatchesInput(const uint8_t *Data, uint32_t Length, uint32_t StoredInputLength, const void *Input, uint32_t InputLength);
+
+private:
+	void EvictConsumedRecords();
+};
\ No newline at end of file
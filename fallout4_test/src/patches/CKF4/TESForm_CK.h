@@ -8,5 +8,16 @@ public:
 	using Array = BSTArray<TESForm_CK *>;
 
 	virtual ~TESForm_CK();
+
+	char _pad8[0x8];
+	uint32_t m_Flags;
+	uint32_t m_FormID;
+
+	uint32_t GetFormID() const
+	{
+		return m_FormID;
+	}
+
 	static TESForm_CK *GetFormByNumericID(uint32_t SearchID);
-};
\ No newline at end of file
+};
+static_assert_offset(TESForm_CK, m_FormID, 0x14);
\ No newline at end of file
@@ -0,0 +1,240 @@
+#include <algorithm>
+#include "TypeAheadIndex.h"
+
+void TypeAheadIndex::Clear()
+{
+	m_Text.clear();
+	m_Offsets.clear();
+	m_Sorted.clear();
+	m_BlockItems.clear();
+
+	m_TrigramsBuilt = false;
+	m_TrigramKeys.clear();
+	m_TrigramOffsets.clear();
+	m_TrigramItems.clear();
+}
+
+void TypeAheadIndex::Add(const char *String, size_t Length)
+{
+	m_Offsets.push_back((uint32_t)m_Text.size());
+
+	for (size_t i = 0; i < Length; i++)
+		m_Text.push_back(Fold(String[i]));
+}
+
+void TypeAheadIndex::Finalize()
+{
+	const uint32_t count = (uint32_t)m_Offsets.size();
+	m_Offsets.push_back((uint32_t)m_Text.size());
+
+	m_Sorted.resize(count);
+
+	for (uint32_t i = 0; i < count; i++)
+		m_Sorted[i] = i;
+
+	std::sort(m_Sorted.begin(), m_Sorted.end(), [this](uint32_t A, uint32_t B)
+	{
+		int result = GetLowered(A).compare(GetLowered(B));
+		return (result != 0) ? (result < 0) : (A < B);
+	});
+
+	m_BlockItems = m_Sorted;
+
+	for (size_t i = 0; i < m_BlockItems.size(); i += BlockSize)
+		std::sort(m_BlockItems.begin() + i, m_BlockItems.begin() + std::min(i + BlockSize, m_BlockItems.size()));
+}
+
+uint32_t TypeAheadIndex::Count() const
+{
+	return m_Offsets.empty() ? 0 : (uint32_t)m_Offsets.size() - 1;
+}
+
+std::string_view TypeAheadIndex::GetLowered(uint32_t Item) const
+{
+	return std::string_view(m_Text.data() + m_Offsets[Item], m_Offsets[Item + 1] - m_Offsets[Item]);
+}
+
+uint32_t TypeAheadIndex::FindPrefix(const char *Prefix, size_t Length, uint32_t Start) const
+{
+	const std::string prefix = Lower(Prefix, Length);
+
+	auto first = std::lower_bound(m_Sorted.begin(), m_Sorted.end(), prefix, [this](uint32_t Item, const std::string& Value)
+	{
+		return GetLowered(Item).substr(0, Value.size()) < Value;
+	});
+
+	auto last = std::upper_bound(first, m_Sorted.end(), prefix, [this](const std::string& Value, uint32_t Item)
+	{
+		return Value < GetLowered(Item).substr(0, Value.size());
+	});
+
+	return LowestInRange(first - m_Sorted.begin(), last - m_Sorted.begin(), Start);
+}
+
+uint32_t TypeAheadIndex::FindExact(const char *String, size_t Length, uint32_t Start) const
+{
+	const std::string value = Lower(String, Length);
+
+	auto first = std::lower_bound(m_Sorted.begin(), m_Sorted.end(), value, [this](uint32_t Item, const std::string& Value)
+	{
+		return GetLowered(Item) < std::string_view(Value);
+	});
+
+	auto last = std::upper_bound(first, m_Sorted.end(), value, [this](const std::string& Value, uint32_t Item)
+	{
+		return std::string_view(Value) < GetLowered(Item);
+	});
+
+	return LowestInRange(first - m_Sorted.begin(), last - m_Sorted.begin(), Start);
+}
+
+uint32_t TypeAheadIndex::FindSubstring(const char *String, size_t Length, uint32_t Start) const
+{
+	const std::string value = Lower(String, Length);
+	const uint32_t count = Count();
+
+	if (value.empty())
+		return (Start < count) ? Start : npos;
+
+	if (value.size() < 3)
+	{
+		// Too short for a trigram, but a straight scan over the packed text is still cheap
+		for (uint32_t i = Start; i < count; i++)
+		{
+			if (GetLowered(i).find(value) != std::string_view::npos)
+				return i;
+		}
+
+		return npos;
+	}
+
+	BuildTrigrams();
+
+	// Walk the rarest trigram's posting list and confirm each candidate
+	const uint32_t *bestFirst = nullptr;
+	const uint32_t *bestLast = nullptr;
+
+	for (size_t i = 0; i + 3 <= value.size(); i++)
+	{
+		const uint32_t key = ((uint8_t)value[i] << 16) | ((uint8_t)value[i + 1] << 8) | (uint8_t)value[i + 2];
+		auto itr = std::lower_bound(m_TrigramKeys.begin(), m_TrigramKeys.end(), key);
+
+		if (itr == m_TrigramKeys.end() || *itr != key)
+			return npos;
+
+		const size_t slot = itr - m_TrigramKeys.begin();
+		const uint32_t *first = m_TrigramItems.data() + m_TrigramOffsets[slot];
+		const uint32_t *last = m_TrigramItems.data() + m_TrigramOffsets[slot + 1];
+
+		if (!bestFirst || (last - first) < (bestLast - bestFirst))
+		{
+			bestFirst = first;
+			bestLast = last;
+		}
+	}
+
+	for (const uint32_t *itr = std::lower_bound(bestFirst, bestLast, Start); itr != bestLast; itr++)
+	{
+		if (GetLowered(*itr).find(value) != std::string_view::npos)
+			return *itr;
+	}
+
+	return npos;
+}
+
+char TypeAheadIndex::Fold(char C)
+{
+	return (C >= 'A' && C <= 'Z') ? (C - 'A' + 'a') : C;
+}
+
+std::string TypeAheadIndex::Lower(const char *String, size_t Length)
+{
+	std::string value(String, Length);
+
+	for (char& c : value)
+		c = Fold(c);
+
+	return value;
+}
+
+uint32_t TypeAheadIndex::LowestInRange(size_t First, size_t Last, uint32_t Start) const
+{
+	uint32_t best = npos;
+
+	auto consider = [&](uint32_t Item)
+	{
+		if (Item >= Start && Item < best)
+			best = Item;
+	};
+
+	while (First < Last)
+	{
+		const size_t blockStart = First - (First % BlockSize);
+		const size_t blockEnd = std::min(blockStart + BlockSize, m_Sorted.size());
+
+		if (First == blockStart && blockEnd <= Last)
+		{
+			// Whole block: its items are sorted, so the answer is a single binary search
+			auto begin = m_BlockItems.begin() + blockStart;
+			auto end = m_BlockItems.begin() + blockEnd;
+
+			if (auto itr = std::lower_bound(begin, end, Start); itr != end)
+				consider(*itr);
+
+			First = blockEnd;
+		}
+		else
+		{
+			const size_t end = std::min(blockEnd, Last);
+
+			for (; First < end; First++)
+				consider(m_Sorted[First]);
+		}
+	}
+
+	return best;
+}
+
+void TypeAheadIndex::BuildTrigrams() const
+{
+	if (m_TrigramsBuilt)
+		return;
+
+	// (trigram << 32 | item), sorted and deduplicated, then split into a key table and ascending posting lists
+	std::vector<uint64_t> pairs;
+	pairs.reserve(m_Text.size());
+
+	for (uint32_t item = 0; item < Count(); item++)
+	{
+		std::string_view text = GetLowered(item);
+
+		for (size_t i = 0; i + 3 <= text.size(); i++)
+		{
+			const uint32_t key = ((uint8_t)text[i] << 16) | ((uint8_t)text[i + 1] << 8) | (uint8_t)text[i + 2];
+			pairs.push_back(((uint64_t)key << 32) | item);
+		}
+	}
+
+	std::sort(pairs.begin(), pairs.end());
+	pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+	m_TrigramKeys.clear();
+	m_TrigramOffsets.clear();
+	m_TrigramItems.resize(pairs.size());
+
+	for (size_t i = 0; i < pairs.size(); i++)
+	{
+		const uint32_t key = (uint32_t)(pairs[i] >> 32);
+
+		if (m_TrigramKeys.empty() || m_TrigramKeys.back() != key)
+		{
+			m_TrigramKeys.push_back(key);
+			m_TrigramOffsets.push_back((uint32_t)i);
+		}
+
+		m_TrigramItems[i] = (uint32_t)pairs[i];
+	}
+
+	m_TrigramOffsets.push_back((uint32_t)pairs.size());
+	m_TrigramsBuilt = true;
+}
\ No newline at end of file
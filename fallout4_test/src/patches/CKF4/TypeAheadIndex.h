@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//
+// Case insensitive (ASCII) lookup over a fixed list of strings, i.e. the items of a combo box. Items are identified by
+// their position in the list as added. Prefix and exact queries go through a sorted permutation, substring queries
+// through a trigram index that is only built the first time one is made. All queries return the lowest matching item
+// at or after Start, or npos. Not thread safe.
+//
+class TypeAheadIndex
+{
+public:
+	static constexpr uint32_t npos = UINT32_MAX;
+
+private:
+	static constexpr uint32_t BlockSize = 256;
+
+	std::string m_Text;						// Lowercased strings, back to back
+	std::vector<uint32_t> m_Offsets;		// Item -> start in m_Text, plus one trailing entry
+	std::vector<uint32_t> m_Sorted;			// Items ordered by (text, item)
+
+	// m_Sorted cut into blocks of BlockSize with each block's items in ascending order. Answers "lowest item >= Start
+	// within a sorted range" without walking the whole range.
+	std::vector<uint32_t> m_BlockItems;
+
+	mutable bool m_TrigramsBuilt = false;
+	mutable std::vector<uint32_t> m_TrigramKeys;
+	mutable std::vector<uint32_t> m_TrigramOffsets;
+	mutable std::vector<uint32_t> m_TrigramItems;
+
+public:
+	void Clear();
+	void Add(const char *String, size_t Length);
+	void Finalize();
+
+	uint32_t Count() const;
+	std::string_view GetLowered(uint32_t Item) const;
+
+	uint32_t FindPrefix(const char *Prefix, size_t Length, uint32_t Start = 0) const;
+	uint32_t FindExact(const char *String, size_t Length, uint32_t Start = 0) const;
+	uint32_t FindSubstring(const char *String, size_t Length, uint32_t Start = 0) const;
+
+	static char Fold(char C);
+
+private:
+	static std::string Lower(const char *String, size_t Length);
+	uint32_t LowestInRange(size_t First, size_t Last, uint32_t Start) const;
+	void BuildTrigrams() const;
+};
\ No newline at end of file
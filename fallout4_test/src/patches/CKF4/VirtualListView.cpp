@@ -0,0 +1,456 @@
+#include "../../common.h"
+#include <CommCtrl.h>
+#include "VirtualListView.h"
+
+namespace VirtualListView
+{
+	struct ListState
+	{
+		ListRowModel Rows;
+		bool RedrawSuspended = false;	// WM_SETREDRAW FALSE is in effect
+		bool CountDirty = false;		// Rows were added without telling the control
+	};
+
+	bool Enabled;
+
+	void Initialize(bool Enable)
+	{
+		Enabled = Enable;
+	}
+
+	bool IsEnabled()
+	{
+		return Enabled;
+	}
+
+	ListState *GetState(HWND ListViewHandle)
+	{
+		DWORD_PTR refData = 0;
+
+		if (!ListViewHandle || !GetWindowSubclass(ListViewHandle, ListViewSubclass, 0, &refData))
+			return nullptr;
+
+		return (ListState *)refData;
+	}
+
+	ListRowModel *GetRows(HWND ListViewHandle)
+	{
+		if (auto state = GetState(ListViewHandle); state)
+			return &state->Rows;
+
+		return nullptr;
+	}
+
+	HWND Convert(HWND DialogHwnd, int ControlId)
+	{
+		HWND oldHandle = GetDlgItem(DialogHwnd, ControlId);
+
+		if (!Enabled || !oldHandle)
+			return oldHandle;
+
+		// Owner data lists can't sort themselves and the style can't be toggled after creation
+		const DWORD style = (DWORD)GetWindowLongPtrA(oldHandle, GWL_STYLE);
+		const DWORD exStyle = (DWORD)GetWindowLongPtrA(oldHandle, GWL_EXSTYLE);
+
+		if (style & (LVS_OWNERDATA | LVS_SORTASCENDING | LVS_SORTDESCENDING))
+			return oldHandle;
+
+		RECT rect;
+		GetWindowRect(oldHandle, &rect);
+		MapWindowPoints(HWND_DESKTOP, DialogHwnd, (POINT *)&rect, 2);
+
+		HWND newHandle = CreateWindowExA(exStyle, WC_LISTVIEWA, nullptr, style | LVS_OWNERDATA,
+			rect.left, rect.top, rect.right - rect.left, rect.bottom - rect.top,
+			DialogHwnd, (HMENU)(INT_PTR)ControlId, (HINSTANCE)GetWindowLongPtrA(oldHandle, GWLP_HINSTANCE), nullptr);
+
+		if (!newHandle)
+			return oldHandle;
+
+		SendMessageA(newHandle, WM_SETFONT, SendMessageA(oldHandle, WM_GETFONT, 0, 0), FALSE);
+		ListView_SetExtendedListViewStyle(newHandle, ListView_GetExtendedListViewStyle(oldHandle));
+
+		// Take the old control's place in the tab order before it goes away
+		SetWindowPos(newHandle, oldHandle, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE | SWP_NOACTIVATE);
+		DestroyWindow(oldHandle);
+
+		SetWindowSubclass(newHandle, ListViewSubclass, 0, (DWORD_PTR)new ListState());
+		return newHandle;
+	}
+
+	void Refresh(HWND ListViewHandle)
+	{
+		auto rows = GetRows(ListViewHandle);
+
+		if (!rows)
+			return;
+
+		SendMessageA(ListViewHandle, LVM_SETITEMCOUNT, rows->Count(), LVSICF_NOSCROLL);
+		InvalidateRect(ListViewHandle, nullptr, TRUE);
+	}
+
+	bool FindItemByText(HWND ListViewHandle, ListRowModel& Rows, const NMLVFINDITEMA *Find, LRESULT *Result)
+	{
+		const auto& info = Find->lvfi;
+
+		if (!(info.flags & (LVFI_STRING | LVFI_PARTIAL)) || !info.psz)
+			return false;
+
+		const size_t length = strlen(info.psz);
+		const uint32_t count = Rows.Count();
+		const uint32_t start = (Find->iStart >= 0) ? (uint32_t)Find->iStart : 0;
+
+		// Text only exists in the parent's LVN_GETDISPINFO handler, so ask the control for it row by row like a
+		// regular list would when typing to search
+		for (uint32_t pass = 0; pass < 2; pass++)
+		{
+			const uint32_t first = (pass == 0) ? start : 0;
+			const uint32_t last = (pass == 0) ? count : std::min(start, count);
+
+			for (uint32_t i = first; i < last; i++)
+			{
+				char text[256] = {};
+				ListView_GetItemText(ListViewHandle, i, 0, text, ARRAYSIZE(text));
+
+				bool match = (info.flags & LVFI_PARTIAL) ? !_strnicmp(text, info.psz, length) : !_stricmp(text, info.psz);
+
+				if (match)
+				{
+					*Result = i;
+					return true;
+				}
+			}
+
+			if (!(info.flags & LVFI_WRAP))
+				break;
+		}
+
+		*Result = -1;
+		return true;
+	}
+
+	bool TranslateNotification(NMHDR *Header, LRESULT *Result)
+	{
+		auto state = GetState(Header->hwndFrom);
+
+		if (!state)
+			return false;
+
+		auto& rows = state->Rows;
+		auto itemParam = [&rows](int Index) -> LPARAM
+		{
+			return (Index >= 0) ? (LPARAM)rows.At(Index) : 0;
+		};
+
+		// Owner data lists send a zero lParam everywhere. The editor's handlers expect the form pointer a regular list
+		// would have stored, so fill it in before they run.
+		switch (Header->code)
+		{
+		case LVN_GETDISPINFOA:
+		case LVN_GETDISPINFOW:
+		case LVN_BEGINLABELEDITA:
+		case LVN_BEGINLABELEDITW:
+		case LVN_ENDLABELEDITA:
+		case LVN_ENDLABELEDITW:
+		{
+			// A nonzero lParam came from someone asking the editor about a specific row directly
+			auto info = (NMLVDISPINFOA *)Header;
+
+			if (!info->item.lParam)
+				info->item.lParam = itemParam(info->item.iItem);
+		}
+		break;
+
+		case LVN_ITEMCHANGING:
+		case LVN_ITEMCHANGED:
+		case LVN_BEGINDRAG:
+		case LVN_BEGINRDRAG:
+		{
+			auto info = (NMLISTVIEW *)Header;
+			info->lParam = itemParam(info->iItem);
+		}
+		break;
+
+		case NM_CLICK:
+		case NM_DBLCLK:
+		case NM_RCLICK:
+		case NM_RDBLCLK:
+		case LVN_ITEMACTIVATE:
+		{
+			auto info = (NMITEMACTIVATE *)Header;
+			info->lParam = itemParam(info->iItem);
+		}
+		break;
+
+		case LVN_GETINFOTIPA:
+		case LVN_GETINFOTIPW:
+		{
+			auto info = (NMLVGETINFOTIPA *)Header;
+			info->lParam = itemParam(info->iItem);
+		}
+		break;
+
+		case NM_CUSTOMDRAW:
+		{
+			auto info = (NMLVCUSTOMDRAW *)Header;
+
+			if (info->nmcd.dwDrawStage & CDDS_ITEM)
+				info->nmcd.lItemlParam = itemParam((int)info->nmcd.dwItemSpec);
+		}
+		break;
+
+		case LVN_ODFINDITEMA:
+			return FindItemByText(Header->hwndFrom, rows, (NMLVFINDITEMA *)Header, Result);
+		}
+
+		return false;
+	}
+
+	LRESULT SendItemNotification(HWND ListViewHandle, UINT Code, int Index, ListRowModel::Row Value)
+	{
+		NMLISTVIEW info = {};
+		info.hdr.hwndFrom = ListViewHandle;
+		info.hdr.idFrom = GetDlgCtrlID(ListViewHandle);
+		info.hdr.code = Code;
+		info.iItem = Index;
+		info.lParam = (LPARAM)Value;
+
+		return SendMessageA(GetParent(ListViewHandle), WM_NOTIFY, info.hdr.idFrom, (LPARAM)&info);
+	}
+
+	void SyncItemCount(HWND ListViewHandle, ListState *State)
+	{
+		State->CountDirty = false;
+		DefSubclassProc(ListViewHandle, LVM_SETITEMCOUNT, State->Rows.Count(), LVSICF_NOSCROLL);
+	}
+
+	template<typename Func>
+	void PreserveSelection(HWND ListViewHandle, ListState *State, Func&& Mutate)
+	{
+		// Selection is tracked by index in owner data mode, so it has to follow rows that move
+		std::vector<ListRowModel::Row> selected;
+
+		for (int i = -1; (i = (int)DefSubclassProc(ListViewHandle, LVM_GETNEXTITEM, i, LVNI_SELECTED)) != -1;)
+			selected.push_back(State->Rows.At(i));
+
+		Mutate();
+		SyncItemCount(ListViewHandle, State);
+
+		if (selected.empty())
+			return;
+
+		LVITEMA item = {};
+		item.stateMask = LVIS_SELECTED;
+		item.state = 0;
+		DefSubclassProc(ListViewHandle, LVM_SETITEMSTATE, (WPARAM)-1, (LPARAM)&item);
+
+		item.state = LVIS_SELECTED;
+
+		for (auto value : selected)
+		{
+			if (uint32_t index = State->Rows.Find(value); index != ListRowModel::npos)
+				DefSubclassProc(ListViewHandle, LVM_SETITEMSTATE, index, (LPARAM)&item);
+		}
+	}
+
+	LRESULT CALLBACK ListViewSubclass(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam, UINT_PTR uIdSubclass, DWORD_PTR dwRefData)
+	{
+		auto state = (ListState *)dwRefData;
+		auto& rows = state->Rows;
+
+		switch (uMsg)
+		{
+		case WM_NCDESTROY:
+			RemoveWindowSubclass(hWnd, ListViewSubclass, uIdSubclass);
+			delete state;
+			return DefSubclassProc(hWnd, uMsg, wParam, lParam);
+
+		case WM_SETREDRAW:
+			state->RedrawSuspended = !wParam;
+
+			if (wParam && state->CountDirty)
+				SyncItemCount(hWnd, state);
+			break;
+
+		case LVM_INSERTITEMA:
+		case LVM_INSERTITEMW:
+		{
+			// A/W layouts only differ in the text pointer type
+			auto item = (const LVITEMA *)lParam;
+			auto value = (ListRowModel::Row)((item->mask & LVIF_PARAM) ? item->lParam : 0);
+			uint32_t index = ListRowModel::npos;
+
+			if (item->iItem >= 0 && (uint32_t)item->iItem < rows.Count())
+			{
+				PreserveSelection(hWnd, state, [&]()
+				{
+					index = rows.Insert(item->iItem, value);
+				});
+			}
+			else
+			{
+				// Appends are batched while redraw is off. The control learns the new count once it's turned back on.
+				index = rows.Insert(ListRowModel::npos, value);
+				state->CountDirty = true;
+
+				if (!state->RedrawSuspended)
+					SyncItemCount(hWnd, state);
+			}
+
+			return (index != ListRowModel::npos) ? (LRESULT)index : -1;
+		}
+
+		case LVM_DELETEITEM:
+		{
+			if (wParam >= rows.Count())
+				return FALSE;
+
+			SendItemNotification(hWnd, LVN_DELETEITEM, (int)wParam, rows.At((uint32_t)wParam));
+			rows.Remove((uint32_t)wParam);
+
+			if (state->CountDirty)
+				return TRUE;
+
+			// Lets the control shift its selection down, then make sure the count agrees either way
+			DefSubclassProc(hWnd, uMsg, wParam, lParam);
+
+			if ((uint32_t)DefSubclassProc(hWnd, LVM_GETITEMCOUNT, 0, 0) != rows.Count())
+				SyncItemCount(hWnd, state);
+
+			return TRUE;
+		}
+
+		case LVM_DELETEALLITEMS:
+		{
+			// Same notifications as a regular list: per-item ones only if the parent didn't decline them
+			if (!SendItemNotification(hWnd, LVN_DELETEALLITEMS, -1, nullptr))
+			{
+				for (uint32_t i = 0; i < rows.Count(); i++)
+					SendItemNotification(hWnd, LVN_DELETEITEM, i, rows.At(i));
+			}
+
+			rows.Clear();
+			SyncItemCount(hWnd, state);
+			return TRUE;
+		}
+
+		case LVM_GETITEMA:
+		case LVM_GETITEMW:
+		{
+			auto item = (LVITEMA *)lParam;
+
+			if (item->iItem < 0 || (uint32_t)item->iItem >= rows.Count())
+				return FALSE;
+
+			if (state->CountDirty)
+				SyncItemCount(hWnd, state);
+
+			const UINT mask = item->mask;
+			LRESULT result = TRUE;
+
+			if (mask & ~LVIF_PARAM)
+			{
+				item->mask &= ~LVIF_PARAM;
+				result = DefSubclassProc(hWnd, uMsg, wParam, lParam);
+				item->mask = mask;
+			}
+
+			if (mask & LVIF_PARAM)
+				item->lParam = (LPARAM)rows.At(item->iItem);
+
+			return result;
+		}
+
+		case LVM_SETITEMA:
+		case LVM_SETITEMW:
+		{
+			auto item = (LVITEMA *)lParam;
+
+			if (item->iItem < 0 || (uint32_t)item->iItem >= rows.Count())
+				return FALSE;
+
+			if (state->CountDirty)
+				SyncItemCount(hWnd, state);
+
+			const UINT mask = item->mask;
+			LRESULT result = TRUE;
+
+			if ((mask & LVIF_PARAM) && item->iSubItem == 0)
+				rows.Set(item->iItem, (ListRowModel::Row)item->lParam);
+
+			if (mask & ~LVIF_PARAM)
+			{
+				item->mask &= ~LVIF_PARAM;
+				result = DefSubclassProc(hWnd, uMsg, wParam, lParam);
+				item->mask = mask;
+			}
+
+			return result;
+		}
+
+		case LVM_FINDITEMA:
+		case LVM_FINDITEMW:
+		{
+			auto info = (const LVFINDINFOA *)lParam;
+
+			// Text searches go to the parent through LVN_ODFINDITEM
+			if (!(info->flags & LVFI_PARAM))
+				break;
+
+			const auto value = (ListRowModel::Row)info->lParam;
+			const uint32_t start = ((int)wParam < 0) ? 0 : (uint32_t)wParam + 1;
+			uint32_t index = rows.Find(value, start);
+
+			if (index == ListRowModel::npos && (info->flags & LVFI_WRAP))
+				index = rows.Find(value, 0);
+
+			return (index != ListRowModel::npos) ? (LRESULT)index : -1;
+		}
+
+		case LVM_SORTITEMS:
+		{
+			auto compare = (PFNLVCOMPARE)lParam;
+
+			PreserveSelection(hWnd, state, [&]()
+			{
+				rows.Sort([&](ListRowModel::Row A, ListRowModel::Row B)
+				{
+					return compare((LPARAM)A, (LPARAM)B, (LPARAM)wParam) < 0;
+				});
+			});
+
+			InvalidateRect(hWnd, nullptr, TRUE);
+			return TRUE;
+		}
+
+		case LVM_SORTITEMSEX:
+		{
+			auto compare = (PFNLVCOMPARE)lParam;
+
+			PreserveSelection(hWnd, state, [&]()
+			{
+				// The callback takes list indices. Rows hidden by a filter have none, so they sink to the end.
+				rows.SortRows([&](uint32_t A, uint32_t B)
+				{
+					const uint32_t visibleA = rows.VisibleIndex(A);
+					const uint32_t visibleB = rows.VisibleIndex(B);
+
+					if (visibleA == ListRowModel::npos || visibleB == ListRowModel::npos)
+						return visibleA != ListRowModel::npos && visibleB == ListRowModel::npos;
+
+					return compare(visibleA, visibleB, (LPARAM)wParam) < 0;
+				});
+			});
+
+			InvalidateRect(hWnd, nullptr, TRUE);
+			return TRUE;
+		}
+
+		default:
+			if (uMsg >= LVM_FIRST && uMsg < LVM_FIRST + 0x100 && state->CountDirty)
+				SyncItemCount(hWnd, state);
+			break;
+		}
+
+		return DefSubclassProc(hWnd, uMsg, wParam, lParam);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "../../common.h"
+#include <CommCtrl.h>
+#include "ListRowModel.h"
+
+namespace VirtualListView
+{
+	void Initialize(bool Enable);
+	bool IsEnabled();
+
+	HWND Convert(HWND DialogHwnd, int ControlId);
+	ListRowModel *GetRows(HWND ListViewHandle);
+	void Refresh(HWND ListViewHandle);
+
+	bool TranslateNotification(NMHDR *Header, LRESULT *Result);
+	LRESULT CALLBACK ListViewSubclass(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam, UINT_PTR uIdSubclass, DWORD_PTR dwRefData);
+}
\ No newline at end of file
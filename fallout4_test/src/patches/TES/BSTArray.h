@@ -1,6 +1,13 @@
 #pragma once
 
 #include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <initializer_list>
+#include <type_traits>
+#include <vector>
+#include "BSTArrayKernels.h"
+#include "MemoryManager.h"
 
 class BSTArrayHeapAllocator
 {
@@ -24,6 +31,33 @@ public:
 	{
 		return m_AllocSize;
 	}
+
+protected:
+	//
+	// m_AllocSize counts elements. Buffers go through the same MemoryManager entry points the engine is redirected to by
+	// MemoryPatch, so arrays built here and arrays built by the engine can free each other's memory. Without MemoryPatch
+	// the engine's own heap owns its buffers and they can't be touched from here.
+	//
+	void Reallocate(uint32_t NewCapacity, uint32_t UsedCount, size_t ElementSize)
+	{
+		AssertMsg(g_EngineHeapPatched, "Resizing a BSTArray requires MemoryPatch to be enabled");
+
+		void *newBuffer = nullptr;
+
+		if (NewCapacity > 0)
+		{
+			newBuffer = MemoryManager::Allocate(nullptr, NewCapacity * ElementSize, 0, false);
+
+			if (m_Buffer && UsedCount > 0)
+				memcpy(newBuffer, m_Buffer, UsedCount * ElementSize);
+		}
+
+		if (m_Buffer)
+			MemoryManager::Deallocate(nullptr, m_Buffer, false);
+
+		m_Buffer = newBuffer;
+		m_AllocSize = NewCapacity;
+	}
 };
 
 class BSTArrayBase
@@ -47,8 +81,19 @@ public:
 	{
 		return m_Size == 0;
 	}
+
+protected:
+	void SetSize(uint32_t Size)
+	{
+		m_Size = Size;
+	}
 };
 
+//
+// Same layout as the engine's array, so engine arrays can be read and modified in place. There's no destructor and
+// copies share the buffer: instances must be engine owned (members of engine objects, which free the buffer). An array
+// built locally leaks unless it's emptied with clear() and shrink_to_fit() before it goes out of scope.
+//
 template <class _Ty, class _Alloc = BSTArrayHeapAllocator>
 class BSTArray : public _Alloc, public BSTArrayBase
 {
@@ -109,15 +154,163 @@ public:
 		return (this->_Mylast()[-1]);
 	}
 
+	//
+	// Vectorized queries, see BSTArrayKernels. Indices are returned as npos when nothing matches.
+	//
+	static constexpr size_type npos = 0xFFFFFFFF;
+
+	size_type find(const _Ty& Value, size_type Start = 0) const
+	{
+		if (Start >= QSize())
+			return npos;
+
+		return BSTArrayKernels::Find(this->_Myfirst(), Start, QSize(), Value);
+	}
+
+	size_type find_last(const _Ty& Value) const
+	{
+		return BSTArrayKernels::FindLast(this->_Myfirst(), QSize(), Value);
+	}
+
+	size_type count(const _Ty& Value) const
+	{
+		return BSTArrayKernels::Count(this->_Myfirst(), QSize(), Value);
+	}
+
+	bool contains_any(const _Ty *Values, size_type ValueCount) const
+	{
+		return BSTArrayKernels::ContainsAny(this->_Myfirst(), QSize(), Values, ValueCount);
+	}
+
+	bool contains_any(std::initializer_list<_Ty> Values) const
+	{
+		return contains_any(Values.begin(), (size_type)Values.size());
+	}
+
+	// Plain std::vector, so callers don't need MemoryPatch or have to free the result themselves
+	std::vector<size_type> find_all(const _Ty& Value) const
+	{
+		std::vector<size_type> indices;
+
+		for (size_type i = find(Value); i != npos; i = find(Value, i + 1))
+			indices.push_back(i);
+
+		return indices;
+	}
+
+	//
+	// Modification. Elements are relocated with memcpy, so only trivially copyable types are supported.
+	//
+	void reserve(size_type Count)
+	{
+		if (Count > this->QAllocSize())
+			Relocate(Count);
+	}
+
+	void push_back(const _Ty& Value)
+	{
+		// Value may live in the buffer that's about to move
+		const _Ty copy = Value;
+
+		Grow(QSize() + 1);
+		this->_Myfirst()[QSize()] = copy;
+		SetSize(QSize() + 1);
+	}
+
+	void append_range(const _Ty *Values, size_type Count)
+	{
+		if (Count == 0)
+			return;
+
+		// Appending a slice of this array must survive reallocation
+		const _Ty *oldFirst = this->_Myfirst();
+		const bool aliased = Values >= oldFirst && Values < oldFirst + QSize();
+		const size_t aliasOffset = aliased ? (Values - oldFirst) : 0;
+
+		Grow(QSize() + Count);
+
+		if (aliased)
+			Values = this->_Myfirst() + aliasOffset;
+
+		memcpy(this->_Myfirst() + QSize(), Values, Count * sizeof(_Ty));
+		SetSize(QSize() + Count);
+	}
+
+	void append_range(std::initializer_list<_Ty> Values)
+	{
+		append_range(Values.begin(), (size_type)Values.size());
+	}
+
+	template<typename Predicate>
+	size_type erase_if(Predicate Pred)
+	{
+		// Single pass, survivors are shifted down in order
+		_Ty *data = this->_Myfirst();
+		size_type kept = 0;
+
+		for (size_type i = 0; i < QSize(); i++)
+		{
+			if (Pred(data[i]))
+				continue;
+
+			if (kept != i)
+				data[kept] = data[i];
+
+			kept++;
+		}
+
+		const size_type removed = QSize() - kept;
+		SetSize(kept);
+
+		return removed;
+	}
+
+	void clear()
+	{
+		SetSize(0);
+	}
+
+	void shrink_to_fit()
+	{
+		if (this->QAllocSize() > QSize())
+			Relocate(QSize());
+	}
+
 private:
+	void Relocate(size_type NewCapacity)
+	{
+		static_assert(std::is_trivially_copyable_v<_Ty>, "Elements are moved with memcpy");
+
+		this->Reallocate(NewCapacity, QSize(), sizeof(_Ty));
+	}
+
+	void Grow(size_type RequiredCount)
+	{
+		AssertMsg(RequiredCount >= QSize(), "Array size overflowed");
+
+		// Geometric growth keeps repeated appends amortized O(1)
+		if (RequiredCount > this->QAllocSize())
+			Relocate(std::max<size_type>({ RequiredCount, this->QAllocSize() * 2, 4 }));
+	}
+
 	_Ty *_Myfirst()
 	{
-		return (_Ty *)QBuffer();
+		return (_Ty *)this->QBuffer();
+	}
+
+	const _Ty *_Myfirst() const
+	{
+		return (const _Ty *)this->QBuffer();
 	}
 
 	_Ty *_Mylast()
 	{
-		return ((_Ty *)QBuffer()) + QSize();
+		return ((_Ty *)this->QBuffer()) + QSize();
+	}
+
+	const _Ty *_Mylast() const
+	{
+		return ((const _Ty *)this->QBuffer()) + QSize();
 	}
 };
 
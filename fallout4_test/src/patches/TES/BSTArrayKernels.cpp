@@ -0,0 +1,376 @@
+#include <stdint.h>
+#include <algorithm>
+#include <bit>
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include "BSTArrayKernels.h"
+
+namespace BSTArrayKernels
+{
+#ifdef _MSC_VER
+	ISA DetectISA()
+	{
+		int cpuinfo[4];
+		__cpuid(cpuinfo, 0);
+		const int maxLeaf = cpuinfo[0];
+
+		__cpuid(cpuinfo, 1);
+		const bool hasSSE41 = (cpuinfo[2] & (1 << 19)) != 0;
+
+		// AVX state must also be enabled by the OS (OSXSAVE, then XMM/YMM and opmask/ZMM bits in XCR0)
+		const uint64_t xcr0 = ((cpuinfo[2] & (1 << 27)) != 0) ? _xgetbv(0) : 0;
+		const bool osAVX = (xcr0 & 0x6) == 0x6;
+		const bool osAVX512 = (xcr0 & 0xE6) == 0xE6;
+
+		if (maxLeaf >= 7)
+		{
+			__cpuidex(cpuinfo, 7, 0);
+
+			if (osAVX512 && (cpuinfo[1] & (1 << 16)) != 0)
+				return ISA::AVX512;
+
+			if (osAVX && (cpuinfo[1] & (1 << 5)) != 0)
+				return ISA::AVX2;
+		}
+
+		return hasSSE41 ? ISA::SSE41 : ISA::Scalar;
+	}
+#else
+	ISA DetectISA()
+	{
+		// Only used by the standalone tests. The builtins check the OS saved register state too.
+		if (__builtin_cpu_supports("avx512f"))
+			return ISA::AVX512;
+
+		if (__builtin_cpu_supports("avx2"))
+			return ISA::AVX2;
+
+		return __builtin_cpu_supports("sse4.1") ? ISA::SSE41 : ISA::Scalar;
+	}
+#endif
+
+	const ISA g_DetectedISA = DetectISA();
+	ISA g_ISA = g_DetectedISA;
+
+	ISA GetISA()
+	{
+		return g_ISA;
+	}
+
+	ISA SetISA(ISA Level)
+	{
+		const ISA previous = g_ISA;
+		g_ISA = std::min(Level, g_DetectedISA);
+		return previous;
+	}
+
+	//
+	// A block compares Width consecutive elements against a broadcast value and returns one bit per match
+	//
+	template<typename E, ISA Level>
+	struct Block;
+
+	template<typename E>
+	struct Block<E, ISA::Scalar>
+	{
+		using Vector = E;
+		static constexpr uint32_t Width = 1;
+
+		static Vector Broadcast(E Value)
+		{
+			return Value;
+		}
+
+		static uint32_t Match(const E *Data, Vector Target)
+		{
+			return *Data == Target;
+		}
+	};
+
+	template<>
+	struct Block<uint32_t, ISA::SSE41>
+	{
+		using Vector = __m128i;
+		static constexpr uint32_t Width = 4;
+
+		static Vector Broadcast(uint32_t Value)
+		{
+			return _mm_set1_epi32((int)Value);
+		}
+
+		static uint32_t Match(const uint32_t *Data, Vector Target)
+		{
+			return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(Target, _mm_loadu_si128((const __m128i *)Data))));
+		}
+	};
+
+	template<>
+	struct Block<uint64_t, ISA::SSE41>
+	{
+		using Vector = __m128i;
+		static constexpr uint32_t Width = 2;
+
+		static Vector Broadcast(uint64_t Value)
+		{
+			return _mm_set1_epi64x((long long)Value);
+		}
+
+		static uint32_t Match(const uint64_t *Data, Vector Target)
+		{
+			return _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(Target, _mm_loadu_si128((const __m128i *)Data))));
+		}
+	};
+
+	template<>
+	struct Block<uint32_t, ISA::AVX2>
+	{
+		using Vector = __m256i;
+		static constexpr uint32_t Width = 8;
+
+		static Vector Broadcast(uint32_t Value)
+		{
+			return _mm256_set1_epi32((int)Value);
+		}
+
+		static uint32_t Match(const uint32_t *Data, Vector Target)
+		{
+			return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(Target, _mm256_loadu_si256((const __m256i *)Data))));
+		}
+	};
+
+	template<>
+	struct Block<uint64_t, ISA::AVX2>
+	{
+		using Vector = __m256i;
+		static constexpr uint32_t Width = 4;
+
+		static Vector Broadcast(uint64_t Value)
+		{
+			return _mm256_set1_epi64x((long long)Value);
+		}
+
+		static uint32_t Match(const uint64_t *Data, Vector Target)
+		{
+			return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(Target, _mm256_loadu_si256((const __m256i *)Data))));
+		}
+	};
+
+	template<>
+	struct Block<uint32_t, ISA::AVX512>
+	{
+		using Vector = __m512i;
+		static constexpr uint32_t Width = 16;
+
+		static Vector Broadcast(uint32_t Value)
+		{
+			return _mm512_set1_epi32((int)Value);
+		}
+
+		static uint32_t Match(const uint32_t *Data, Vector Target)
+		{
+			return _mm512_cmpeq_epi32_mask(Target, _mm512_loadu_si512(Data));
+		}
+	};
+
+	template<>
+	struct Block<uint64_t, ISA::AVX512>
+	{
+		using Vector = __m512i;
+		static constexpr uint32_t Width = 8;
+
+		static Vector Broadcast(uint64_t Value)
+		{
+			return _mm512_set1_epi64((long long)Value);
+		}
+
+		static uint32_t Match(const uint64_t *Data, Vector Target)
+		{
+			return _mm512_cmpeq_epi64_mask(Target, _mm512_loadu_si512(Data));
+		}
+	};
+
+	uint32_t LowestBit(uint64_t Mask)
+	{
+		return std::countr_zero(Mask);
+	}
+
+	uint32_t HighestBit(uint64_t Mask)
+	{
+		return 63 - std::countl_zero(Mask);
+	}
+
+	uint32_t BitCount(uint32_t Mask)
+	{
+		// Masks are at most 16 bits wide, and POPCNT isn't guaranteed with SSE4.1
+		uint32_t count = 0;
+
+		for (; Mask; Mask &= Mask - 1)
+			count++;
+
+		return count;
+	}
+
+	template<typename E, typename B>
+	uint32_t FindImpl(const E *Data, uint32_t Start, uint32_t End, E Value)
+	{
+		const auto target = B::Broadcast(Value);
+		uint32_t i = Start;
+
+		// Four blocks per iteration with the masks merged, so there's a single branch per loop
+		for (; i + 4 * B::Width <= End; i += 4 * B::Width)
+		{
+			const uint64_t mask =
+				((uint64_t)B::Match(&Data[i + 0 * B::Width], target) << (0 * B::Width)) |
+				((uint64_t)B::Match(&Data[i + 1 * B::Width], target) << (1 * B::Width)) |
+				((uint64_t)B::Match(&Data[i + 2 * B::Width], target) << (2 * B::Width)) |
+				((uint64_t)B::Match(&Data[i + 3 * B::Width], target) << (3 * B::Width));
+
+			if (mask)
+				return i + LowestBit(mask);
+		}
+
+		for (; i + B::Width <= End; i += B::Width)
+		{
+			if (uint32_t mask = B::Match(&Data[i], target))
+				return i + LowestBit(mask);
+		}
+
+		for (; i < End; i++)
+		{
+			if (Data[i] == Value)
+				return i;
+		}
+
+		return 0xFFFFFFFF;
+	}
+
+	template<typename E, typename B>
+	uint32_t FindLastImpl(const E *Data, uint32_t End, E Value)
+	{
+		const auto target = B::Broadcast(Value);
+		uint32_t i = End;
+
+		for (; i >= B::Width; i -= B::Width)
+		{
+			if (uint32_t mask = B::Match(&Data[i - B::Width], target))
+				return i - B::Width + HighestBit(mask);
+		}
+
+		while (i-- > 0)
+		{
+			if (Data[i] == Value)
+				return i;
+		}
+
+		return 0xFFFFFFFF;
+	}
+
+	template<typename E, typename B>
+	uint32_t CountImpl(const E *Data, uint32_t End, E Value)
+	{
+		const auto target = B::Broadcast(Value);
+		uint32_t count = 0;
+		uint32_t i = 0;
+
+		for (; i + B::Width <= End; i += B::Width)
+			count += BitCount(B::Match(&Data[i], target));
+
+		for (; i < End; i++)
+			count += (Data[i] == Value) ? 1 : 0;
+
+		return count;
+	}
+
+	template<typename E, typename B>
+	bool ContainsAnyImpl(const E *Data, uint32_t End, const E *Values, uint32_t ValueCount)
+	{
+		// Values are checked in groups so each block of data is loaded once per group
+		constexpr uint32_t GroupSize = 8;
+
+		for (uint32_t group = 0; group < ValueCount; group += GroupSize)
+		{
+			const uint32_t groupCount = std::min(GroupSize, ValueCount - group);
+			typename B::Vector targets[GroupSize];
+
+			for (uint32_t j = 0; j < groupCount; j++)
+				targets[j] = B::Broadcast(Values[group + j]);
+
+			uint32_t i = 0;
+
+			for (; i + B::Width <= End; i += B::Width)
+			{
+				uint32_t mask = 0;
+
+				for (uint32_t j = 0; j < groupCount; j++)
+					mask |= B::Match(&Data[i], targets[j]);
+
+				if (mask)
+					return true;
+			}
+
+			for (; i < End; i++)
+			{
+				for (uint32_t j = 0; j < groupCount; j++)
+				{
+					if (Data[i] == Values[group + j])
+						return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+#define BSTARRAY_KERNEL_DISPATCH(Function, E, ...) \
+	switch (g_ISA) \
+	{ \
+	case ISA::AVX512: return Function<E, Block<E, ISA::AVX512>>(__VA_ARGS__); \
+	case ISA::AVX2: return Function<E, Block<E, ISA::AVX2>>(__VA_ARGS__); \
+	case ISA::SSE41: return Function<E, Block<E, ISA::SSE41>>(__VA_ARGS__); \
+	default: return Function<E, Block<E, ISA::Scalar>>(__VA_ARGS__); \
+	}
+
+	uint32_t Find32(const uint32_t *Data, uint32_t Start, uint32_t End, uint32_t Value)
+	{
+		BSTARRAY_KERNEL_DISPATCH(FindImpl, uint32_t, Data, Start, End, Value);
+	}
+
+	uint32_t Find64(const uint64_t *Data, uint32_t Start, uint32_t End, uint64_t Value)
+	{
+		BSTARRAY_KERNEL_DISPATCH(FindImpl, uint64_t, Data, Start, End, Value);
+	}
+
+	uint32_t FindLast32(const uint32_t *Data, uint32_t End, uint32_t Value)
+	{
+		BSTARRAY_KERNEL_DISPATCH(FindLastImpl, uint32_t, Data, End, Value);
+	}
+
+	uint32_t FindLast64(const uint64_t *Data, uint32_t End, uint64_t Value)
+	{
+		BSTARRAY_KERNEL_DISPATCH(FindLastImpl, uint64_t, Data, End, Value);
+	}
+
+	uint32_t Count32(const uint32_t *Data, uint32_t End, uint32_t Value)
+	{
+		BSTARRAY_KERNEL_DISPATCH(CountImpl, uint32_t, Data, End, Value);
+	}
+
+	uint32_t Count64(const uint64_t *Data, uint32_t End, uint64_t Value)
+	{
+		BSTARRAY_KERNEL_DISPATCH(CountImpl, uint64_t, Data, End, Value);
+	}
+
+	bool ContainsAny32(const uint32_t *Data, uint32_t End, const uint32_t *Values, uint32_t ValueCount)
+	{
+		BSTARRAY_KERNEL_DISPATCH(ContainsAnyImpl, uint32_t, Data, End, Values, ValueCount);
+	}
+
+	bool ContainsAny64(const uint64_t *Data, uint32_t End, const uint64_t *Values, uint32_t ValueCount)
+	{
+		BSTARRAY_KERNEL_DISPATCH(ContainsAnyImpl, uint64_t, Data, End, Values, ValueCount);
+	}
+
+#undef BSTARRAY_KERNEL_DISPATCH
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+//
+// Vectorized queries over flat arrays of 4 or 8 byte elements (form IDs, pointers, flags). The instruction set is
+// detected once and shared by everything that picks a SIMD path. Comparisons are bitwise, so only integral, enum and
+// pointer types are accepted. The kernels themselves live in BSTArrayKernels.cpp.
+//
+namespace BSTArrayKernels
+{
+	enum class ISA
+	{
+		Scalar,
+		SSE41,
+		AVX2,
+		AVX512,
+	};
+
+	ISA GetISA();
+
+	// Pins the kernels to a lower level so tests and benchmarks can compare them. Clamped to what the CPU supports,
+	// returns the previous level.
+	ISA SetISA(ISA Level);
+
+	uint32_t Find32(const uint32_t *Data, uint32_t Start, uint32_t End, uint32_t Value);
+	uint32_t Find64(const uint64_t *Data, uint32_t Start, uint32_t End, uint64_t Value);
+	uint32_t FindLast32(const uint32_t *Data, uint32_t End, uint32_t Value);
+	uint32_t FindLast64(const uint64_t *Data, uint32_t End, uint64_t Value);
+	uint32_t Count32(const uint32_t *Data, uint32_t End, uint32_t Value);
+	uint32_t Count64(const uint64_t *Data, uint32_t End, uint64_t Value);
+	bool ContainsAny32(const uint32_t *Data, uint32_t End, const uint32_t *Values, uint32_t ValueCount);
+	bool ContainsAny64(const uint64_t *Data, uint32_t End, const uint64_t *Values, uint32_t ValueCount);
+
+	template<typename T>
+	struct ElementBits
+	{
+		static_assert(std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>, "Only bitwise comparable types are supported");
+		static_assert(sizeof(T) == 4 || sizeof(T) == 8, "Only 4 and 8 byte elements are supported");
+
+		using Type = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+	};
+
+	template<typename T>
+	using Bits = typename ElementBits<T>::Type;
+
+	template<typename T>
+	Bits<T> ToBits(const T& Value)
+	{
+		Bits<T> bits;
+		memcpy(&bits, &Value, sizeof(T));
+		return bits;
+	}
+
+	template<typename T>
+	uint32_t Find(const T *Data, uint32_t Start, uint32_t End, const T& Value)
+	{
+		if constexpr (sizeof(T) == 4)
+			return Find32((const Bits<T> *)Data, Start, End, ToBits(Value));
+		else
+			return Find64((const Bits<T> *)Data, Start, End, ToBits(Value));
+	}
+
+	template<typename T>
+	uint32_t FindLast(const T *Data, uint32_t End, const T& Value)
+	{
+		if constexpr (sizeof(T) == 4)
+			return FindLast32((const Bits<T> *)Data, End, ToBits(Value));
+		else
+			return FindLast64((const Bits<T> *)Data, End, ToBits(Value));
+	}
+
+	template<typename T>
+	uint32_t Count(const T *Data, uint32_t End, const T& Value)
+	{
+		if constexpr (sizeof(T) == 4)
+			return Count32((const Bits<T> *)Data, End, ToBits(Value));
+		else
+			return Count64((const Bits<T> *)Data, End, ToBits(Value));
+	}
+
+	template<typename T>
+	bool ContainsAny(const T *Data, uint32_t End, const T *Values, uint32_t ValueCount)
+	{
+		if constexpr (sizeof(T) == 4)
+			return ContainsAny32((const Bits<T> *)Data, End, (const Bits<T> *)Values, ValueCount);
+		else
+			return ContainsAny64((const Bits<T> *)Data, End, (const Bits<T> *)Values, ValueCount);
+	}
+}
\ No newline at end of file
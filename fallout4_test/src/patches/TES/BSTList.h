@@ -1,5 +1,7 @@
 #pragma once
 
+#include <xmmintrin.h>
+
 template<typename T>
 class BSSimpleList
 {
@@ -94,4 +96,33 @@ public:
 	{
 		return m_pkNext;
 	}
+
+	//
+	// Walks the list starting at First. The next node's address is already in hand while the predicate runs on the
+	// current one, so it's prefetched then. Nodes further ahead can't be reached without loading this one's successor.
+	//
+	template<typename Predicate>
+	static const BSSimpleList<T> *FindIf(const BSSimpleList<T> *First, Predicate Pred)
+	{
+		for (const BSSimpleList<T> *node = First; node; node = node->m_pkNext)
+		{
+			if (node->m_pkNext)
+				_mm_prefetch((const char *)node->m_pkNext, _MM_HINT_T0);
+
+			if (Pred(node->m_item))
+				return node;
+		}
+
+		return nullptr;
+	}
+
+	template<typename Function>
+	static void ForEach(const BSSimpleList<T> *First, Function Func)
+	{
+		FindIf(First, [&Func](const T& Item)
+		{
+			Func(Item);
+			return false;
+		});
+	}
 };
\ No newline at end of file
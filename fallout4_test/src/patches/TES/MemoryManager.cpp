@@ -165,6 +165,8 @@ char *hk_strdup(const char *str1)
 //
 // Internal engine heap allocators backed by VirtualAlloc()
 //
+bool g_EngineHeapPatched;
+
 void *MemoryManager::Allocate(MemoryManager *Manager, size_t Size, uint32_t Alignment, bool Aligned)
 {
 	return MemAlloc(Size, Alignment, Aligned, true);
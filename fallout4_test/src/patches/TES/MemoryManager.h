@@ -12,6 +12,9 @@ public:
 	static size_t Size(MemoryManager *Manager, void *Memory);
 };
 
+// Set once MemoryPatch routes the engine's heap through MemoryManager
+extern bool g_EngineHeapPatched;
+
 class ScrapHeap
 {
 private:
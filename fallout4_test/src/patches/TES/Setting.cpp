@@ -1,4 +1,5 @@
 #include "../../common.h"
+#include "../fileio.h"
 #include "Setting.h"
 
 #if 0
@@ -254,7 +255,7 @@ bool INISettingCollection::hk_Open(bool OpenDuringRead)
 	// Cut down the number of GetPrivateProfileX calls by an order of magnitude. Normally the game checks
 	// an INI for every ESP/ESM, which then loops over every single INI variable.
 	//
-	if (GetFileAttributes(pSettingFile) != INVALID_FILE_ATTRIBUTES)
+	if (GetFileAttributesCached(pSettingFile) != INVALID_FILE_ATTRIBUTES)
 		pHandle = this;
 	else
 		pHandle = nullptr;
@@ -275,13 +276,12 @@ bool INISettingCollection::hk_Close()
 
 Setting *INISettingCollection::FindSetting(const char *Key) const
 {
-	for (auto *s = SettingsA.QNext(); s; s = s->QNext())
+	auto *s = BSSimpleList<Setting *>::FindIf(SettingsA.QNext(), [Key](Setting *S)
 	{
-		if (!_stricmp(Key, s->QItem()->pKey))
-			return s->QItem();
-	}
+		return !_stricmp(Key, S->pKey);
+	});
 
-	return nullptr;
+	return s ? s->QItem() : nullptr;
 }
 
 void INISettingCollection::DumpSettingIDAScript(FILE *File) const
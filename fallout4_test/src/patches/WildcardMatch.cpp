@@ -0,0 +1,99 @@
+#include <stdint.h>
+#include <vector>
+#include "WildcardMatch.h"
+
+namespace
+{
+	// Same characters ntifs.h uses, they can't appear in file names
+	constexpr wchar_t DOS_STAR = L'<';
+	constexpr wchar_t DOS_QM = L'>';
+	constexpr wchar_t DOS_DOT = L'"';
+}
+
+bool IsCacheableFindMask(const std::wstring& Mask)
+{
+	// Literal lookups, masks that already contain DOS wildcards, and masks ending in a dot ("*." lists names without an
+	// extension) are left to the OS
+	if (Mask.empty() || Mask.back() == L'.')
+		return false;
+
+	return Mask.find_first_of(L"*?") != std::wstring::npos && Mask.find_first_of(L"<>\"") == std::wstring::npos;
+}
+
+std::wstring TranslateFindMask(const std::wstring& Mask)
+{
+	if (Mask == L"*.*")
+		return L"*";
+
+	std::wstring expression(Mask);
+
+	for (size_t i = 0; i < expression.length(); i++)
+	{
+		const wchar_t next = (i + 1 < Mask.length()) ? Mask[i + 1] : L'\0';
+
+		if (Mask[i] == L'?')
+			expression[i] = DOS_QM;
+		else if (Mask[i] == L'*' && next == L'.')
+			expression[i] = DOS_STAR;
+		else if (Mask[i] == L'.' && (next == L'?' || next == L'*'))
+			expression[i] = DOS_DOT;
+	}
+
+	return expression;
+}
+
+bool WildcardMatch(const std::wstring& Expression, const std::wstring& Name)
+{
+	//
+	// matches[n] says whether the rest of the expression matches Name from n on. Rows are filled from the end of the
+	// expression backwards, each one only needs the row after it and the part of itself already computed.
+	//
+	const size_t nameLength = Name.length();
+	const size_t lastDot = Name.rfind(L'.');
+
+	std::vector<uint8_t> matches(nameLength + 1, 0);
+	std::vector<uint8_t> next(nameLength + 1, 0);
+	next[nameLength] = 1;
+
+	for (size_t e = Expression.length(); e-- > 0;)
+	{
+		const wchar_t c = Expression[e];
+
+		for (size_t n = nameLength + 1; n-- > 0;)
+		{
+			const bool atEnd = n == nameLength;
+			bool match;
+
+			switch (c)
+			{
+			case L'*':
+				match = next[n] || (!atEnd && matches[n + 1]);
+				break;
+
+			case DOS_STAR:
+				// Anything but the last dot, which has to be left for the rest of the expression
+				match = next[n] || (!atEnd && n != lastDot && matches[n + 1]);
+				break;
+
+			case DOS_QM:
+				// One character, or nothing at a dot or the end of the name
+				match = (atEnd || Name[n] == L'.') ? next[n] : next[n + 1];
+				break;
+
+			case DOS_DOT:
+				match = atEnd ? next[n] : (Name[n] == L'.' && next[n + 1]);
+				break;
+
+			default:
+				match = !atEnd && Name[n] == c && next[n + 1];
+				break;
+			}
+
+			matches[n] = match;
+		}
+
+		std::swap(matches, next);
+	}
+
+	return next[0] != 0;
+}
\ No newline at end of file
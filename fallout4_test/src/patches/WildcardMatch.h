@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+
+//
+// FindFirstFile mask matching, so cached directory listings answer the same way the file system would. Kernel32
+// rewrites masks into DOS wildcards before the file system sees them: "*.*" becomes "*", '?' matches one character or
+// nothing before a dot or the end, ".*" also matches a name without an extension, and "*." can't run past the last dot
+// in the name. Masks and names are compared as given, callers uppercase both.
+//
+bool IsCacheableFindMask(const std::wstring& Mask);
+std::wstring TranslateFindMask(const std::wstring& Mask);
+bool WildcardMatch(const std::wstring& Expression, const std::wstring& Name);
\ No newline at end of file
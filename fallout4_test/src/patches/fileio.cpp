@@ -1,19 +1,448 @@
 #include "../common.h"
 #include <tbb/concurrent_hash_map.h>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <string>
+#include <thread>
+#include "CKF4/InflatePipeline.h"
+#include "CKF4/LogWindow.h"
+#include "fileio.h"
+#include "WildcardMatch.h"
+
+//
+// Unbuffered streaming reader. Reads bypass the system cache (FILE_FLAG_NO_BUFFERING) and a ring of large aligned blocks
+// is kept filled ahead of the consumer with overlapped I/O. Cold loads of huge masters avoid the page cache thrash and
+// double copy that mapping causes.
+//
+class DirectStreamReader
+{
+private:
+	constexpr static uint32_t BlockSize = 4 * 1024 * 1024;	// Must stay a multiple of the sector size
+	constexpr static uint32_t BlockCount = 8;
+
+	struct Block
+	{
+		uint8_t *Data;
+		uint64_t Offset;
+		DWORD Length;
+		bool Pending;
+		OVERLAPPED Overlapped;
+	};
+
+	HANDLE m_Handle = INVALID_HANDLE_VALUE;
+	uint64_t m_FileLength = 0;
+	Block m_Blocks[BlockCount] = {};
+
+	Block& SlotFor(uint64_t Offset)
+	{
+		return m_Blocks[(Offset / BlockSize) % BlockCount];
+	}
+
+	bool Complete(Block& B)
+	{
+		if (!B.Pending)
+			return B.Offset != UINT64_MAX;
+
+		DWORD bytesRead = 0;
+		B.Pending = false;
+
+		if (!GetOverlappedResult(m_Handle, &B.Overlapped, &bytesRead, TRUE))
+		{
+			B.Offset = UINT64_MAX;
+			return false;
+		}
+
+		B.Length = bytesRead;
+		return true;
+	}
+
+	bool Issue(Block& B, uint64_t Offset)
+	{
+		// The buffer can't be reused until the previous request is done with it
+		Complete(B);
+
+		B.Offset = Offset;
+		B.Length = 0;
+		B.Overlapped.Offset = (DWORD)(Offset & 0xFFFFFFFF);
+		B.Overlapped.OffsetHigh = (DWORD)(Offset >> 32);
+		ResetEvent(B.Overlapped.hEvent);
+
+		if (!ReadFile(m_Handle, B.Data, BlockSize, nullptr, &B.Overlapped) && GetLastError() != ERROR_IO_PENDING)
+		{
+			B.Offset = UINT64_MAX;
+			return false;
+		}
+
+		B.Pending = true;
+		return true;
+	}
+
+	Block *Acquire(uint64_t Offset)
+	{
+		Block& b = SlotFor(Offset);
+
+		if (b.Offset != Offset && !Issue(b, Offset))
+			return nullptr;
+
+		if (!Complete(b))
+			return nullptr;
+
+		return &b;
+	}
+
+	void Prefetch(uint64_t Offset)
+	{
+		// Fill every other slot with the blocks that follow 'Offset'
+		for (uint32_t i = 1; i < BlockCount; i++)
+		{
+			const uint64_t next = Offset + (uint64_t)i * BlockSize;
+
+			if (next >= m_FileLength)
+				break;
+
+			if (Block& b = SlotFor(next); b.Offset != next)
+				Issue(b, next);
+		}
+	}
+
+public:
+	DirectStreamReader() = default;
+	DirectStreamReader(const DirectStreamReader&) = delete;
+	DirectStreamReader& operator=(const DirectStreamReader&) = delete;
+
+	~DirectStreamReader()
+	{
+		for (auto& b : m_Blocks)
+		{
+			if (b.Pending)
+			{
+				CancelIoEx(m_Handle, &b.Overlapped);
+				Complete(b);
+			}
+
+			if (b.Overlapped.hEvent)
+				CloseHandle(b.Overlapped.hEvent);
+
+			if (b.Data)
+				VirtualFree(b.Data, 0, MEM_RELEASE);
+		}
+
+		if (m_Handle != INVALID_HANDLE_VALUE)
+			CloseHandle(m_Handle);
+	}
+
+	bool Open(HANDLE Original, uint64_t FileLength)
+	{
+		m_Handle = ReOpenFile(Original, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, FILE_FLAG_NO_BUFFERING | FILE_FLAG_OVERLAPPED);
+		m_FileLength = FileLength;
+
+		if (m_Handle == INVALID_HANDLE_VALUE)
+			return false;
+
+		for (auto& b : m_Blocks)
+		{
+			// VirtualAlloc returns page aligned memory, which satisfies any sector alignment requirement
+			b.Data = (uint8_t *)VirtualAlloc(nullptr, BlockSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+			b.Offset = UINT64_MAX;
+			b.Overlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+
+			if (!b.Data || !b.Overlapped.hEvent)
+				return false;
+		}
+
+		Prefetch(0);
+		Issue(SlotFor(0), 0);
+		return true;
+	}
+
+	uint64_t Read(uint64_t Position, void *Buffer, size_t Size)
+	{
+		uint64_t copied = 0;
+
+		while (copied < Size && Position < m_FileLength)
+		{
+			const uint64_t blockOffset = Position - (Position % BlockSize);
+			Block *b = Acquire(blockOffset);
+
+			if (!b)
+				return std::numeric_limits<uint64_t>::max();
+
+			if (Position >= b->Offset + b->Length)
+				break;
+
+			const uint64_t count = std::min<uint64_t>(b->Offset + b->Length - Position, Size - copied);
+			memcpy((uint8_t *)Buffer + copied, &b->Data[Position - b->Offset], count);
+
+			// Crossing into a new block means the consumer moved on; top the ring back up
+			if (Position == blockOffset || Position + count == b->Offset + b->Length)
+				Prefetch(blockOffset);
+
+			copied += count;
+			Position += count;
+		}
+
+		return copied;
+	}
+};
+
+//
+// Sliding-window mappings. Instead of mapping a large file in its entirety, fixed-size views are mapped on demand from a
+// process-wide LRU pool. Each open file pins at most the one view it's currently reading from, so address space and
+// working set stay bounded no matter how many big ESMs or BA2s are open at once.
+//
+struct MappedWindow
+{
+	HANDLE MapHandle;
+	uint64_t Offset;
+	uint64_t Length;
+	void *Base;
+	uint32_t Pins;
+	uint64_t LastUse;
+};
+
+uint64_t g_MMapWindowSize;			// 0 if disabled
+uint32_t g_MMapWindowCount;
+uint64_t g_MMapWindowClock;
+std::mutex g_MMapWindowMutex;
+std::vector<MappedWindow *> g_MMapWindows;
+
+MappedWindow *AcquireMappedWindow(HANDLE MapHandle, uint64_t Position, uint64_t FileLength)
+{
+	const uint64_t offset = Position - (Position % g_MMapWindowSize);
+	std::lock_guard lock(g_MMapWindowMutex);
+
+	for (auto window : g_MMapWindows)
+	{
+		if (window->MapHandle == MapHandle && window->Offset == offset)
+		{
+			window->Pins++;
+			window->LastUse = ++g_MMapWindowClock;
+			return window;
+		}
+	}
+
+	MappedWindow *window = nullptr;
+
+	if (g_MMapWindows.size() >= g_MMapWindowCount)
+	{
+		// Evict the least recently used view that nobody is reading from. If every view is pinned, grow temporarily.
+		for (auto w : g_MMapWindows)
+		{
+			if (w->Pins == 0 && (!window || w->LastUse < window->LastUse))
+				window = w;
+		}
+
+		if (window)
+			UnmapViewOfFile(window->Base);
+	}
+
+	if (!window)
+		window = g_MMapWindows.emplace_back(new MappedWindow);
+
+	window->MapHandle = MapHandle;
+	window->Offset = offset;
+	window->Length = std::min(g_MMapWindowSize, FileLength - offset);
+	window->Base = MapViewOfFile(MapHandle, FILE_MAP_READ, (DWORD)(offset >> 32), (DWORD)(offset & 0xFFFFFFFF), (SIZE_T)window->Length);
+	window->Pins = 1;
+	window->LastUse = ++g_MMapWindowClock;
+
+	Assert(window->Base);
+	return window;
+}
+
+void ReleaseMappedWindow(MappedWindow *Window)
+{
+	std::lock_guard lock(g_MMapWindowMutex);
+
+	AssertDebug(Window->Pins > 0);
+	Window->Pins--;
+}
+
+void ReleaseMappedWindows(HANDLE MapHandle)
+{
+	std::lock_guard lock(g_MMapWindowMutex);
+
+	for (auto itr = g_MMapWindows.begin(); itr != g_MMapWindows.end();)
+	{
+		if ((*itr)->MapHandle != MapHandle)
+		{
+			itr++;
+			continue;
+		}
+
+		UnmapViewOfFile((*itr)->Base);
+		delete *itr;
+
+		itr = g_MMapWindows.erase(itr);
+	}
+}
 
 struct MMapFileInfo
 {
 	HANDLE FileHandle;
 	HANDLE MapHandle;
-	void *MapBase;
+	void *MapBase;						// Null when the file is mapped through windows
+	MappedWindow *CurrentWindow;
 	uint64_t FilePosition;
 	uint64_t FileLength;
+	bool Written;
+	DirectStreamReader *Stream;
+	InflatePipeline::FileJob *InflateJob;	// Records being decompressed ahead of the loader
+	std::wstring StagedTargetPath;		// Set when writes are buffered in memory and renamed over this path on close
+	std::wstring StagedTempPath;
+	std::vector<uint8_t> StagedData;
 
 	bool IsMMap()
 	{
 		return MapHandle != nullptr;
 	}
 
+	bool IsWindowed()
+	{
+		return IsMMap() && !MapBase;
+	}
+
+	bool IsStreamed()
+	{
+		return Stream != nullptr;
+	}
+
+	bool IsStaged()
+	{
+		return !StagedTargetPath.empty();
+	}
+
+	uint64_t ReadStaged(void *Buffer, size_t Size)
+	{
+		if (FilePosition >= FileLength)
+			return 0;
+
+		if (FilePosition + Size > FileLength)
+			Size = FileLength - FilePosition;
+
+		memcpy(Buffer, &StagedData[FilePosition], Size);
+		FilePosition += Size;
+
+		return Size;
+	}
+
+	uint64_t WriteStaged(const void *Buffer, size_t Size)
+	{
+		// std::vector grows geometrically, so a stream of tiny writes stays amortized O(1)
+		if (FilePosition + Size > StagedData.size())
+			StagedData.resize(FilePosition + Size);
+
+		memcpy(&StagedData[FilePosition], Buffer, Size);
+		Written = true;
+		FilePosition += Size;
+		FileLength = StagedData.size();
+
+		return Size;
+	}
+
+	bool SetStagedFilePointer(int64_t Offset, int64_t *NewPosition, uint32_t Method)
+	{
+		int64_t position;
+
+		switch (Method)
+		{
+		case SEEK_SET: position = Offset; break;
+		case SEEK_CUR: position = (int64_t)FilePosition + Offset; break;
+		case SEEK_END: position = (int64_t)FileLength + Offset; break;
+
+		default:
+			Assert(false);
+			return false;
+		}
+
+		if (position < 0)
+			return false;
+
+		if (NewPosition)
+			*NewPosition = position;
+
+		FilePosition = position;
+		return true;
+	}
+
+	void CommitStaged(bool& Written, bool& Verified, DWORD& WriteError)
+	{
+		// Verification runs on a worker while the data is written out in one sequential pass
+		bool verified = false;
+
+		std::thread verifyThread([this, &verified]()
+		{
+			verified = VerifyPluginData(StagedData.data(), StagedData.size());
+		});
+
+		bool written = true;
+
+		for (size_t offset = 0; written && offset < StagedData.size();)
+		{
+			const DWORD chunkSize = (DWORD)std::min<size_t>(StagedData.size() - offset, 1024 * 1024 * 1024);
+			DWORD bytesWritten = 0;
+
+			written = WriteFile(FileHandle, &StagedData[offset], chunkSize, &bytesWritten, nullptr) && bytesWritten == chunkSize;
+			offset += bytesWritten;
+		}
+
+		written = written && FlushFileBuffers(FileHandle);
+		WriteError = written ? ERROR_SUCCESS : GetLastError();
+		verifyThread.join();
+
+		Written = written;
+		Verified = verified;
+	}
+
+	static bool VerifyPluginData(const uint8_t *Data, size_t Length)
+	{
+		// The file must start with a TES4 header and the top level records and groups must tile it exactly. This catches
+		// truncated writes and group sizes that were patched with a bad seek.
+		if (Length < 24 || memcmp(Data, "TES4", 4) != 0)
+			return false;
+
+		for (size_t offset = 0; offset < Length;)
+		{
+			if (Length - offset < 24)
+				return false;
+
+			uint64_t size = *(const uint32_t *)&Data[offset + 4];
+
+			if (memcmp(&Data[offset], "GRUP", 4) != 0)
+				size += 24;
+
+			if (size < 24 || size > Length - offset)
+				return false;
+
+			offset += size;
+		}
+
+		return true;
+	}
+
+	void CopyFromWindows(void *Buffer, size_t Size)
+	{
+		for (uint64_t position = FilePosition; Size > 0;)
+		{
+			if (!CurrentWindow || position < CurrentWindow->Offset || position >= CurrentWindow->Offset + CurrentWindow->Length)
+			{
+				if (CurrentWindow)
+					ReleaseMappedWindow(CurrentWindow);
+
+				CurrentWindow = AcquireMappedWindow(MapHandle, position, FileLength);
+			}
+
+			const size_t count = (size_t)std::min<uint64_t>(CurrentWindow->Offset + CurrentWindow->Length - position, Size);
+			memcpy(Buffer, (void *)((uintptr_t)CurrentWindow->Base + (position - CurrentWindow->Offset)), count);
+
+			Buffer = (void *)((uintptr_t)Buffer + count);
+			position += count;
+			Size -= count;
+		}
+	}
+
 	uint64_t ReadMapped(void *Buffer, size_t Size)
 	{
 		AssertDebug(FilePosition <= FileLength);
@@ -22,7 +451,11 @@ struct MMapFileInfo
 		if (FilePosition + Size > FileLength)
 			Size = FileLength - FilePosition;
 
-		memcpy(Buffer, (void *)((uintptr_t)MapBase + FilePosition), Size);
+		if (IsWindowed())
+			CopyFromWindows(Buffer, Size);
+		else
+			memcpy(Buffer, (void *)((uintptr_t)MapBase + FilePosition), Size);
+
 		FilePosition += Size;
 
 		LARGE_INTEGER pos;
@@ -32,13 +465,35 @@ struct MMapFileInfo
 		return Size;
 	}
 
+	uint64_t ReadStreamed(void *Buffer, size_t Size)
+	{
+		uint64_t bytesRead = Stream->Read(FilePosition, Buffer, Size);
+
+		if (bytesRead == std::numeric_limits<uint64_t>::max())
+			return bytesRead;
+
+		FilePosition += bytesRead;
+
+		LARGE_INTEGER pos;
+		pos.QuadPart = FilePosition;
+
+		Assert(SetFilePointerEx(FileHandle, pos, nullptr, FILE_BEGIN));
+		return bytesRead;
+	}
+
 	uint64_t Read(void *Buffer, size_t Size)
 	{
 		AssertDebug(Size < std::numeric_limits<DWORD>::max());
 
+		if (IsStaged())
+			return ReadStaged(Buffer, Size);
+
 		if (IsMMap())
 			return ReadMapped(Buffer, Size);
 
+		if (IsStreamed())
+			return ReadStreamed(Buffer, Size);
+
 		DWORD bytesRead = 0;
 
 		if (ReadFile(FileHandle, Buffer, (DWORD)Size, &bytesRead, nullptr))
@@ -54,10 +509,14 @@ struct MMapFileInfo
 	{
 		AssertDebug(Size < std::numeric_limits<DWORD>::max());
 
+		if (IsStaged())
+			return WriteStaged(Buffer, Size);
+
 		DWORD bytesWritten = 0;
 
 		if (WriteFile(FileHandle, Buffer, (DWORD)Size, &bytesWritten, nullptr))
 		{
+			Written = true;
 			FilePosition += bytesWritten;
 			return bytesWritten;
 		}
@@ -67,6 +526,9 @@ struct MMapFileInfo
 
 	bool SetFilePointer(int64_t Offset, int64_t *NewPosition, uint32_t Method)
 	{
+		if (IsStaged())
+			return SetStagedFilePointer(Offset, NewPosition, Method);
+
 		switch (Method)
 		{
 		case SEEK_SET: Method = FILE_BEGIN; break;
@@ -78,106 +540,531 @@ struct MMapFileInfo
 			return false;
 		}
 
-		LARGE_INTEGER move;
-		LARGE_INTEGER position;
-		move.QuadPart = Offset;
+		LARGE_INTEGER move;
+		LARGE_INTEGER position;
+		move.QuadPart = Offset;
+
+		if (SetFilePointerEx(FileHandle, move, &position, Method))
+		{
+			if (NewPosition)
+				*NewPosition = position.QuadPart;
+
+			FilePosition = position.QuadPart;
+			return true;
+		}
+
+		return false;
+	}
+
+	bool Flush()
+	{
+		// Staged data only reaches the disk on close
+		if (IsStaged())
+			return true;
+
+		// Windowed views are read-only and come and go, there's nothing to flush
+		if (IsWindowed())
+			return true;
+
+		if (IsMMap())
+			return FlushViewOfFile(MapBase, 0) != FALSE;
+
+		return FlushFileBuffers(FileHandle) != FALSE;
+	}
+};
+
+tbb::concurrent_hash_map<HANDLE, MMapFileInfo *> g_FileMap;
+
+uint64_t g_DirectIOMinimumSize;
+std::vector<std::wstring> g_DirectIOExtensions;
+
+bool ShouldStreamFile(HANDLE Input, uint64_t FileLength)
+{
+	if (g_DirectIOMinimumSize != 0 && FileLength >= g_DirectIOMinimumSize)
+		return true;
+
+	if (g_DirectIOExtensions.empty())
+		return false;
+
+	wchar_t path[MAX_PATH * 2];
+	DWORD len = GetFinalPathNameByHandleW(Input, path, ARRAYSIZE(path), FILE_NAME_NORMALIZED);
+
+	if (len == 0 || len >= ARRAYSIZE(path))
+		return false;
+
+	const wchar_t *extension = wcsrchr(path, L'.');
+
+	if (!extension)
+		return false;
+
+	return std::any_of(g_DirectIOExtensions.begin(), g_DirectIOExtensions.end(), [extension](const std::wstring& E)
+	{
+		return !_wcsicmp(extension + 1, E.c_str());
+	});
+}
+
+bool IsPluginFile(const wchar_t *FileName)
+{
+	const wchar_t *extension = wcsrchr(FileName, L'.');
+
+	return extension && (!_wcsicmp(extension, L".esp") || !_wcsicmp(extension, L".esm") || !_wcsicmp(extension, L".esl"));
+}
+
+bool IsPluginHandle(HANDLE Input)
+{
+	wchar_t path[MAX_PATH * 2];
+	DWORD len = GetFinalPathNameByHandleW(Input, path, ARRAYSIZE(path), FILE_NAME_NORMALIZED);
+
+	if (len == 0 || len >= ARRAYSIZE(path))
+		return false;
+
+	return IsPluginFile(path);
+}
+
+MMapFileInfo *GetFileMMap(HANDLE Input)
+{
+	MMapFileInfo *info = nullptr;
+
+	AssertMsg(((uintptr_t)Input & 0b11) == 0, "Unexpected bits set");
+
+	// If this entry wasn't present already, create a new mapping
+	tbb::concurrent_hash_map<HANDLE, MMapFileInfo *>::accessor accessor;
+
+	if (!g_FileMap.find(accessor, Input))
+	{
+		// Pipes, consoles and anything else without a size are left to the system
+		LARGE_INTEGER fileSize;
+		if (GetFileType(Input) != FILE_TYPE_DISK || !GetFileSizeEx(Input, &fileSize))
+			return nullptr;
+
+		info = new MMapFileInfo;
+		info->FileHandle = Input;
+		info->FilePosition = 0;
+		info->FileLength = fileSize.QuadPart;
+		info->Written = false;
+		info->Stream = nullptr;
+		info->InflateJob = nullptr;
+		info->MapHandle = nullptr;
+		info->MapBase = nullptr;
+		info->CurrentWindow = nullptr;
+
+		if (info->FileLength <= 4096)
+		{
+			// Too small to be worth it
+		}
+		else if (ShouldStreamFile(Input, info->FileLength))
+		{
+			info->Stream = new DirectStreamReader;
+
+			// Fall back to plain ReadFile calls if the file system rejects unbuffered handles
+			if (!info->Stream->Open(Input, info->FileLength))
+			{
+				delete info->Stream;
+				info->Stream = nullptr;
+			}
+		}
+		else
+		{
+			// Handles opened without read access can't be mapped. They keep using plain ReadFile calls.
+			info->MapHandle = CreateFileMapping(info->FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+			// Map the entire file into memory all at once unless it spans more than one window
+			if (info->MapHandle && (g_MMapWindowSize == 0 || info->FileLength <= g_MMapWindowSize))
+			{
+				info->MapBase = MapViewOfFile(info->MapHandle, FILE_MAP_READ, 0, 0, 0);
+
+				if (!info->MapBase)
+				{
+					CloseHandle(info->MapHandle);
+					info->MapHandle = nullptr;
+				}
+				else if (InflatePipeline::IsEnabled() && IsPluginHandle(Input))
+					info->InflateJob = InflatePipeline::QueueFile(info->MapBase, info->FileLength);
+			}
+		}
+
+		g_FileMap.emplace(Input, info);
+	}
+	else
+	{
+		// Found, already initialized
+		info = accessor->second;
+	}
+
+	return info;
+}
+
+#define GET_HANDLE_OVERRIDE(x) (((uintptr_t)(x) & 0b11) == 0b11)
+
+MMapFileInfo *GetStdioFileMap(FILE *Input)
+{
+	if (!GET_HANDLE_OVERRIDE(Input))
+		return nullptr;
+
+	HANDLE temp = (HANDLE)((uintptr_t)Input & ~0b11);
+	return GetFileMMap(temp);
+}
+
+FILE *RegisterFileHandle(HANDLE Input)
+{
+	AssertMsg(((uintptr_t)Input & 0b11) == 0, "Unexpected bits set");
+
+	FILE *temp = (FILE *)((uintptr_t)Input | 0b11);
+
+	// Not a regular file. The caller still owns the handle.
+	if (!GetStdioFileMap(temp))
+		return nullptr;
+
+	return temp;
+}
+
+std::wstring ToUpperPath(const std::wstring& Path)
+{
+	std::wstring upper(Path);
+
+	if (!upper.empty())
+		CharUpperBuffW(upper.data(), (DWORD)upper.length());
+
+	return upper;
+}
+
+bool AnsiPathToWide(const char *Path, wchar_t *Buffer, int BufferCount)
+{
+	// File APIs may be switched to the OEM code page with SetFileApisToOEM
+	const UINT codePage = AreFileApisANSI() ? CP_ACP : CP_OEMCP;
+
+	return Path && MultiByteToWideChar(codePage, 0, Path, -1, Buffer, BufferCount) > 0;
+}
+
+//
+// File attribute cache. Answers repeated GetFileAttributes(Ex) queries for the same path. Entries are dropped when one of
+// our hooks writes, renames, or deletes the file. Changes made by other processes are picked up after a short timeout.
+// Only files that exist are cached. A missing file can be created through paths we don't see (CreateFile, the CRT when
+// FileIOHooks is off), and reporting it missing for another two seconds would break save-then-check sequences.
+//
+struct FileAttributeEntry
+{
+	ULONGLONG Expiration;
+	DWORD Error;
+	WIN32_FILE_ATTRIBUTE_DATA Data;
+};
+
+const ULONGLONG FileAttributeCacheTimeout = 2000;	// Milliseconds
+const size_t MaxCachedFileAttributes = 65536;
+
+bool g_FileAttributeCacheEnabled;
+std::atomic_uint64_t g_FileAttributeCacheGeneration;
+std::shared_mutex g_FileAttributeCacheMutex;
+std::unordered_map<std::wstring, FileAttributeEntry> g_FileAttributeCache;
+
+bool GetFileAttributeCacheKey(const wchar_t *FileName, std::wstring& Key)
+{
+	wchar_t fullPath[MAX_PATH * 2];
+	DWORD len = GetFullPathNameW(FileName, ARRAYSIZE(fullPath), fullPath, nullptr);
+
+	if (len == 0 || len >= ARRAYSIZE(fullPath))
+		return false;
+
+	Key = ToUpperPath(fullPath);
+	return true;
+}
+
+bool IsMissingFileError(DWORD Error)
+{
+	return Error == ERROR_FILE_NOT_FOUND || Error == ERROR_PATH_NOT_FOUND;
+}
+
+BOOL GetFileAttributesExCached(const wchar_t *FileName, WIN32_FILE_ATTRIBUTE_DATA *Data)
+{
+	std::wstring key;
+
+	if (!g_FileAttributeCacheEnabled || !FileName || !GetFileAttributeCacheKey(FileName, key))
+		return GetFileAttributesExW(FileName, GetFileExInfoStandard, Data);
+
+	const ULONGLONG now = GetTickCount64();
+	FileAttributeEntry entry;
+
+	{
+		std::shared_lock lock(g_FileAttributeCacheMutex);
+
+		if (auto itr = g_FileAttributeCache.find(key); itr != g_FileAttributeCache.end() && itr->second.Expiration > now)
+			entry = itr->second;
+		else
+			entry.Expiration = 0;
+	}
+
+	if (entry.Expiration == 0)
+	{
+		// Results from a query that raced with an invalidation are returned but not stored
+		const uint64_t generation = g_FileAttributeCacheGeneration.load();
+
+		entry.Expiration = now + FileAttributeCacheTimeout;
+		entry.Error = GetFileAttributesExW(FileName, GetFileExInfoStandard, &entry.Data) ? ERROR_SUCCESS : GetLastError();
+
+		if (entry.Error == ERROR_SUCCESS)
+		{
+			std::unique_lock lock(g_FileAttributeCacheMutex);
+
+			if (generation == g_FileAttributeCacheGeneration.load())
+			{
+				if (g_FileAttributeCache.size() >= MaxCachedFileAttributes)
+					g_FileAttributeCache.clear();
+
+				g_FileAttributeCache.insert_or_assign(key, entry);
+			}
+		}
+	}
+
+	if (entry.Error != ERROR_SUCCESS)
+	{
+		SetLastError(entry.Error);
+		return FALSE;
+	}
+
+	*Data = entry.Data;
+	return TRUE;
+}
+
+BOOL GetFileAttributesExCached(const char *FileName, WIN32_FILE_ATTRIBUTE_DATA *Data)
+{
+	wchar_t fileName[MAX_PATH * 2];
+
+	if (!g_FileAttributeCacheEnabled || !AnsiPathToWide(FileName, fileName, ARRAYSIZE(fileName)))
+		return GetFileAttributesExA(FileName, GetFileExInfoStandard, Data);
+
+	return GetFileAttributesExCached(fileName, Data);
+}
+
+DWORD GetFileAttributesCached(const wchar_t *FileName)
+{
+	WIN32_FILE_ATTRIBUTE_DATA data;
+
+	if (GetFileAttributesExCached(FileName, &data))
+		return data.dwFileAttributes;
+
+	// GetFileAttributes can succeed where GetFileAttributesEx fails (e.g. files opened without FILE_SHARE_READ)
+	if (!IsMissingFileError(GetLastError()))
+		return GetFileAttributesW(FileName);
+
+	return INVALID_FILE_ATTRIBUTES;
+}
+
+DWORD GetFileAttributesCached(const char *FileName)
+{
+	wchar_t fileName[MAX_PATH * 2];
+
+	if (!g_FileAttributeCacheEnabled || !AnsiPathToWide(FileName, fileName, ARRAYSIZE(fileName)))
+		return GetFileAttributesA(FileName);
+
+	return GetFileAttributesCached(fileName);
+}
+
+void InvalidateFileAttributeCache(const wchar_t *FileName)
+{
+	std::wstring key;
+
+	if (!g_FileAttributeCacheEnabled || !FileName || !GetFileAttributeCacheKey(FileName, key))
+		return;
+
+	std::unique_lock lock(g_FileAttributeCacheMutex);
+
+	g_FileAttributeCacheGeneration++;
+	g_FileAttributeCache.erase(key);
+}
+
+void InvalidateFileAttributeCache(const char *FileName)
+{
+	wchar_t fileName[MAX_PATH * 2];
+
+	if (!g_FileAttributeCacheEnabled || !AnsiPathToWide(FileName, fileName, ARRAYSIZE(fileName)))
+		return;
+
+	InvalidateFileAttributeCache(fileName);
+}
+
+void InvalidateFileAttributeCacheByHandle(HANDLE FileHandle)
+{
+	if (!g_FileAttributeCacheEnabled)
+		return;
+
+	wchar_t finalPath[MAX_PATH * 2];
+	DWORD len = GetFinalPathNameByHandleW(FileHandle, finalPath, ARRAYSIZE(finalPath), FILE_NAME_NORMALIZED | VOLUME_NAME_DOS);
+
+	if (len == 0 || len >= ARRAYSIZE(finalPath))
+		return;
+
+	// Convert "\\?\C:\..." and "\\?\UNC\server\..." back to the form GetFullPathName produces
+	if (!wcsncmp(finalPath, L"\\\\?\\UNC\\", 8))
+		InvalidateFileAttributeCache((std::wstring(L"\\\\") + &finalPath[8]).c_str());
+	else if (!wcsncmp(finalPath, L"\\\\?\\", 4))
+		InvalidateFileAttributeCache(&finalPath[4]);
+	else
+		InvalidateFileAttributeCache(finalPath);
+}
+
+DWORD WINAPI hk_GetFileAttributesA(LPCSTR lpFileName)
+{
+	return GetFileAttributesCached(lpFileName);
+}
+
+DWORD WINAPI hk_GetFileAttributesW(LPCWSTR lpFileName)
+{
+	return GetFileAttributesCached(lpFileName);
+}
+
+BOOL WINAPI hk_GetFileAttributesExA(LPCSTR lpFileName, GET_FILEEX_INFO_LEVELS fInfoLevelId, LPVOID lpFileInformation)
+{
+	if (fInfoLevelId != GetFileExInfoStandard)
+		return GetFileAttributesExA(lpFileName, fInfoLevelId, lpFileInformation);
+
+	return GetFileAttributesExCached(lpFileName, (WIN32_FILE_ATTRIBUTE_DATA *)lpFileInformation);
+}
+
+BOOL WINAPI hk_GetFileAttributesExW(LPCWSTR lpFileName, GET_FILEEX_INFO_LEVELS fInfoLevelId, LPVOID lpFileInformation)
+{
+	if (fInfoLevelId != GetFileExInfoStandard)
+		return GetFileAttributesExW(lpFileName, fInfoLevelId, lpFileInformation);
+
+	return GetFileAttributesExCached(lpFileName, (WIN32_FILE_ATTRIBUTE_DATA *)lpFileInformation);
+}
+
+BOOL WINAPI hk_MoveFileA(LPCSTR lpExistingFileName, LPCSTR lpNewFileName)
+{
+	BOOL result = MoveFileA(lpExistingFileName, lpNewFileName);
+
+	InvalidateFileAttributeCache(lpExistingFileName);
+	InvalidateFileAttributeCache(lpNewFileName);
+	return result;
+}
+
+BOOL WINAPI hk_MoveFileW(LPCWSTR lpExistingFileName, LPCWSTR lpNewFileName)
+{
+	BOOL result = MoveFileW(lpExistingFileName, lpNewFileName);
+
+	InvalidateFileAttributeCache(lpExistingFileName);
+	InvalidateFileAttributeCache(lpNewFileName);
+	return result;
+}
+
+BOOL WINAPI hk_MoveFileExA(LPCSTR lpExistingFileName, LPCSTR lpNewFileName, DWORD dwFlags)
+{
+	BOOL result = MoveFileExA(lpExistingFileName, lpNewFileName, dwFlags);
+
+	InvalidateFileAttributeCache(lpExistingFileName);
+	InvalidateFileAttributeCache(lpNewFileName);
+	return result;
+}
+
+BOOL WINAPI hk_MoveFileExW(LPCWSTR lpExistingFileName, LPCWSTR lpNewFileName, DWORD dwFlags)
+{
+	BOOL result = MoveFileExW(lpExistingFileName, lpNewFileName, dwFlags);
 
-		if (SetFilePointerEx(FileHandle, move, &position, Method))
-		{
-			if (NewPosition)
-				*NewPosition = position.QuadPart;
+	InvalidateFileAttributeCache(lpExistingFileName);
+	InvalidateFileAttributeCache(lpNewFileName);
+	return result;
+}
 
-			FilePosition = position.QuadPart;
-			return true;
-		}
+BOOL WINAPI hk_DeleteFileA(LPCSTR lpFileName)
+{
+	BOOL result = DeleteFileA(lpFileName);
 
-		return false;
-	}
+	InvalidateFileAttributeCache(lpFileName);
+	return result;
+}
 
-	bool Flush()
-	{
-		if (IsMMap())
-			return FlushViewOfFile(MapBase, 0) != FALSE;
+BOOL WINAPI hk_DeleteFileW(LPCWSTR lpFileName)
+{
+	BOOL result = DeleteFileW(lpFileName);
 
-		return FlushFileBuffers(FileHandle) != FALSE;
-	}
-};
+	InvalidateFileAttributeCache(lpFileName);
+	return result;
+}
 
-tbb::concurrent_hash_map<HANDLE, MMapFileInfo *> g_FileMap;
+//
+// Plugin saves are staged in memory, written to a temporary file in a single pass, and then renamed over the target. A
+// crash or failed verification leaves the previous plugin untouched.
+//
+bool g_StagedPluginSaves;
+bool g_FileIOHooks;		// FileIOHooks is set and every file goes through here, not just what staged saves need
 
-MMapFileInfo *GetFileMMap(HANDLE Input)
+errno_t OpenStagedFile(FILE **File, const wchar_t *FileName)
 {
-	MMapFileInfo *info = nullptr;
+	// The temporary file lives next to the target so the final rename never crosses volumes
+	std::wstring tempPath = std::wstring(FileName) + L".tmp";
+	HANDLE fileHandle = CreateFileW(tempPath.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
 
-	AssertMsg(((uintptr_t)Input & 0b11) == 0, "Unexpected bits set");
+	if (fileHandle == INVALID_HANDLE_VALUE)
+		return EINVAL;
 
-	// If this entry wasn't present already, create a new mapping
-	tbb::concurrent_hash_map<HANDLE, MMapFileInfo *>::accessor accessor;
+	*File = RegisterFileHandle(fileHandle);
 
-	if (!g_FileMap.find(accessor, Input))
+	if (!*File)
 	{
-		LARGE_INTEGER fileSize;
-		if (!GetFileSizeEx(Input, &fileSize))
-			Assert(false);
+		CloseHandle(fileHandle);
+		DeleteFileW(tempPath.c_str());
+		return EINVAL;
+	}
 
-		info = new MMapFileInfo;
-		info->FileHandle = Input;
-		info->FilePosition = 0;
-		info->FileLength = fileSize.QuadPart;
+	auto info = GetStdioFileMap(*File);
+	info->StagedTargetPath = FileName;
+	info->StagedTempPath = std::move(tempPath);
+	info->StagedData.reserve(16 * 1024 * 1024);
 
-		if (info->FileLength <= 4096)
-		{
-			info->MapHandle = nullptr;
-			info->MapBase = nullptr;
-		}
-		else
-		{
-			// Map the entire file into memory all at once
-			info->MapHandle = CreateFileMapping(info->FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
-			info->MapBase = MapViewOfFile(info->MapHandle, FILE_MAP_READ, 0, 0, 0);
+	return 0;
+}
 
-			Assert(info->MapHandle && info->MapBase);
-		}
+bool FinishStagedFile(bool Written, bool Verified, DWORD WriteError, const std::wstring& TempPath, const std::wstring& TargetPath)
+{
+	const char *failure = nullptr;
+	DWORD error = ERROR_SUCCESS;
 
-		g_FileMap.emplace(Input, info);
+	if (!Written)
+	{
+		failure = "Writing the temporary file failed";
+		error = WriteError;
 	}
-	else
+	else if (!Verified)
 	{
-		// Found, already initialized
-		info = accessor->second;
+		failure = "The saved data failed verification (truncated or malformed records)";
+	}
+	else if (!MoveFileExW(TempPath.c_str(), TargetPath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+	{
+		failure = "Replacing the plugin with the temporary file failed";
+		error = GetLastError();
 	}
 
-	return info;
-}
+	InvalidateFileAttributeCache(TempPath.c_str());
+	InvalidateFileAttributeCache(TargetPath.c_str());
 
-#define GET_HANDLE_OVERRIDE(x) (((uintptr_t)(x) & 0b11) == 0b11)
+	if (!failure)
+		return true;
 
-MMapFileInfo *GetStdioFileMap(FILE *Input)
-{
-	if (!GET_HANDLE_OVERRIDE(Input))
-		return nullptr;
+	// The editor ignores the fclose result, so the user has to be told here. The temporary file is kept since it may
+	// hold the only copy of their changes.
+	char message[2048];
+	sprintf_s(message, "Plugin save failed: %s (error %u).\n\nThe previous plugin was left unchanged:\n%ls\n\nThe data being saved was kept in:\n%ls",
+		failure, error, TargetPath.c_str(), TempPath.c_str());
 
-	HANDLE temp = (HANDLE)((uintptr_t)Input & ~0b11);
-	return GetFileMMap(temp);
+	LogWindow::Log("%s", message);
+	MessageBoxA(nullptr, message, "Plugin Save Failed", MB_ICONERROR);
+	return false;
 }
 
-FILE *RegisterFileHandle(HANDLE Input)
+BOOL WINAPI hk_ReadFile(HANDLE hFile, LPVOID lpBuffer, DWORD nNumberOfBytesToRead, LPDWORD lpNumberOfBytesRead, LPOVERLAPPED lpOverlapped)
 {
-	AssertMsg(((uintptr_t)Input & 0b11) == 0, "Unexpected bits set");
+	// Overlapped reads carry their own offset and may complete later, so they never touch the tracked position
+	auto info = lpOverlapped ? nullptr : GetFileMMap(hFile);
 
-	FILE *temp = (FILE *)((uintptr_t)Input | 0b11);
-	GetStdioFileMap(temp);
-	return temp;
-}
+	if (!info)
+		return ReadFile(hFile, lpBuffer, nNumberOfBytesToRead, lpNumberOfBytesRead, lpOverlapped);
 
-BOOL WINAPI hk_ReadFile(HANDLE hFile, LPVOID lpBuffer, DWORD nNumberOfBytesToRead, LPDWORD lpNumberOfBytesRead, LPOVERLAPPED lpOverlapped)
-{
-	auto info = GetFileMMap(hFile);
 	uint64_t bytesRead = info->Read(lpBuffer, nNumberOfBytesToRead);
 
 	if (bytesRead != UINT64_MAX)
 	{
-		*lpNumberOfBytesRead = (DWORD)bytesRead;
+		if (lpNumberOfBytesRead)
+			*lpNumberOfBytesRead = (DWORD)bytesRead;
+
 		return TRUE;
 	}
 
@@ -188,9 +1075,19 @@ BOOL WINAPI hk_ReadFileEx(HANDLE hFile, LPVOID lpBuffer, DWORD nNumberOfBytesToR
 {
 	auto info = GetFileMMap(hFile);
 
-	if (info->IsMMap())
+	if (info && (info->IsMMap() || info->IsStreamed()))
 	{
-		uint64_t bytesRead = info->ReadMapped(lpBuffer, nNumberOfBytesToRead);
+		// The offset comes from the OVERLAPPED structure, not the file pointer
+		const int64_t offset = ((int64_t)lpOverlapped->OffsetHigh << 32) | lpOverlapped->Offset;
+
+		if (!info->SetFilePointer(offset, nullptr, SEEK_SET))
+			return FALSE;
+
+		uint64_t bytesRead = info->Read(lpBuffer, nNumberOfBytesToRead);
+
+		if (bytesRead == UINT64_MAX)
+			return FALSE;
+
 		lpCompletionRoutine(0, (DWORD)bytesRead, lpOverlapped);
 		return TRUE;
 	}
@@ -201,16 +1098,25 @@ BOOL WINAPI hk_ReadFileEx(HANDLE hFile, LPVOID lpBuffer, DWORD nNumberOfBytesToR
 
 BOOL WINAPI hk_SetFilePointerEx(HANDLE hFile, LARGE_INTEGER liDistanceToMove, PLARGE_INTEGER lpNewFilePointer, DWORD dwMoveMethod)
 {
+	uint32_t method;
+
 	switch (dwMoveMethod)
 	{
-	case FILE_BEGIN: dwMoveMethod = SEEK_SET; break;
-	case FILE_CURRENT: dwMoveMethod = SEEK_CUR; break;
-	case FILE_END: dwMoveMethod = SEEK_END; break;
+	case FILE_BEGIN: method = SEEK_SET; break;
+	case FILE_CURRENT: method = SEEK_CUR; break;
+	case FILE_END: method = SEEK_END; break;
+
+	default:
+		// Let the system report the bad argument
+		return SetFilePointerEx(hFile, liDistanceToMove, lpNewFilePointer, dwMoveMethod);
 	}
 
 	auto info = GetFileMMap(hFile);
 
-	if (info->SetFilePointer(liDistanceToMove.QuadPart, &lpNewFilePointer->QuadPart, dwMoveMethod))
+	if (!info)
+		return SetFilePointerEx(hFile, liDistanceToMove, lpNewFilePointer, dwMoveMethod);
+
+	if (info->SetFilePointer(liDistanceToMove.QuadPart, lpNewFilePointer ? &lpNewFilePointer->QuadPart : nullptr, method))
 		return TRUE;
 
 	return FALSE;
@@ -225,12 +1131,25 @@ BOOL WINAPI hk_CloseHandle(HANDLE Input)
 		auto *info = accessor->second;
 		g_FileMap.erase(accessor);
 
+		if (info->Written)
+			InvalidateFileAttributeCacheByHandle(info->FileHandle);
+
+		// Must finish before the view it reads from is unmapped
+		InflatePipeline::CancelFile(info->InflateJob);
+
 		if (info->IsMMap())
 		{
-			UnmapViewOfFile(info->MapBase);
+			if (info->IsWindowed())
+				ReleaseMappedWindows(info->MapHandle);
+			else
+				UnmapViewOfFile(info->MapBase);
+
 			CloseHandle(info->MapHandle);
 		}
 
+		if (info->IsStreamed())
+			delete info->Stream;
+
 		delete info;
 	}
 
@@ -291,12 +1210,32 @@ errno_t hk_fopen_s(FILE **File, const char *Filename, const char *Mode)
 		}
 	}
 
+	if (createMode == CREATE_ALWAYS && g_StagedPluginSaves)
+	{
+		if (wchar_t fileName[MAX_PATH * 2]; AnsiPathToWide(Filename, fileName, ARRAYSIZE(fileName)) && IsPluginFile(fileName))
+			return OpenStagedFile(File, fileName);
+	}
+
+	// Staged saves on their own leave every other file to the CRT
+	if (!g_FileIOHooks)
+		return VC140_fopen_s(File, Filename, Mode);
+
 	HANDLE fileHandle = CreateFileA(Filename, accessMode, FILE_SHARE_READ, nullptr, createMode, FILE_ATTRIBUTE_NORMAL, nullptr);
 
 	if (fileHandle == INVALID_HANDLE_VALUE)
 		return EINVAL;
 
+	if ((accessMode & GENERIC_WRITE) != 0)
+		InvalidateFileAttributeCache(Filename);
+
 	*File = RegisterFileHandle(fileHandle);
+
+	if (!*File)
+	{
+		CloseHandle(fileHandle);
+		return EINVAL;
+	}
+
 	return 0;
 }
 
@@ -341,12 +1280,28 @@ errno_t hk_wfopen_s(FILE **File, const wchar_t *Filename, const wchar_t *Mode)
 		}
 	}
 
+	if (createMode == CREATE_ALWAYS && g_StagedPluginSaves && Filename && IsPluginFile(Filename))
+		return OpenStagedFile(File, Filename);
+
+	if (!g_FileIOHooks)
+		return VC140_wfopen_s(File, Filename, Mode);
+
 	HANDLE fileHandle = CreateFileW(Filename, accessMode, FILE_SHARE_READ, nullptr, createMode, FILE_ATTRIBUTE_NORMAL, nullptr);
 
 	if (fileHandle == INVALID_HANDLE_VALUE)
 		return EINVAL;
 
+	if ((accessMode & GENERIC_WRITE) != 0)
+		InvalidateFileAttributeCache(Filename);
+
 	*File = RegisterFileHandle(fileHandle);
+
+	if (!*File)
+	{
+		CloseHandle(fileHandle);
+		return EINVAL;
+	}
+
 	return 0;
 }
 
@@ -368,6 +1323,24 @@ int hk_fclose(FILE *stream)
 {
 	if (MMapFileInfo *info = GetStdioFileMap(stream))
 	{
+		if (info->IsStaged())
+		{
+			// Closing the handle frees 'info' and the temporary file can't be renamed while it's still open
+			const std::wstring tempPath(info->StagedTempPath);
+			const std::wstring targetPath(info->StagedTargetPath);
+			bool written;
+			bool verified;
+			DWORD writeError;
+			info->CommitStaged(written, verified, writeError);
+
+			hk_CloseHandle(info->FileHandle);
+
+			if (!FinishStagedFile(written, verified, writeError, tempPath, targetPath))
+				return EOF;
+
+			return 0;
+		}
+
 		hk_CloseHandle(info->FileHandle);
 		return 0;
 	}
@@ -518,7 +1491,297 @@ int hk_feof(FILE *stream)
 	return VC140_feof(stream);
 }
 
-void PatchFileIO()
+//
+// Directory enumeration cache. Listings are snapshotted once per directory and served from memory until the directory's
+// change notification handle is signaled. Masks are matched against long and 8.3 names with the file system's rules.
+//
+struct DirectoryEntry
+{
+	DWORD FileAttributes;
+	FILETIME CreationTime;
+	FILETIME LastAccessTime;
+	FILETIME LastWriteTime;
+	uint64_t FileSize;
+	DWORD ReparseTag;
+	std::wstring FileName;
+	std::wstring AlternateFileName;
+	std::wstring MatchName;				// Uppercase FileName
+	std::wstring MatchAlternateName;	// Uppercase AlternateFileName
+};
+
+struct DirectorySnapshot
+{
+	HANDLE ChangeHandle = INVALID_HANDLE_VALUE;
+	std::vector<DirectoryEntry> Entries;
+
+	~DirectorySnapshot()
+	{
+		if (ChangeHandle != INVALID_HANDLE_VALUE)
+			FindCloseChangeNotification(ChangeHandle);
+	}
+
+	bool IsStale() const
+	{
+		return WaitForSingleObject(ChangeHandle, 0) != WAIT_TIMEOUT;
+	}
+};
+
+struct FindFileContext
+{
+	std::shared_ptr<DirectorySnapshot> Snapshot;
+	std::wstring Mask;	// Uppercase, translated by TranslateFindMask
+	size_t NextIndex;
+};
+
+const size_t MaxCachedDirectories = 4096;
+
+std::mutex g_DirectoryCacheMutex;
+std::unordered_map<std::wstring, std::shared_ptr<DirectorySnapshot>> g_DirectoryCache;
+
+bool FindFileContextMatches(const FindFileContext *Context, const DirectoryEntry& Entry)
+{
+	if (WildcardMatch(Context->Mask, Entry.MatchName))
+		return true;
+
+	// FindFirstFile also matches against 8.3 names
+	return !Entry.MatchAlternateName.empty() && WildcardMatch(Context->Mask, Entry.MatchAlternateName);
+}
+
+std::shared_ptr<DirectorySnapshot> GetDirectorySnapshot(const std::wstring& Directory)
+{
+	const std::wstring key = ToUpperPath(Directory);
+
+	{
+		std::lock_guard lock(g_DirectoryCacheMutex);
+
+		if (auto itr = g_DirectoryCache.find(key); itr != g_DirectoryCache.end())
+		{
+			if (!itr->second->IsStale())
+				return itr->second;
+
+			g_DirectoryCache.erase(itr);
+		}
+	}
+
+	// The watcher must be armed before enumerating or changes made during the scan are lost
+	auto snapshot = std::make_shared<DirectorySnapshot>();
+	snapshot->ChangeHandle = FindFirstChangeNotificationW(Directory.c_str(), FALSE,
+		FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_ATTRIBUTES | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+
+	if (snapshot->ChangeHandle == INVALID_HANDLE_VALUE)
+		return nullptr;
+
+	std::wstring searchPath(Directory);
+
+	if (searchPath.back() != L'\\')
+		searchPath += L'\\';
+
+	searchPath += L'*';
+
+	WIN32_FIND_DATAW data;
+	HANDLE findHandle = FindFirstFileExW(searchPath.c_str(), FindExInfoStandard, &data, FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+
+	if (findHandle == INVALID_HANDLE_VALUE)
+		return nullptr;
+
+	do
+	{
+		auto& entry = snapshot->Entries.emplace_back();
+		entry.FileAttributes = data.dwFileAttributes;
+		entry.CreationTime = data.ftCreationTime;
+		entry.LastAccessTime = data.ftLastAccessTime;
+		entry.LastWriteTime = data.ftLastWriteTime;
+		entry.FileSize = ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+		entry.ReparseTag = data.dwReserved0;
+		entry.FileName = data.cFileName;
+		entry.AlternateFileName = data.cAlternateFileName;
+		entry.MatchName = ToUpperPath(entry.FileName);
+		entry.MatchAlternateName = ToUpperPath(entry.AlternateFileName);
+	} while (FindNextFileW(findHandle, &data));
+
+	FindClose(findHandle);
+
+	std::lock_guard lock(g_DirectoryCacheMutex);
+
+	if (g_DirectoryCache.size() >= MaxCachedDirectories)
+		g_DirectoryCache.clear();
+
+	g_DirectoryCache.insert_or_assign(key, snapshot);
+	return snapshot;
+}
+
+FindFileContext *CreateFindFileContext(const wchar_t *FileName)
+{
+	if (!FileName)
+		return nullptr;
+
+	// Split "dir\mask" and only handle wildcard enumerations, see IsCacheableFindMask
+	std::wstring path(FileName);
+	size_t split = path.find_last_of(L"\\/");
+
+	std::wstring directory = (split != std::wstring::npos) ? path.substr(0, split + 1) : L".";
+	std::wstring mask = (split != std::wstring::npos) ? path.substr(split + 1) : path;
+
+	if (!IsCacheableFindMask(mask))
+		return nullptr;
+
+	wchar_t fullPath[MAX_PATH * 2];
+	DWORD len = GetFullPathNameW(directory.c_str(), ARRAYSIZE(fullPath), fullPath, nullptr);
+
+	if (len == 0 || len >= ARRAYSIZE(fullPath))
+		return nullptr;
+
+	// Drop the trailing separator unless this is a drive root ("C:\")
+	if (len > 3 && fullPath[len - 1] == L'\\')
+		fullPath[len - 1] = L'\0';
+
+	auto snapshot = GetDirectorySnapshot(fullPath);
+
+	if (!snapshot)
+		return nullptr;
+
+	auto context = new FindFileContext;
+	context->Snapshot = std::move(snapshot);
+	context->Mask = TranslateFindMask(ToUpperPath(mask));
+	context->NextIndex = 0;
+
+	return context;
+}
+
+const DirectoryEntry *FindFileContextNext(FindFileContext *Context)
+{
+	auto& entries = Context->Snapshot->Entries;
+
+	while (Context->NextIndex < entries.size())
+	{
+		const auto& entry = entries[Context->NextIndex++];
+
+		if (FindFileContextMatches(Context, entry))
+			return &entry;
+	}
+
+	return nullptr;
+}
+
+FindFileContext *GetFindFileContext(HANDLE Input)
+{
+	if (Input == INVALID_HANDLE_VALUE || !GET_HANDLE_OVERRIDE(Input))
+		return nullptr;
+
+	return (FindFileContext *)((uintptr_t)Input & ~0b11);
+}
+
+void CopyFindData(const DirectoryEntry *Entry, WIN32_FIND_DATAW *Data)
+{
+	memset(Data, 0, sizeof(WIN32_FIND_DATAW));
+	Data->dwFileAttributes = Entry->FileAttributes;
+	Data->ftCreationTime = Entry->CreationTime;
+	Data->ftLastAccessTime = Entry->LastAccessTime;
+	Data->ftLastWriteTime = Entry->LastWriteTime;
+	Data->nFileSizeHigh = (DWORD)(Entry->FileSize >> 32);
+	Data->nFileSizeLow = (DWORD)(Entry->FileSize & 0xFFFFFFFF);
+	Data->dwReserved0 = Entry->ReparseTag;
+
+	wcsncpy_s(Data->cFileName, Entry->FileName.c_str(), _TRUNCATE);
+	wcsncpy_s(Data->cAlternateFileName, Entry->AlternateFileName.c_str(), _TRUNCATE);
+}
+
+void CopyFindData(const DirectoryEntry *Entry, WIN32_FIND_DATAA *Data)
+{
+	const UINT codePage = AreFileApisANSI() ? CP_ACP : CP_OEMCP;
+
+	memset(Data, 0, sizeof(WIN32_FIND_DATAA));
+	Data->dwFileAttributes = Entry->FileAttributes;
+	Data->ftCreationTime = Entry->CreationTime;
+	Data->ftLastAccessTime = Entry->LastAccessTime;
+	Data->ftLastWriteTime = Entry->LastWriteTime;
+	Data->nFileSizeHigh = (DWORD)(Entry->FileSize >> 32);
+	Data->nFileSizeLow = (DWORD)(Entry->FileSize & 0xFFFFFFFF);
+	Data->dwReserved0 = Entry->ReparseTag;
+
+	WideCharToMultiByte(codePage, 0, Entry->FileName.c_str(), -1, Data->cFileName, ARRAYSIZE(Data->cFileName) - 1, nullptr, nullptr);
+	WideCharToMultiByte(codePage, 0, Entry->AlternateFileName.c_str(), -1, Data->cAlternateFileName, ARRAYSIZE(Data->cAlternateFileName) - 1, nullptr, nullptr);
+}
+
+template<typename T>
+HANDLE FindFirstFileCached(FindFileContext *Context, T *FindFileData)
+{
+	auto entry = FindFileContextNext(Context);
+
+	if (!entry)
+	{
+		delete Context;
+
+		SetLastError(ERROR_FILE_NOT_FOUND);
+		return INVALID_HANDLE_VALUE;
+	}
+
+	CopyFindData(entry, FindFileData);
+	return (HANDLE)((uintptr_t)Context | 0b11);
+}
+
+template<typename T>
+BOOL FindNextFileCached(FindFileContext *Context, T *FindFileData)
+{
+	auto entry = FindFileContextNext(Context);
+
+	if (!entry)
+	{
+		SetLastError(ERROR_NO_MORE_FILES);
+		return FALSE;
+	}
+
+	CopyFindData(entry, FindFileData);
+	return TRUE;
+}
+
+HANDLE WINAPI hk_FindFirstFileA(LPCSTR lpFileName, LPWIN32_FIND_DATAA lpFindFileData)
+{
+	if (wchar_t fileName[MAX_PATH * 2]; AnsiPathToWide(lpFileName, fileName, ARRAYSIZE(fileName)))
+	{
+		if (auto context = CreateFindFileContext(fileName))
+			return FindFirstFileCached(context, lpFindFileData);
+	}
+
+	return FindFirstFileA(lpFileName, lpFindFileData);
+}
+
+HANDLE WINAPI hk_FindFirstFileW(LPCWSTR lpFileName, LPWIN32_FIND_DATAW lpFindFileData)
+{
+	if (auto context = CreateFindFileContext(lpFileName))
+		return FindFirstFileCached(context, lpFindFileData);
+
+	return FindFirstFileW(lpFileName, lpFindFileData);
+}
+
+BOOL WINAPI hk_FindNextFileA(HANDLE hFindFile, LPWIN32_FIND_DATAA lpFindFileData)
+{
+	if (auto context = GetFindFileContext(hFindFile))
+		return FindNextFileCached(context, lpFindFileData);
+
+	return FindNextFileA(hFindFile, lpFindFileData);
+}
+
+BOOL WINAPI hk_FindNextFileW(HANDLE hFindFile, LPWIN32_FIND_DATAW lpFindFileData)
+{
+	if (auto context = GetFindFileContext(hFindFile))
+		return FindNextFileCached(context, lpFindFileData);
+
+	return FindNextFileW(hFindFile, lpFindFileData);
+}
+
+BOOL WINAPI hk_FindClose(HANDLE hFindFile)
+{
+	if (auto context = GetFindFileContext(hFindFile))
+	{
+		delete context;
+		return TRUE;
+	}
+
+	return FindClose(hFindFile);
+}
+
+void PatchStdio()
 {
 	*(uintptr_t *)&VC140_fopen_s = Detours::IATHook(g_ModuleBase, "API-MS-WIN-CRT-STDIO-L1-1-0.DLL", "fopen_s", (uintptr_t)hk_fopen_s);
 	*(uintptr_t *)&VC140_wfopen_s = Detours::IATHook(g_ModuleBase, "API-MS-WIN-CRT-STDIO-L1-1-0.DLL", "_wfopen_s", (uintptr_t)hk_wfopen_s);
@@ -534,9 +1797,68 @@ void PatchFileIO()
 	*(uintptr_t *)&VC140_ftell = Detours::IATHook(g_ModuleBase, "API-MS-WIN-CRT-STDIO-L1-1-0.DLL", "ftell", (uintptr_t)hk_ftell);
 	*(uintptr_t *)&VC140_rewind = Detours::IATHook(g_ModuleBase, "API-MS-WIN-CRT-STDIO-L1-1-0.DLL", "rewind", (uintptr_t)hk_rewind);
 	*(uintptr_t *)&VC140_feof = Detours::IATHook(g_ModuleBase, "API-MS-WIN-CRT-STDIO-L1-1-0.DLL", "feof", (uintptr_t)hk_feof);
+}
+
+void PatchFileIO()
+{
+	g_FileIOHooks = true;
+	g_StagedPluginSaves = g_INI.GetBoolean("CreationKit", "AtomicPluginSave", false);
+	g_MMapWindowSize = (uint64_t)g_INI.GetInteger("CreationKit", "MMapWindowSize", 0) * 1024 * 1024;
+	g_MMapWindowCount = std::max<uint32_t>((uint32_t)g_INI.GetInteger("CreationKit", "MMapWindowCount", 16), 1);
+	g_DirectIOMinimumSize = (uint64_t)g_INI.GetInteger("CreationKit", "DirectIOMinimumSize", 0) * 1024 * 1024;
+
+	// Comma separated list without dots, i.e. "esm,ba2"
+	const std::string extensions = g_INI.Get("CreationKit", "DirectIOExtensions", "");
+
+	for (size_t start = 0; start < extensions.length();)
+	{
+		size_t end = extensions.find(',', start);
+
+		if (end == std::string::npos)
+			end = extensions.length();
+
+		if (end > start)
+			g_DirectIOExtensions.emplace_back(extensions.begin() + start, extensions.begin() + end);
+
+		start = end + 1;
+	}
+
+	PatchStdio();
 
 	Detours::IATHook(g_ModuleBase, "KERNEL32.dll", "CloseHandle", (uintptr_t)hk_CloseHandle);
 	Detours::IATHook(g_ModuleBase, "KERNEL32.dll", "ReadFile", (uintptr_t)hk_ReadFile);
 	Detours::IATHook(g_ModuleBase, "KERNEL32.dll", "ReadFileEx", (uintptr_t)hk_ReadFileEx);
 	Detours::IATHook(g_ModuleBase, "KERNEL32.dll", "SetFilePointerEx", (uintptr_t)hk_SetFilePointerEx);
+}
+
+void PatchStagedPluginSaves()
+{
+	// Only the stdio calls a save goes through. Reads and every other file keep their normal path.
+	g_StagedPluginSaves = true;
+	PatchStdio();
+}
+
+void PatchDirectoryCache()
+{
+	Detours::IATHook(g_ModuleBase, "KERNEL32.dll", "FindFirstFileA", (uintptr_t)hk_FindFirstFileA);
+	Detours::IATHook(g_ModuleBase, "KERNEL32.dll", "FindFirstFileW", (uintptr_t)hk_FindFirstFileW);
+	Detours::IATHook(g_ModuleBase, "KERNEL32.dll", "FindNextFileA", (uintptr_t)hk_FindNextFileA);
+	Detours::IATHook(g_ModuleBase, "KERNEL32.dll", "FindNextFileW", (uintptr_t)hk_FindNextFileW);
+	Detours::IATHook(g_ModuleBase, "KERNEL32.dll", "FindClose", (uintptr_t)hk_FindClose);
+}
+
+void PatchFileAttributeCache()
+{
+	g_FileAttributeCacheEnabled = true;
+
+	Detours::IATHook(g_ModuleBase, "KERNEL32.dll", "GetFileAttributesA", (uintptr_t)hk_GetFileAttributesA);
+	Detours::IATHook(g_ModuleBase, "KERNEL32.dll", "GetFileAttributesW", (uintptr_t)hk_GetFileAttributesW);
+	Detours::IATHook(g_ModuleBase, "KERNEL32.dll", "GetFileAttributesExA", (uintptr_t)hk_GetFileAttributesExA);
+	Detours::IATHook(g_ModuleBase, "KERNEL32.dll", "GetFileAttributesExW", (uintptr_t)hk_GetFileAttributesExW);
+	Detours::IATHook(g_ModuleBase, "KERNEL32.dll", "MoveFileA", (uintptr_t)hk_MoveFileA);
+	Detours::IATHook(g_ModuleBase, "KERNEL32.dll", "MoveFileW", (uintptr_t)hk_MoveFileW);
+	Detours::IATHook(g_ModuleBase, "KERNEL32.dll", "MoveFileExA", (uintptr_t)hk_MoveFileExA);
+	Detours::IATHook(g_ModuleBase, "KERNEL32.dll", "MoveFileExW", (uintptr_t)hk_MoveFileExW);
+	Detours::IATHook(g_ModuleBase, "KERNEL32.dll", "DeleteFileA", (uintptr_t)hk_DeleteFileA);
+	Detours::IATHook(g_ModuleBase, "KERNEL32.dll", "DeleteFileW", (uintptr_t)hk_DeleteFileW);
 }
\ No newline at end of file
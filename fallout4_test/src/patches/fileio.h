@@ -0,0 +1,11 @@
+#pragma once
+
+#include "../common.h"
+
+BOOL GetFileAttributesExCached(const wchar_t *FileName, WIN32_FILE_ATTRIBUTE_DATA *Data);
+BOOL GetFileAttributesExCached(const char *FileName, WIN32_FILE_ATTRIBUTE_DATA *Data);
+DWORD GetFileAttributesCached(const wchar_t *FileName);
+DWORD GetFileAttributesCached(const char *FileName);
+void InvalidateFileAttributeCache(const wchar_t *FileName);
+void InvalidateFileAttributeCache(const char *FileName);
+void InvalidateFileAttributeCacheByHandle(HANDLE FileHandle);
\ No newline at end of file
@@ -3,13 +3,21 @@
 #include <intrin.h>
 #include "TES/MemoryManager.h"
 #include "TES/bhkThreadMemorySource.h"
+#include "CKF4/ComboBoxSearch.h"
 #include "CKF4/Editor.h"
 #include "CKF4/EditorUI.h"
 #include "CKF4/EditorUIDarkMode.h"
+#include "CKF4/InflatePipeline.h"
+#include "CKF4/LazyTreeView.h"
 #include "CKF4/LogWindow.h"
+#include "CKF4/ObjectWindowFilter.h"
+#include "CKF4/VirtualListView.h"
 
 void PatchMemory();
 void PatchFileIO();
+void PatchStagedPluginSaves();
+void PatchDirectoryCache();
+void PatchFileAttributeCache();
 
 void Patch_Fallout4CreationKit()
 {
@@ -87,8 +95,24 @@ void Patch_Fallout4CreationKit()
 		XUtil::DetourJump(OFFSET(0x2004300, 0), &MemoryManager::Size);
 		XUtil::DetourJump(OFFSET(0x200AB30, 0), &ScrapHeap::Allocate);
 		XUtil::DetourJump(OFFSET(0x200B170, 0), &ScrapHeap::Deallocate);
+
+		g_EngineHeapPatched = true;
 	}
 
+	//
+	// File IO
+	//
+	if (g_INI.GetBoolean("CreationKit", "FileIOHooks", false))
+		PatchFileIO();
+	else if (g_INI.GetBoolean("CreationKit", "AtomicPluginSave", false))
+		PatchStagedPluginSaves();
+
+	if (g_INI.GetBoolean("CreationKit", "DirectoryCache", false))
+		PatchDirectoryCache();
+
+	if (g_INI.GetBoolean("CreationKit", "FileAttributeCache", false))
+		PatchFileAttributeCache();
+
 	//
 	// UI
 	//
@@ -112,6 +136,10 @@ void Patch_Fallout4CreationKit()
 	if (g_INI.GetBoolean("CreationKit", "UI", false))
 	{
 		EditorUI::Initialize();
+		VirtualListView::Initialize(g_INI.GetBoolean("CreationKit", "VirtualListViews", false));
+		ObjectWindowFilter::Initialize(g_INI.GetBoolean("CreationKit", "BackgroundObjectFilter", false));
+		LazyTreeView::Initialize(g_INI.GetBoolean("CreationKit", "LazyObjectWindowTree", false));
+		ComboBoxSearch::Initialize(g_INI.GetBoolean("CreationKit", "ComboBoxTypeAhead", false), g_INI.GetBoolean("CreationKit", "ComboBoxSubstringSearch", false));
 		*(uintptr_t *)&EditorUI::OldWndProc = Detours::X64::DetourFunctionClass(OFFSET(0x05B74D0, 0), &EditorUI::WndProc);
 		*(uintptr_t *)&EditorUI::OldObjectWindowProc = Detours::X64::DetourFunctionClass(OFFSET(0x03F9020, 0), &EditorUI::ObjectWindowProc);
 		*(uintptr_t *)&EditorUI::OldCellViewProc = Detours::X64::DetourFunctionClass(OFFSET(0x059D820, 0), &EditorUI::CellViewProc);
@@ -194,15 +222,29 @@ void Patch_Fallout4CreationKit()
 	//
 	// Plugin loading optimizations
 	//
-	int cpuinfo[4];
-	__cpuid(cpuinfo, 1);
+	decltype(&sub_1405B31C0) pointerSearch = &sub_1405B31C0;
 
-	// Utilize SSE4.1 instructions if available
-	if ((cpuinfo[2] & (1 << 19)) != 0)
-		XUtil::DetourJump(OFFSET(0x05B31C0, 0), &sub_1405B31C0_SSE41);
-	else
-		XUtil::DetourJump(OFFSET(0x05B31C0, 0), &sub_1405B31C0);
+	if (BSTArrayKernels::GetISA() != BSTArrayKernels::ISA::Scalar)
+		pointerSearch = &sub_1405B31C0_Vectorized;
 
-	XUtil::DetourCall(OFFSET(0x08056B7, 0), &hk_inflateInit);
-	XUtil::DetourCall(OFFSET(0x08056F7, 0), &hk_inflate);
+	// Large arrays use a hash index, small ones keep scanning
+	if (g_INI.GetBoolean("CreationKit", "PointerSearchIndex", false))
+	{
+		g_PointerSearchScan = pointerSearch;
+		pointerSearch = &sub_1405B31C0_Indexed;
+	}
+
+	XUtil::DetourJump(OFFSET(0x05B31C0, 0), pointerSearch);
+
+	size_t parallelInflateBudget = (size_t)g_INI.GetInteger("CreationKit", "ParallelInflate", 0) * 1024 * 1024;
+	size_t inflateCacheBudget = (size_t)g_INI.GetInteger("CreationKit", "InflateCacheSize", 0) * 1024 * 1024;
+
+	InflatePipeline::Initialize(parallelInflateBudget, inflateCacheBudget);
+
+	//
+	// Only loads are patched. Plugin saves still compress records with the CK's statically linked zlib deflate: its call
+	// sites in the record writer aren't known for this build, and a replacement has to support streamed (non Z_FINISH)
+	// writes before it can be attached to them.
+	//
+	PatchInflate(OFFSET(0x08056B7, 0), OFFSET(0x08056F7, 0));
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "xutil_portable.h"
+
 #pragma warning(disable:4094) // untagged 'struct' declared no symbols
 
 #define Assert(Cond)					if(!(Cond)) XUtil::XAssert(__FILE__, __LINE__, #Cond);
@@ -87,10 +89,6 @@ namespace XUtil
 	void SetThreadName(uint32_t ThreadID, const char *ThreadName);
 	void Trim(char *Buffer, char C);
 	void XAssert(const char *File, int Line, const char *Format, ...);
-	uint64_t MurmurHash64A(const void *Key, size_t Len, uint64_t Seed = 0);
-
-	uintptr_t FindPattern(uintptr_t StartAddress, uintptr_t MaxSize, const char *Mask);
-	std::vector<uintptr_t> FindPatterns(uintptr_t StartAddress, uintptr_t MaxSize, const char *Mask);
 	bool GetPESectionRange(uintptr_t ModuleBase, const char *Section, uintptr_t *Start, uintptr_t *End);
 	void PatchMemory(uintptr_t Address, uint8_t *Data, size_t Size);
 	void PatchMemory(uintptr_t Address, std::initializer_list<uint8_t> Data);
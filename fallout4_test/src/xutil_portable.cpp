@@ -0,0 +1,132 @@
+#include <string.h>
+#include <stdlib.h>
+#include "ScratchMemory.h"
+#include "xutil_portable.h"
+
+uint64_t XUtil::MurmurHash64A(const void *Key, size_t Len, uint64_t Seed)
+{
+	/*-----------------------------------------------------------------------------
+	// https://github.com/abrandoned/murmur2/blob/master/MurmurHash2.c#L65
+	// MurmurHash2, 64-bit versions, by Austin Appleby
+	//
+	// The same caveats as 32-bit MurmurHash2 apply here - beware of alignment
+	// and endian-ness issues if used across multiple platforms.
+	//
+	// 64-bit hash for 64-bit platforms
+	*/
+	const uint64_t m = 0xc6a4a7935bd1e995ull;
+	const int r = 47;
+
+	uint64_t h = Seed ^ (Len * m);
+
+	const uint64_t *data = (const uint64_t *)Key;
+	const uint64_t *end = data + (Len / 8);
+
+	while (data != end)
+	{
+		uint64_t k = *data++;
+
+		k *= m;
+		k ^= k >> r;
+		k *= m;
+
+		h ^= k;
+		h *= m;
+	}
+
+	const unsigned char *data2 = (const unsigned char *)data;
+
+	switch (Len & 7)
+	{
+	case 7: h ^= ((uint64_t)data2[6]) << 48;
+	case 6: h ^= ((uint64_t)data2[5]) << 40;
+	case 5: h ^= ((uint64_t)data2[4]) << 32;
+	case 4: h ^= ((uint64_t)data2[3]) << 24;
+	case 3: h ^= ((uint64_t)data2[2]) << 16;
+	case 2: h ^= ((uint64_t)data2[1]) << 8;
+	case 1: h ^= ((uint64_t)data2[0]);
+		h *= m;
+	}
+
+	h ^= h >> r;
+	h *= m;
+	h ^= h >> r;
+
+	return h;
+}
+
+uintptr_t XUtil::FindPattern(uintptr_t StartAddress, uintptr_t MaxSize, const char *Mask)
+{
+	SmallVector<std::pair<uint8_t, bool>, 64> pattern;
+
+	for (size_t i = 0; i < strlen(Mask);)
+	{
+		if (Mask[i] != '?')
+		{
+			pattern.emplace_back((uint8_t)strtoul(&Mask[i], nullptr, 16), false);
+			i += 3;
+		}
+		else
+		{
+			pattern.emplace_back(0x00, true);
+			i += 2;
+		}
+	}
+
+	const uint8_t *dataStart = (uint8_t *)StartAddress;
+	const uint8_t *dataEnd = (uint8_t *)StartAddress + MaxSize + 1;
+
+	auto ret = std::search(dataStart, dataEnd, pattern.begin(), pattern.end(),
+		[](uint8_t CurrentByte, std::pair<uint8_t, bool>& Pattern)
+	{
+		return Pattern.second || (CurrentByte == Pattern.first);
+	});
+
+	if (ret == dataEnd)
+		return 0;
+
+	return std::distance(dataStart, ret) + StartAddress;
+}
+
+std::vector<uintptr_t> XUtil::FindPatterns(uintptr_t StartAddress, uintptr_t MaxSize, const char *Mask)
+{
+	std::vector<uintptr_t> results;
+	SmallVector<std::pair<uint8_t, bool>, 64> pattern;
+
+	for (size_t i = 0; i < strlen(Mask);)
+	{
+		if (Mask[i] != '?')
+		{
+			pattern.emplace_back((uint8_t)strtoul(&Mask[i], nullptr, 16), false);
+			i += 3;
+		}
+		else
+		{
+			pattern.emplace_back(0x00, true);
+			i += 2;
+		}
+	}
+
+	const uint8_t *dataStart = (uint8_t *)StartAddress;
+	const uint8_t *dataEnd = (uint8_t *)StartAddress + MaxSize + 1;
+
+	for (const uint8_t *i = dataStart;;)
+	{
+		auto ret = std::search(i, dataEnd, pattern.begin(), pattern.end(),
+			[](uint8_t CurrentByte, std::pair<uint8_t, bool>& Pattern)
+		{
+			return Pattern.second || (CurrentByte == Pattern.first);
+		});
+
+		// No byte pattern matched, exit loop
+		if (ret == dataEnd)
+			break;
+
+		uintptr_t addr = std::distance(dataStart, ret) + StartAddress;
+		results.push_back(addr);
+
+		i = (uint8_t *)(addr + 1);
+	}
+
+	return results;
+}
\ No newline at end of file
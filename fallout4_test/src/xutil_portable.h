@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+//
+// The XUtil helpers that don't touch Win32, kept apart so tests/ can build and benchmark them on their own
+//
+namespace XUtil
+{
+	uint64_t MurmurHash64A(const void *Key, size_t Len, uint64_t Seed = 0);
+
+	uintptr_t FindPattern(uintptr_t StartAddress, uintptr_t MaxSize, const char *Mask);
+	std::vector<uintptr_t> FindPatterns(uintptr_t StartAddress, uintptr_t MaxSize, const char *Mask);
+}
\ No newline at end of file
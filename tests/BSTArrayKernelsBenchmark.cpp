@@ -0,0 +1,107 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "BSTArrayKernels.h"
+
+//
+// Google Benchmark timings for the BSTArray search kernels at every instruction set level the CPU has, from 16 to 1M
+// elements. Searches miss on purpose, so every element is compared (the worst case for sub_1405B31C0, which scans
+// the form array for each lookup). Not part of ctest; run it from a release build.
+//
+using namespace BSTArrayKernels;
+
+namespace
+{
+	// First argument is the ISA level, second the element count
+	bool PinISA(benchmark::State& State)
+	{
+		const ISA level = (ISA)State.range(0);
+
+		SetISA(level);
+
+		if (GetISA() != level)
+		{
+			State.SkipWithError("Not supported by this CPU");
+			return false;
+		}
+
+		return true;
+	}
+
+	template<typename E>
+	std::vector<E> MakeData(size_t Count)
+	{
+		std::vector<E> data(Count);
+
+		for (size_t i = 0; i < Count; i++)
+			data[i] = (E)(0x10000 + i * 16);
+
+		return data;
+	}
+
+	void BM_Find64(benchmark::State& State)
+	{
+		if (!PinISA(State))
+			return;
+
+		const auto data = MakeData<uint64_t>(State.range(1));
+
+		for (auto _ : State)
+			benchmark::DoNotOptimize(Find64(data.data(), 0, (uint32_t)data.size(), 1));
+
+		State.SetItemsProcessed(State.iterations() * State.range(1));
+	}
+
+	void BM_Find32(benchmark::State& State)
+	{
+		if (!PinISA(State))
+			return;
+
+		const auto data = MakeData<uint32_t>(State.range(1));
+
+		for (auto _ : State)
+			benchmark::DoNotOptimize(Find32(data.data(), 0, (uint32_t)data.size(), 1));
+
+		State.SetItemsProcessed(State.iterations() * State.range(1));
+	}
+
+	void BM_Count64(benchmark::State& State)
+	{
+		if (!PinISA(State))
+			return;
+
+		const auto data = MakeData<uint64_t>(State.range(1));
+
+		for (auto _ : State)
+			benchmark::DoNotOptimize(Count64(data.data(), (uint32_t)data.size(), 1));
+
+		State.SetItemsProcessed(State.iterations() * State.range(1));
+	}
+
+	void BM_ContainsAny64(benchmark::State& State)
+	{
+		if (!PinISA(State))
+			return;
+
+		const auto data = MakeData<uint64_t>(State.range(1));
+		const uint64_t values[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+		for (auto _ : State)
+			benchmark::DoNotOptimize(ContainsAny64(data.data(), (uint32_t)data.size(), values, 8));
+
+		State.SetItemsProcessed(State.iterations() * State.range(1));
+	}
+
+	void Levels(benchmark::internal::Benchmark *Benchmark)
+	{
+		Benchmark->ArgNames({ "isa", "n" });
+		Benchmark->ArgsProduct({ { (int)ISA::Scalar, (int)ISA::SSE41, (int)ISA::AVX2, (int)ISA::AVX512 },
+			benchmark::CreateRange(16, 1 << 20, 4) });
+	}
+}
+
+BENCHMARK(BM_Find64)->Apply(Levels);
+BENCHMARK(BM_Find32)->Apply(Levels);
+BENCHMARK(BM_Count64)->Apply(Levels);
+BENCHMARK(BM_ContainsAny64)->Apply(Levels);
+
+BENCHMARK_MAIN();
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include <random>
+#include <vector>
+#include "BSTArrayKernels.h"
+#include "Check.h"
+
+using namespace BSTArrayKernels;
+
+namespace
+{
+	const char *ISAName(ISA Level)
+	{
+		switch (Level)
+		{
+		case ISA::SSE41: return "SSE4.1";
+		case ISA::AVX2: return "AVX2";
+		case ISA::AVX512: return "AVX-512";
+		default: return "scalar";
+		}
+	}
+
+	//
+	// Plain loops with the same contracts as the kernels, 0xFFFFFFFF when nothing is found
+	//
+	template<typename E>
+	uint32_t ReferenceFind(const std::vector<E>& Data, uint32_t Start, uint32_t End, E Value)
+	{
+		for (uint32_t i = Start; i < End; i++)
+		{
+			if (Data[i] == Value)
+				return i;
+		}
+
+		return 0xFFFFFFFF;
+	}
+
+	template<typename E>
+	uint32_t ReferenceFindLast(const std::vector<E>& Data, uint32_t End, E Value)
+	{
+		for (uint32_t i = End; i-- > 0;)
+		{
+			if (Data[i] == Value)
+				return i;
+		}
+
+		return 0xFFFFFFFF;
+	}
+
+	template<typename E>
+	uint32_t ReferenceCount(const std::vector<E>& Data, uint32_t End, E Value)
+	{
+		uint32_t count = 0;
+
+		for (uint32_t i = 0; i < End; i++)
+			count += (Data[i] == Value) ? 1 : 0;
+
+		return count;
+	}
+
+	template<typename E>
+	bool ReferenceContainsAny(const std::vector<E>& Data, uint32_t End, const std::vector<E>& Values)
+	{
+		for (uint32_t i = 0; i < End; i++)
+		{
+			for (E value : Values)
+			{
+				if (Data[i] == value)
+					return true;
+			}
+		}
+
+		return false;
+	}
+
+	//
+	// Every size up to a few unrolled blocks of the widest kernel, so each loop's remainder is hit. Values are drawn from
+	// a small range to get repeats, and the high bits are set so a compare that drops half the element shows up.
+	//
+	template<typename E>
+	void TestAgainstReference(ISA Level)
+	{
+		std::mt19937_64 rng(Level == ISA::Scalar ? 1 : (uint64_t)Level * 7);
+		const E highBits = (E)((sizeof(E) == 8) ? 0xABCD000000000000ull : 0xAB000000u);
+
+		for (uint32_t size = 0; size <= 300; size++)
+		{
+			// One spare element past the end that always matches, so reading past End can't go unnoticed
+			std::vector<E> data(size + 1);
+
+			for (uint32_t i = 0; i < size; i++)
+				data[i] = highBits | (E)(rng() % 64);
+
+			for (int trial = 0; trial < 4; trial++)
+			{
+				const E value = (trial == 3) ? (E)0x12345 : (E)(highBits | (E)(rng() % 64));
+				const uint32_t start = size ? (uint32_t)(rng() % (size + 1)) : 0;
+				data[size] = value;
+
+				CHECK_EQ(Find(data.data(), start, size, value), ReferenceFind(data, start, size, value));
+				CHECK_EQ(Find(data.data(), 0, size, value), ReferenceFind(data, 0, size, value));
+				CHECK_EQ(FindLast(data.data(), size, value), ReferenceFindLast(data, size, value));
+				CHECK_EQ(Count(data.data(), size, value), ReferenceCount(data, size, value));
+
+				// Same low bits, different high bits
+				const E lookalike = (E)(value ^ ((E)1 << (sizeof(E) * 8 - 1)));
+				CHECK_EQ(Find(data.data(), 0, size, lookalike), ReferenceFind(data, 0, size, lookalike));
+			}
+
+			// A single match at each end
+			if (size > 0)
+			{
+				std::vector<E> single(size + 1, (E)1);
+				single[size] = (E)2;
+
+				single[0] = (E)2;
+				CHECK_EQ(Find(single.data(), 0, size, (E)2), 0u);
+				CHECK_EQ(FindLast(single.data(), size, (E)2), 0u);
+				CHECK_EQ(Count(single.data(), size, (E)2), 1u);
+
+				single[0] = (E)1;
+				single[size - 1] = (E)2;
+				CHECK_EQ(Find(single.data(), 0, size, (E)2), size - 1);
+				CHECK_EQ(FindLast(single.data(), size, (E)2), size - 1);
+			}
+
+			// More values than one group of broadcasts, with and without a hit in the last group
+			std::vector<E> values;
+
+			for (uint32_t i = 0; i < 19; i++)
+				values.push_back((E)(0x1000 + i));
+
+			CHECK_EQ(ContainsAny(data.data(), size, values.data(), (uint32_t)values.size()), ReferenceContainsAny(data, size, values));
+
+			values.push_back(size ? data[size / 2] : (E)0x1000);
+			CHECK_EQ(ContainsAny(data.data(), size, values.data(), (uint32_t)values.size()), ReferenceContainsAny(data, size, values));
+			CHECK(!ContainsAny(data.data(), size, values.data(), 0));
+		}
+	}
+
+	void TestPointers()
+	{
+		// The typed wrappers compare the bit patterns, which is what sub_1405B31C0 does with form pointers
+		std::vector<int> storage(64);
+		std::vector<const int *> pointers;
+
+		for (auto& value : storage)
+			pointers.push_back(&value);
+
+		CHECK_EQ(Find(pointers.data(), 0, (uint32_t)pointers.size(), (const int *)&storage[37]), 37u);
+		CHECK_EQ(Find(pointers.data(), 38, (uint32_t)pointers.size(), (const int *)&storage[37]), 0xFFFFFFFFu);
+		CHECK_EQ(FindLast(pointers.data(), (uint32_t)pointers.size(), (const int *)&storage[5]), 5u);
+		CHECK_EQ(Count(pointers.data(), (uint32_t)pointers.size(), (const int *)nullptr), 0u);
+	}
+}
+
+int main()
+{
+	const ISA detected = GetISA();
+
+	// Scalar is the reference point, every wider level the CPU has is checked the same way
+	for (ISA level : { ISA::Scalar, ISA::SSE41, ISA::AVX2, ISA::AVX512 })
+	{
+		if (level > detected)
+			continue;
+
+		SetISA(level);
+		CHECK(GetISA() == level);
+
+		TestAgainstReference<uint32_t>(level);
+		TestAgainstReference<uint64_t>(level);
+		TestPointers();
+
+		printf("BSTArrayKernels: %s checked\n", ISAName(level));
+	}
+
+	// Can't go past the CPU
+	SetISA(ISA::AVX512);
+	CHECK(GetISA() == detected);
+
+	if (CheckFailures() == 0)
+		printf("BSTArrayKernels: all checks passed\n");
+
+	return CheckFailures();
+}
\ No newline at end of file
@@ -0,0 +1,255 @@
+#include <stdlib.h>
+#include <string.h>
+#include <unordered_map>
+#include <vector>
+#include "EngineStubs.h"
+#include "BSTArray.h"
+#include "Check.h"
+
+//
+// The test supplies the heap BSTArrayHeapAllocator allocates from. Fresh and freed blocks are filled with a pattern so
+// reading memory that was never copied, or that was released by a reallocation, shows up as wrong values.
+//
+bool g_EngineHeapPatched = true;
+
+namespace
+{
+	struct TestHeap
+	{
+		std::unordered_map<void *, size_t> Live;
+		size_t Allocations = 0;
+		size_t Frees = 0;
+		size_t LastSize = 0;
+	} g_Heap;
+}
+
+void *MemoryManager::Allocate(MemoryManager *Manager, size_t Size, uint32_t Alignment, bool Aligned)
+{
+	void *memory = malloc(Size);
+	memset(memory, 0xCD, Size);
+
+	g_Heap.Live.emplace(memory, Size);
+	g_Heap.Allocations++;
+	g_Heap.LastSize = Size;
+	return memory;
+}
+
+void MemoryManager::Deallocate(MemoryManager *Manager, void *Memory, bool Aligned)
+{
+	auto itr = g_Heap.Live.find(Memory);
+	CHECK(itr != g_Heap.Live.end());
+
+	if (itr == g_Heap.Live.end())
+		return;
+
+	memset(Memory, 0xDD, itr->second);
+	g_Heap.Live.erase(itr);
+	g_Heap.Frees++;
+	free(Memory);
+}
+
+size_t MemoryManager::Size(MemoryManager *Manager, void *Memory)
+{
+	auto itr = g_Heap.Live.find(Memory);
+	return (itr != g_Heap.Live.end()) ? itr->second : 0;
+}
+
+namespace
+{
+	using Values = std::vector<uint32_t>;
+
+	template<typename T>
+	std::vector<T> Contents(const BSTArray<T>& Array)
+	{
+		std::vector<T> contents;
+
+		for (uint32_t i = 0; i < Array.QSize(); i++)
+			contents.push_back(Array[i]);
+
+		return contents;
+	}
+
+	// Locally built arrays have to give their buffer back by hand, see BSTArray
+	template<typename T>
+	void Release(BSTArray<T>& Array)
+	{
+		Array.clear();
+		Array.shrink_to_fit();
+
+		CHECK(Array.QBuffer() == nullptr);
+		CHECK_EQ(Array.QAllocSize(), 0u);
+	}
+
+	void TestGrowth()
+	{
+		BSTArray<uint32_t> array;
+		Values expected;
+
+		CHECK(array.QEmpty());
+		CHECK(array.QBuffer() == nullptr);
+
+		// Capacity doubles from 4, so 1000 appends only reallocate a handful of times
+		const size_t allocations = g_Heap.Allocations;
+
+		for (uint32_t i = 0; i < 1000; i++)
+		{
+			array.push_back(i * 3);
+			expected.push_back(i * 3);
+		}
+
+		CHECK(Contents(array) == expected);
+		CHECK_EQ(array.QAllocSize(), 1024u);
+		CHECK_EQ(g_Heap.Allocations - allocations, (size_t)9);
+		CHECK_EQ(g_Heap.Live.size(), (size_t)1);
+		CHECK_EQ(g_Heap.LastSize, 1024 * sizeof(uint32_t));
+
+		// reserve never shrinks, and growing past it still doubles
+		array.reserve(10);
+		CHECK_EQ(array.QAllocSize(), 1024u);
+
+		array.reserve(1030);
+		CHECK_EQ(array.QAllocSize(), 1030u);
+		CHECK(Contents(array) == expected);
+
+		for (uint32_t i = 0; i < 31; i++)
+			array.push_back(i);
+
+		CHECK_EQ(array.QAllocSize(), 2060u);
+		CHECK_EQ(array.QSize(), 1031u);
+
+		Release(array);
+		CHECK(g_Heap.Live.empty());
+	}
+
+	void TestAliasedAppend()
+	{
+		BSTArray<uint32_t> array;
+		array.append_range({ 1, 2, 3, 4 });
+		CHECK_EQ(array.QAllocSize(), 4u);
+
+		// The argument lives in the buffer that's freed by the reallocation
+		array.push_back(array[0]);
+		CHECK(Contents(array) == (Values { 1, 2, 3, 4, 1 }));
+
+		array.push_back(array.back());
+		array.push_back(array.back());
+		array.push_back(array.back());
+		CHECK_EQ(array.QAllocSize(), 8u);
+		array.push_back(array[1]);
+		CHECK(Contents(array) == (Values { 1, 2, 3, 4, 1, 1, 1, 1, 2 }));
+
+		// Appending a slice of itself across a reallocation
+		array.append_range(&array[1], 8);
+		CHECK_EQ(array.QAllocSize(), 32u);
+		CHECK(Contents(array) == (Values { 1, 2, 3, 4, 1, 1, 1, 1, 2, 2, 3, 4, 1, 1, 1, 1, 2 }));
+
+		array.append_range(nullptr, 0);
+		CHECK_EQ(array.QSize(), 17u);
+
+		Release(array);
+		CHECK(g_Heap.Live.empty());
+	}
+
+	void TestErase()
+	{
+		BSTArray<uint32_t> array;
+
+		for (uint32_t i = 0; i < 100; i++)
+			array.push_back(i);
+
+		const uint32_t capacity = array.QAllocSize();
+		const size_t allocations = g_Heap.Allocations;
+
+		// Survivors keep their order, nothing is reallocated
+		CHECK_EQ(array.erase_if([](uint32_t Value) { return (Value % 3) != 0; }), 66u);
+		CHECK_EQ(array.QSize(), 34u);
+		CHECK_EQ(array.QAllocSize(), capacity);
+		CHECK_EQ(g_Heap.Allocations, allocations);
+
+		Values expected;
+
+		for (uint32_t i = 0; i < 100; i += 3)
+			expected.push_back(i);
+
+		CHECK(Contents(array) == expected);
+
+		CHECK_EQ(array.erase_if([](uint32_t) { return false; }), 0u);
+		CHECK_EQ(array.erase_if([](uint32_t Value) { return Value < 50; }), 17u);
+		CHECK_EQ(array.front(), 51u);
+		CHECK_EQ(array.erase_if([](uint32_t) { return true; }), 17u);
+		CHECK(array.QEmpty());
+
+		// Erasing from an empty array is a no-op
+		CHECK_EQ(array.erase_if([](uint32_t) { return true; }), 0u);
+
+		Release(array);
+		CHECK(g_Heap.Live.empty());
+	}
+
+	void TestShrink()
+	{
+		BSTArray<uint64_t> array;
+
+		for (uint64_t i = 0; i < 40; i++)
+			array.push_back(i << 40);
+
+		CHECK_EQ(array.QAllocSize(), 64u);
+
+		// Down to the exact size, contents moved over
+		array.shrink_to_fit();
+		CHECK_EQ(array.QAllocSize(), 40u);
+		CHECK_EQ(g_Heap.LastSize, 40 * sizeof(uint64_t));
+		CHECK_EQ(array[39], (uint64_t)39 << 40);
+
+		// Already tight
+		const size_t allocations = g_Heap.Allocations;
+		array.shrink_to_fit();
+		CHECK_EQ(g_Heap.Allocations, allocations);
+
+		// clear keeps the buffer, shrinking an empty array frees it
+		array.clear();
+		CHECK_EQ(array.QAllocSize(), 40u);
+		CHECK_EQ(g_Heap.Live.size(), (size_t)1);
+
+		array.shrink_to_fit();
+		CHECK(array.QBuffer() == nullptr);
+		CHECK(g_Heap.Live.empty());
+
+		// And it can grow again afterwards
+		array.push_back(7);
+		CHECK_EQ(array.QAllocSize(), 4u);
+		CHECK_EQ(array[0], 7u);
+
+		Release(array);
+		CHECK(g_Heap.Live.empty());
+	}
+
+	void TestRequiresMemoryPatch()
+	{
+		// Without MemoryPatch the engine heap owns array buffers, so resizing one is flagged
+		g_EngineHeapPatched = false;
+
+		BSTArray<uint32_t> array;
+		const int failures = AssertFailures();
+		array.push_back(1);
+		CHECK_EQ(AssertFailures(), failures + 1);
+
+		g_EngineHeapPatched = true;
+		Release(array);
+		CHECK(g_Heap.Live.empty());
+	}
+}
+
+int main()
+{
+	TestGrowth();
+	TestAliasedAppend();
+	TestErase();
+	TestShrink();
+	TestRequiresMemoryPatch();
+
+	if (CheckFailures() == 0)
+		printf("BSTArray: all checks passed\n");
+
+	return CheckFailures();
+}
\ No newline at end of file
@@ -0,0 +1,242 @@
+#include <vector>
+#include "CategoryTreeModel.h"
+#include "Check.h"
+
+namespace
+{
+	using Model = CategoryTreeModel;
+	using NodeId = CategoryTreeModel::NodeId;
+	using Nodes = std::vector<NodeId>;
+
+	Nodes Children(const Model& Tree, NodeId Parent)
+	{
+		Nodes children;
+
+		for (NodeId child = Tree.FirstChild(Parent); child != Model::npos; child = Tree.NextSibling(child))
+			children.push_back(child);
+
+		// The backward links have to agree with the forward ones
+		Nodes reversed;
+
+		if (!children.empty())
+		{
+			for (NodeId child = children.back(); child != Model::npos; child = Tree.PrevSibling(child))
+				reversed.insert(reversed.begin(), child);
+		}
+
+		CHECK(reversed == children);
+		CHECK_EQ(Tree.ChildCount(Parent), (uint32_t)children.size());
+		return children;
+	}
+
+	Nodes PreOrder(const Model& Tree, NodeId Node)
+	{
+		Nodes order;
+		Tree.ForEach(Node, [&order](NodeId Current) { order.push_back(Current); });
+		return order;
+	}
+
+	void TestInsert()
+	{
+		Model tree;
+
+		CHECK_EQ(tree.Count(), 0u);
+		CHECK(tree.IsValid(Model::Root));
+		CHECK(tree.IsCreated(Model::Root));
+		CHECK(tree.ChildrenCreated(Model::Root));
+
+		const NodeId b = tree.Insert(Model::Root, Model::Placement::Last);
+		const NodeId a = tree.Insert(Model::Root, Model::Placement::First);
+		const NodeId d = tree.Insert(Model::Root, Model::Placement::Last);
+		const NodeId c = tree.Insert(Model::Root, Model::Placement::After, b);
+
+		CHECK(Children(tree, Model::Root) == (Nodes { a, b, c, d }));
+		CHECK_EQ(tree.Count(), 4u);
+		CHECK_EQ(tree.Parent(c), Model::Root);
+
+		// After the last child, and after something that isn't a sibling, both append
+		const NodeId e = tree.Insert(Model::Root, Model::Placement::After, d);
+		const NodeId a1 = tree.Insert(a, Model::Placement::Last);
+		const NodeId f = tree.Insert(Model::Root, Model::Placement::After, a1);
+		const NodeId g = tree.Insert(Model::Root, Model::Placement::After, Model::npos);
+		const NodeId h = tree.Insert(Model::Root, Model::Placement::After, Model::Root);
+
+		CHECK(Children(tree, Model::Root) == (Nodes { a, b, c, d, e, f, g, h }));
+		CHECK(Children(tree, a) == (Nodes { a1 }));
+
+		// Invalid parents are rejected
+		CHECK_EQ(tree.Insert(Model::npos, Model::Placement::Last), Model::npos);
+		CHECK_EQ(tree.Insert(1000, Model::Placement::First), Model::npos);
+
+		// New nodes have nothing pending below them
+		CHECK(tree.ChildrenCreated(a1));
+		CHECK(!tree.HasPendingChildren(a));
+	}
+
+	void TestRemove()
+	{
+		Model tree;
+
+		const NodeId a = tree.Insert(Model::Root, Model::Placement::Last);
+		const NodeId b = tree.Insert(Model::Root, Model::Placement::Last);
+		const NodeId a1 = tree.Insert(a, Model::Placement::Last);
+		const NodeId a2 = tree.Insert(a, Model::Placement::Last);
+		const NodeId a11 = tree.Insert(a1, Model::Placement::Last);
+		const NodeId b1 = tree.Insert(b, Model::Placement::Last);
+
+		CHECK(PreOrder(tree, Model::Root) == (Nodes { a, a1, a11, a2, b, b1 }));
+		CHECK(PreOrder(tree, a1) == (Nodes { a1, a11 }));
+
+		tree.Bind(a11, 0x1000);
+		tree.SetCreated(a11, 0x2000);
+		tree.SetCreated(a2, 0x3000);
+		CHECK_EQ(tree.CreatedCount(), 2u);
+
+		// Removing a subtree drops its handles and counts
+		tree.Remove(a1);
+		CHECK(!tree.IsValid(a1));
+		CHECK(!tree.IsValid(a11));
+		CHECK_EQ(tree.Count(), 4u);
+		CHECK_EQ(tree.CreatedCount(), 1u);
+		CHECK_EQ(tree.Find(0x1000), Model::npos);
+		CHECK_EQ(tree.Find(0x2000), Model::npos);
+		CHECK(Children(tree, a) == (Nodes { a2 }));
+
+		// Removed nodes answer like unknown ones
+		CHECK_EQ(tree.Parent(a11), Model::npos);
+		CHECK_EQ(tree.ChildCount(a1), 0u);
+		CHECK_EQ(tree.Insert(a1, Model::Placement::Last), Model::npos);
+		tree.Remove(a1);
+		CHECK_EQ(tree.Count(), 4u);
+
+		// A removed sibling can't be inserted after
+		const NodeId b2 = tree.Insert(b, Model::Placement::After, a11);
+		CHECK(Children(tree, b) == (Nodes { b1, b2 }));
+
+		tree.Remove(a);
+		CHECK(Children(tree, Model::Root) == (Nodes { b }));
+		CHECK_EQ(tree.CreatedCount(), 0u);
+
+		// Removing the root clears everything
+		tree.Remove(Model::Root);
+		CHECK_EQ(tree.Count(), 0u);
+		CHECK(tree.IsValid(Model::Root));
+		CHECK(!tree.IsValid(b));
+		CHECK_EQ(tree.FirstChild(Model::Root), Model::npos);
+	}
+
+	void TestHandles()
+	{
+		Model tree;
+
+		const NodeId a = tree.Insert(Model::Root, Model::Placement::Last);
+		const NodeId b = tree.Insert(Model::Root, Model::Placement::Last);
+
+		CHECK(!tree.IsCreated(a));
+		CHECK_EQ(tree.Find(0), Model::npos);
+
+		// A pending node is known by its placeholder, then by the control's handle as well once created
+		tree.Bind(a, 0x7FFF000000000001);
+		CHECK_EQ(tree.Find(0x7FFF000000000001), a);
+
+		tree.SetCreated(a, 0x5000);
+		CHECK(tree.IsCreated(a));
+		CHECK_EQ(tree.CreatedHandle(a), 0x5000u);
+		CHECK_EQ(tree.Find(0x5000), a);
+		CHECK_EQ(tree.Find(0x7FFF000000000001), a);
+
+		// Created directly: both handles are the same, and rebinding keeps the shared entry
+		tree.SetCreated(b, 0x6000);
+		tree.Bind(b, 0x6000);
+		CHECK_EQ(tree.Handle(b), 0x6000u);
+		tree.Bind(b, 0x6001);
+		CHECK_EQ(tree.Find(0x6000), b);
+		CHECK_EQ(tree.Find(0x6001), b);
+
+		tree.SetCreated(b, 0);
+		CHECK(!tree.IsCreated(b));
+		CHECK_EQ(tree.CreatedCount(), 1u);
+		CHECK_EQ(tree.Find(0x6000), Model::npos);
+		CHECK_EQ(tree.Find(0x6001), b);
+
+		// The root can't be bound
+		tree.Bind(Model::Root, 0x9000);
+		tree.SetCreated(Model::Root, 0x9000);
+		CHECK_EQ(tree.Find(0x9000), Model::npos);
+		CHECK_EQ(tree.CreatedCount(), 1u);
+	}
+
+	void TestPending()
+	{
+		// root -> a -> a1 -> a11, with a and a1 collapsed before their children were created
+		Model tree;
+
+		const NodeId a = tree.Insert(Model::Root, Model::Placement::Last);
+		const NodeId a1 = tree.Insert(a, Model::Placement::Last);
+		const NodeId a11 = tree.Insert(a1, Model::Placement::Last);
+		const NodeId b = tree.Insert(Model::Root, Model::Placement::Last);
+
+		tree.SetChildrenCreated(a, false);
+		tree.SetChildrenCreated(a1, false);
+		tree.SetChildrenCreated(b, false);
+
+		CHECK(tree.HasPendingChildren(a));
+		CHECK(tree.HasPendingChildren(a1));
+		CHECK(!tree.HasPendingChildren(b));
+		CHECK(!tree.HasPendingChildren(a11));
+
+		CHECK(tree.PendingAncestors(a11) == (Nodes { a, a1 }));
+		CHECK(tree.PendingAncestors(a1) == (Nodes { a }));
+		CHECK(tree.PendingAncestors(a) == (Nodes {}));
+		CHECK(tree.PendingAncestors(Model::npos) == (Nodes {}));
+
+		tree.SetChildrenCreated(a, true);
+		CHECK(tree.PendingAncestors(a11) == (Nodes { a1 }));
+
+		// The root's children always exist
+		tree.SetChildrenCreated(Model::Root, false);
+		CHECK(tree.ChildrenCreated(Model::Root));
+	}
+
+	void TestLarge()
+	{
+		// A wide and deep tree, then every other top level subtree removed
+		Model tree;
+		Nodes top;
+
+		for (uint32_t i = 0; i < 200; i++)
+		{
+			const NodeId node = tree.Insert(Model::Root, (i % 2) ? Model::Placement::Last : Model::Placement::First);
+			top.push_back(node);
+
+			NodeId parent = node;
+
+			for (uint32_t depth = 0; depth < 20; depth++)
+				parent = tree.Insert(parent, Model::Placement::Last);
+		}
+
+		CHECK_EQ(tree.Count(), 200u * 21u);
+		CHECK_EQ((uint32_t)PreOrder(tree, Model::Root).size(), tree.Count());
+
+		for (uint32_t i = 0; i < top.size(); i += 2)
+			tree.Remove(top[i]);
+
+		CHECK_EQ(tree.Count(), 100u * 21u);
+		CHECK_EQ((uint32_t)Children(tree, Model::Root).size(), 100u);
+		CHECK_EQ((uint32_t)PreOrder(tree, Model::Root).size(), tree.Count());
+	}
+}
+
+int main()
+{
+	TestInsert();
+	TestRemove();
+	TestHandles();
+	TestPending();
+	TestLarge();
+
+	if (CheckFailures() == 0)
+		printf("CategoryTreeModel: all checks passed\n");
+
+	return CheckFailures();
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdio.h>
+
+//
+// Minimal assertion helpers. A failed check is reported and counted, and the test keeps going so one run shows every
+// failure. main() returns CheckFailures() so ctest sees the result.
+//
+#define CHECK(Cond) \
+	do \
+	{ \
+		if (!(Cond)) \
+		{ \
+			fprintf(stderr, "%s(%d): CHECK(%s) failed\n", __FILE__, __LINE__, #Cond); \
+			CheckFailures()++; \
+		} \
+	} while (0)
+
+#define CHECK_EQ(A, B) \
+	do \
+	{ \
+		const auto a_ = (A); \
+		const auto b_ = (B); \
+		if (!(a_ == b_)) \
+		{ \
+			fprintf(stderr, "%s(%d): CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #A, #B, (long long)a_, (long long)b_); \
+			CheckFailures()++; \
+		} \
+	} while (0)
+
+inline int& CheckFailures()
+{
+	static int failures = 0;
+	return failures;
+}
\ No newline at end of file
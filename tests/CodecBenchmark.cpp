@@ -0,0 +1,404 @@
+#include <stdio.h>
+#include <string.h>
+#include <zlib.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "PluginRecords.h"
+
+#if HAVE_LIBDEFLATE
+#include <libdeflate.h>
+#endif
+
+#if HAVE_ZLIBNG
+#include <zlib-ng.h>
+#endif
+
+//
+// Inflate benchmark over the compressed records of real plugins, so changes to hk_inflate can be judged on our own
+// data. Not part of ctest.
+//
+//   CodecBenchmark [--save corpus.bin] [--json results.json] [--passes N] [--threads N] <plugin or corpus>...
+//
+// Inputs are plugin files or corpus files written by --save. Every codec decodes the whole corpus once untimed, then
+// --passes timed times (default 5). Each record is timed on its own for the latency percentiles, throughput is the
+// decompressed size over the fastest pass. Outputs are checked against stock zlib. Results go to stdout as JSON, or to
+// the --json file, and a summary is printed to stderr.
+//
+// Codecs: "zlib" (inflateInit/inflate/inflateEnd per record, the CK's stock path), "zlib-reused" (one stream, reset
+// per record), "libdeflate-per-call" (a decompressor allocated per record, the original hk_inflate), "libdeflate-reused"
+// (one decompressor), "libdeflate-thread-local" (a decompressor per thread behind a thread_local holder, what
+// hk_inflate and the inflate pipeline workers do now) and "zlib-ng". The libdeflate and zlib-ng codecs are only built
+// when the library is found.
+//
+// --threads splits each pass across N threads, like the inflate pipeline's workers. Codecs that share one state
+// between calls are skipped then.
+//
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+	using PluginRecords::CompressedRecord;
+
+	// Decodes a record into Out (DecompressedSize bytes), returns the number of bytes written or -1
+	using DecodeFunction = std::function<int64_t(const CompressedRecord& Record, uint8_t *Out)>;
+
+	struct Codec
+	{
+		const char *Name;
+		DecodeFunction Decode;
+		bool ThreadSafe = true;
+	};
+
+	struct Result
+	{
+		const char *Name;
+		double BestPassMs = 0;
+		double ThroughputMBs = 0;
+		double P50 = 0, P90 = 0, P99 = 0, P999 = 0, Max = 0;
+		uint32_t Failures = 0;
+	};
+
+	bool ReadFile(const char *Path, std::vector<uint8_t>& Data)
+	{
+		FILE *f = fopen(Path, "rb");
+
+		if (!f)
+			return false;
+
+		fseek(f, 0, SEEK_END);
+		Data.resize(ftell(f));
+		fseek(f, 0, SEEK_SET);
+
+		const bool ok = Data.empty() || fread(Data.data(), Data.size(), 1, f) == 1;
+		fclose(f);
+		return ok;
+	}
+
+	bool LoadInput(const char *Path, std::vector<CompressedRecord>& Records)
+	{
+		std::vector<uint8_t> data;
+
+		if (!ReadFile(Path, data))
+		{
+			fprintf(stderr, "%s: can't read file\n", Path);
+			return false;
+		}
+
+		if (data.size() >= sizeof(uint32_t) && PluginRecords::ReadU32(data.data()) == PluginRecords::CorpusMagic)
+		{
+			FILE *f = fopen(Path, "rb");
+			const bool ok = PluginRecords::ReadCorpus(f, Records);
+			fclose(f);
+
+			if (!ok)
+				fprintf(stderr, "%s: truncated corpus\n", Path);
+
+			return ok;
+		}
+
+		// A truncated plugin still contributes the records before the damage
+		if (!PluginRecords::ExtractCompressedRecords(data.data(), data.size(), Records))
+			fprintf(stderr, "%s: truncated or not a plugin, stopped early\n", Path);
+
+		return true;
+	}
+
+	int64_t InflateOnce(z_stream& Stream, const CompressedRecord& Record, uint8_t *Out)
+	{
+		Stream.next_in = (Bytef *)Record.Data.data();
+		Stream.avail_in = (uInt)Record.Data.size();
+		Stream.next_out = Out;
+		Stream.avail_out = Record.DecompressedSize;
+
+		if (inflate(&Stream, Z_FINISH) != Z_STREAM_END)
+			return -1;
+
+		return Stream.total_out;
+	}
+
+	double Percentile(const std::vector<double>& Sorted, double Fraction)
+	{
+		if (Sorted.empty())
+			return 0;
+
+		return Sorted[std::min(Sorted.size() - 1, (size_t)(Fraction * Sorted.size()))];
+	}
+
+	//
+	// Decodes Records[First, Last) on the calling thread, timing each record
+	//
+	void DecodeRange(const Codec& Codec, const std::vector<CompressedRecord>& Records, size_t First, size_t Last,
+		uint32_t MaxSize, std::vector<double>& Latencies)
+	{
+		std::vector<uint8_t> out(MaxSize);
+
+		for (size_t i = First; i < Last; i++)
+		{
+			const auto start = Clock::now();
+			Codec.Decode(Records[i], out.data());
+			Latencies.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+		}
+	}
+
+	Result Run(const Codec& Codec, const std::vector<CompressedRecord>& Records, const std::vector<uLong>& Checksums,
+		uint64_t DecompressedBytes, uint32_t Passes, uint32_t Threads)
+	{
+		Result result;
+		result.Name = Codec.Name;
+
+		std::vector<uint8_t> out;
+		std::vector<double> latencies;
+		latencies.reserve(Records.size() * Passes);
+		double bestPass = 1e30;
+
+		// Untimed pass checks the output and warms the caches
+		for (size_t i = 0; i < Records.size(); i++)
+		{
+			out.resize(std::max<size_t>(out.size(), Records[i].DecompressedSize));
+			const int64_t bytes = Codec.Decode(Records[i], out.data());
+
+			if (bytes != Records[i].DecompressedSize || crc32(0, out.data(), (uInt)bytes) != Checksums[i])
+				result.Failures++;
+		}
+
+		for (uint32_t pass = 0; pass < Passes; pass++)
+		{
+			std::vector<std::vector<double>> threadLatencies(Threads);
+			const auto passStart = Clock::now();
+
+			if (Threads <= 1)
+			{
+				DecodeRange(Codec, Records, 0, Records.size(), (uint32_t)out.size(), threadLatencies[0]);
+			}
+			else
+			{
+				std::vector<std::thread> workers;
+
+				// Contiguous slices, so each thread walks the records in file order like a worker scanning a plugin
+				for (uint32_t t = 0; t < Threads; t++)
+				{
+					workers.emplace_back(DecodeRange, std::cref(Codec), std::cref(Records), Records.size() * t / Threads,
+						Records.size() * (t + 1) / Threads, (uint32_t)out.size(), std::ref(threadLatencies[t]));
+				}
+
+				for (auto& worker : workers)
+					worker.join();
+			}
+
+			bestPass = std::min(bestPass, std::chrono::duration<double, std::milli>(Clock::now() - passStart).count());
+
+			for (auto& samples : threadLatencies)
+				latencies.insert(latencies.end(), samples.begin(), samples.end());
+		}
+
+		std::sort(latencies.begin(), latencies.end());
+
+		result.BestPassMs = bestPass;
+		result.ThroughputMBs = (DecompressedBytes / (1024.0 * 1024.0)) / (bestPass / 1000.0);
+		result.P50 = Percentile(latencies, 0.50);
+		result.P90 = Percentile(latencies, 0.90);
+		result.P99 = Percentile(latencies, 0.99);
+		result.P999 = Percentile(latencies, 0.999);
+		result.Max = latencies.empty() ? 0 : latencies.back();
+		return result;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	const char *savePath = nullptr;
+	const char *jsonPath = nullptr;
+	uint32_t passes = 5;
+	uint32_t threads = 1;
+	std::vector<const char *> inputs;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "--save") && i + 1 < argc)
+			savePath = argv[++i];
+		else if (!strcmp(argv[i], "--json") && i + 1 < argc)
+			jsonPath = argv[++i];
+		else if (!strcmp(argv[i], "--passes") && i + 1 < argc)
+			passes = std::max(1, atoi(argv[++i]));
+		else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+			threads = std::max(1, atoi(argv[++i]));
+		else
+			inputs.push_back(argv[i]);
+	}
+
+	if (inputs.empty())
+	{
+		fprintf(stderr, "usage: %s [--save corpus.bin] [--json results.json] [--passes N] [--threads N] <plugin or corpus>...\n", argv[0]);
+		return 1;
+	}
+
+	std::vector<CompressedRecord> records;
+
+	for (const char *input : inputs)
+	{
+		if (!LoadInput(input, records))
+			return 1;
+	}
+
+	if (savePath)
+	{
+		FILE *f = fopen(savePath, "wb");
+		const bool ok = f && PluginRecords::WriteCorpus(f, records);
+
+		if (f)
+			fclose(f);
+
+		if (!ok)
+		{
+			fprintf(stderr, "%s: can't write corpus\n", savePath);
+			return 1;
+		}
+	}
+
+	// Stock zlib is the reference. Records it can't decode aren't valid zlib streams and are left out.
+	std::vector<uLong> checksums;
+	std::vector<uint8_t> out;
+	uint64_t compressedBytes = 0;
+	uint64_t decompressedBytes = 0;
+	size_t rejected = 0;
+
+	records.erase(std::remove_if(records.begin(), records.end(), [&](const CompressedRecord& Record)
+	{
+		out.resize(std::max<size_t>(out.size(), Record.DecompressedSize));
+		uLongf outBytes = Record.DecompressedSize;
+
+		if (uncompress(out.data(), &outBytes, Record.Data.data(), (uLong)Record.Data.size()) != Z_OK || outBytes != Record.DecompressedSize)
+		{
+			rejected++;
+			return true;
+		}
+
+		checksums.push_back(crc32(0, out.data(), (uInt)outBytes));
+		compressedBytes += Record.Data.size();
+		decompressedBytes += outBytes;
+		return false;
+	}), records.end());
+
+	z_stream reusedStream = {};
+	inflateInit(&reusedStream);
+
+	std::vector<Codec> codecs =
+	{
+		{ "zlib", [](const CompressedRecord& Record, uint8_t *Out) -> int64_t
+		{
+			z_stream stream = {};
+			inflateInit(&stream);
+			const int64_t bytes = InflateOnce(stream, Record, Out);
+			inflateEnd(&stream);
+			return bytes;
+		} },
+		{ "zlib-reused", [&reusedStream](const CompressedRecord& Record, uint8_t *Out) -> int64_t
+		{
+			inflateReset(&reusedStream);
+			return InflateOnce(reusedStream, Record, Out);
+		}, false },
+	};
+
+#if HAVE_LIBDEFLATE
+	libdeflate_decompressor *reusedDecompressor = libdeflate_alloc_decompressor();
+
+	codecs.push_back({ "libdeflate-per-call", [](const CompressedRecord& Record, uint8_t *Out) -> int64_t
+	{
+		libdeflate_decompressor *decompressor = libdeflate_alloc_decompressor();
+		size_t bytes = 0;
+		auto result = libdeflate_zlib_decompress(decompressor, Record.Data.data(), Record.Data.size(), Out, Record.DecompressedSize, &bytes);
+		libdeflate_free_decompressor(decompressor);
+		return (result == LIBDEFLATE_SUCCESS) ? (int64_t)bytes : -1;
+	} });
+
+	codecs.push_back({ "libdeflate-reused", [reusedDecompressor](const CompressedRecord& Record, uint8_t *Out) -> int64_t
+	{
+		size_t bytes = 0;
+		auto result = libdeflate_zlib_decompress(reusedDecompressor, Record.Data.data(), Record.Data.size(), Out, Record.DecompressedSize, &bytes);
+		return (result == LIBDEFLATE_SUCCESS) ? (int64_t)bytes : -1;
+	}, false });
+
+	codecs.push_back({ "libdeflate-thread-local", [](const CompressedRecord& Record, uint8_t *Out) -> int64_t
+	{
+		// Same holder as InflatePipeline::ThreadDecompressor, freed when the thread exits
+		struct ThreadDecompressor
+		{
+			libdeflate_decompressor *Decompressor = libdeflate_alloc_decompressor();
+
+			~ThreadDecompressor()
+			{
+				libdeflate_free_decompressor(Decompressor);
+			}
+		};
+
+		thread_local ThreadDecompressor holder;
+		size_t bytes = 0;
+		auto result = libdeflate_zlib_decompress(holder.Decompressor, Record.Data.data(), Record.Data.size(), Out, Record.DecompressedSize, &bytes);
+		return (result == LIBDEFLATE_SUCCESS) ? (int64_t)bytes : -1;
+	} });
+#endif
+
+#if HAVE_ZLIBNG
+	codecs.push_back({ "zlib-ng", [](const CompressedRecord& Record, uint8_t *Out) -> int64_t
+	{
+		size_t bytes = Record.DecompressedSize;
+		return (zng_uncompress(Out, &bytes, Record.Data.data(), Record.Data.size()) == Z_OK) ? (int64_t)bytes : -1;
+	} });
+#endif
+
+	std::vector<Result> results;
+
+	for (auto& codec : codecs)
+	{
+		if (threads > 1 && !codec.ThreadSafe)
+			continue;
+
+		results.push_back(Run(codec, records, checksums, decompressedBytes, passes, threads));
+	}
+
+	inflateEnd(&reusedStream);
+
+#if HAVE_LIBDEFLATE
+	libdeflate_free_decompressor(reusedDecompressor);
+#endif
+
+	fprintf(stderr, "%zu records, %.2f MB compressed, %.2f MB decompressed, %zu rejected\n", records.size(),
+		compressedBytes / (1024.0 * 1024.0), decompressedBytes / (1024.0 * 1024.0), rejected);
+
+	for (auto& result : results)
+	{
+		fprintf(stderr, "%-24s %9.2f MB/s   p50 %8.0f ns   p99 %8.0f ns   max %9.0f ns   %u failed\n", result.Name,
+			result.ThroughputMBs, result.P50, result.P99, result.Max, result.Failures);
+	}
+
+	FILE *json = jsonPath ? fopen(jsonPath, "w") : stdout;
+
+	if (!json)
+	{
+		fprintf(stderr, "%s: can't write results\n", jsonPath);
+		return 1;
+	}
+
+	fprintf(json, "{\n  \"corpus\": { \"records\": %zu, \"rejected\": %zu, \"compressed_bytes\": %llu, \"decompressed_bytes\": %llu },\n",
+		records.size(), rejected, (unsigned long long)compressedBytes, (unsigned long long)decompressedBytes);
+	fprintf(json, "  \"passes\": %u,\n  \"threads\": %u,\n  \"codecs\": [\n", passes, threads);
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		auto& r = results[i];
+
+		fprintf(json, "    { \"name\": \"%s\", \"best_pass_ms\": %.3f, \"throughput_mb_s\": %.2f, \"p50_ns\": %.0f, \"p90_ns\": %.0f, "
+			"\"p99_ns\": %.0f, \"p999_ns\": %.0f, \"max_ns\": %.0f, \"failures\": %u }%s\n", r.Name, r.BestPassMs, r.ThroughputMBs,
+			r.P50, r.P90, r.P99, r.P999, r.Max, r.Failures, (i + 1 < results.size()) ? "," : "");
+	}
+
+	fprintf(json, "  ]\n}\n");
+
+	if (json != stdout)
+		fclose(json);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,439 @@
+#include <aio.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+
+//
+// Cold cache read benchmark for the file IO patch's reader modes, on Linux. The editor's DirectStreamReader
+// (FILE_FLAG_NO_BUFFERING plus overlapped reads) is Windows only, so this runs the same design with the same constants
+// on O_DIRECT and POSIX AIO: a ring of eight 4 MB aligned blocks kept filled ahead of the consumer. It is compared with
+// mapping the whole file and copying out of the mapping (the mapped mode) and with plain buffered reads (the fallback).
+// Not part of ctest.
+//
+//   ColdReadBenchmark [--size MB] [--passes N] [file]
+//
+// Without a file, one of --size MB (default 1024) is generated next to the executable. Each pass evicts the file from
+// the page cache with posix_fadvise first, then reads it front to back in record sized pieces the way the plugin
+// loader does. The page cache footprint left behind is reported as well.
+//
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	class Reader
+	{
+	public:
+		virtual ~Reader() = default;
+		virtual bool Open(const char *Path, uint64_t FileLength) = 0;
+		virtual uint64_t Read(uint64_t Position, void *Buffer, size_t Size) = 0;
+	};
+
+	class BufferedReader : public Reader
+	{
+	private:
+		int m_File = -1;
+
+	public:
+		~BufferedReader() override
+		{
+			if (m_File != -1)
+				close(m_File);
+		}
+
+		bool Open(const char *Path, uint64_t FileLength) override
+		{
+			m_File = open(Path, O_RDONLY);
+			return m_File != -1;
+		}
+
+		uint64_t Read(uint64_t Position, void *Buffer, size_t Size) override
+		{
+			const ssize_t bytes = pread(m_File, Buffer, Size, Position);
+			return (bytes < 0) ? 0 : bytes;
+		}
+	};
+
+	class MappedReader : public Reader
+	{
+	private:
+		const uint8_t *m_View = nullptr;
+		uint64_t m_FileLength = 0;
+
+	public:
+		~MappedReader() override
+		{
+			if (m_View)
+				munmap((void *)m_View, m_FileLength);
+		}
+
+		bool Open(const char *Path, uint64_t FileLength) override
+		{
+			const int file = open(Path, O_RDONLY);
+
+			if (file == -1)
+				return false;
+
+			void *view = mmap(nullptr, FileLength, PROT_READ, MAP_SHARED, file, 0);
+			close(file);
+
+			m_View = (view != MAP_FAILED) ? (const uint8_t *)view : nullptr;
+			m_FileLength = FileLength;
+			return m_View != nullptr;
+		}
+
+		uint64_t Read(uint64_t Position, void *Buffer, size_t Size) override
+		{
+			const uint64_t count = std::min<uint64_t>(Size, m_FileLength - std::min(Position, m_FileLength));
+			memcpy(Buffer, m_View + Position, count);
+			return count;
+		}
+	};
+
+	//
+	// DirectStreamReader with OVERLAPPED swapped for aiocb. The ring logic is unchanged.
+	//
+	class DirectRingReader : public Reader
+	{
+	private:
+		constexpr static uint32_t BlockSize = 4 * 1024 * 1024;
+		constexpr static uint32_t BlockCount = 8;
+
+		struct Block
+		{
+			uint8_t *Data;
+			uint64_t Offset;
+			uint32_t Length;
+			bool Pending;
+			aiocb Request;
+		};
+
+		int m_File = -1;
+		uint64_t m_FileLength = 0;
+		Block m_Blocks[BlockCount] = {};
+
+		Block& SlotFor(uint64_t Offset)
+		{
+			return m_Blocks[(Offset / BlockSize) % BlockCount];
+		}
+
+		bool Complete(Block& B)
+		{
+			if (!B.Pending)
+				return B.Offset != UINT64_MAX;
+
+			const aiocb *list[] = { &B.Request };
+			B.Pending = false;
+
+			while (aio_error(&B.Request) == EINPROGRESS)
+				aio_suspend(list, 1, nullptr);
+
+			const ssize_t bytesRead = aio_return(&B.Request);
+
+			if (bytesRead < 0)
+			{
+				B.Offset = UINT64_MAX;
+				return false;
+			}
+
+			B.Length = (uint32_t)bytesRead;
+			return true;
+		}
+
+		bool Issue(Block& B, uint64_t Offset)
+		{
+			Complete(B);
+
+			B.Offset = Offset;
+			B.Length = 0;
+			B.Request = {};
+			B.Request.aio_fildes = m_File;
+			B.Request.aio_buf = B.Data;
+			B.Request.aio_nbytes = BlockSize;
+			B.Request.aio_offset = (off_t)Offset;
+
+			if (aio_read(&B.Request) != 0)
+			{
+				B.Offset = UINT64_MAX;
+				return false;
+			}
+
+			B.Pending = true;
+			return true;
+		}
+
+		Block *Acquire(uint64_t Offset)
+		{
+			Block& b = SlotFor(Offset);
+
+			if (b.Offset != Offset && !Issue(b, Offset))
+				return nullptr;
+
+			if (!Complete(b))
+				return nullptr;
+
+			return &b;
+		}
+
+		void Prefetch(uint64_t Offset)
+		{
+			for (uint32_t i = 1; i < BlockCount; i++)
+			{
+				const uint64_t next = Offset + (uint64_t)i * BlockSize;
+
+				if (next >= m_FileLength)
+					break;
+
+				if (Block& b = SlotFor(next); b.Offset != next)
+					Issue(b, next);
+			}
+		}
+
+	public:
+		~DirectRingReader() override
+		{
+			for (auto& b : m_Blocks)
+			{
+				if (b.Pending)
+				{
+					aio_cancel(m_File, &b.Request);
+					Complete(b);
+				}
+
+				free(b.Data);
+			}
+
+			if (m_File != -1)
+				close(m_File);
+		}
+
+		bool Open(const char *Path, uint64_t FileLength) override
+		{
+			m_File = open(Path, O_RDONLY | O_DIRECT);
+			m_FileLength = FileLength;
+
+			if (m_File == -1)
+				return false;
+
+			for (auto& b : m_Blocks)
+			{
+				b.Data = (uint8_t *)aligned_alloc(4096, BlockSize);
+				b.Offset = UINT64_MAX;
+
+				if (!b.Data)
+					return false;
+			}
+
+			Prefetch(0);
+			Issue(SlotFor(0), 0);
+			return true;
+		}
+
+		uint64_t Read(uint64_t Position, void *Buffer, size_t Size) override
+		{
+			uint64_t copied = 0;
+
+			while (copied < Size && Position < m_FileLength)
+			{
+				const uint64_t blockOffset = Position - (Position % BlockSize);
+				Block *b = Acquire(blockOffset);
+
+				if (!b || Position >= b->Offset + b->Length)
+					break;
+
+				const uint64_t count = std::min<uint64_t>(b->Offset + b->Length - Position, Size - copied);
+				memcpy((uint8_t *)Buffer + copied, &b->Data[Position - b->Offset], count);
+
+				if (Position == blockOffset || Position + count == b->Offset + b->Length)
+					Prefetch(blockOffset);
+
+				copied += count;
+				Position += count;
+			}
+
+			return copied;
+		}
+	};
+
+	void Evict(const char *Path)
+	{
+		const int file = open(Path, O_RDONLY);
+
+		if (file == -1)
+			return;
+
+		fdatasync(file);
+		posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+		close(file);
+	}
+
+	double ResidentMB(const char *Path, uint64_t FileLength)
+	{
+		const int file = open(Path, O_RDONLY);
+		void *view = mmap(nullptr, FileLength, PROT_READ, MAP_SHARED, file, 0);
+		close(file);
+
+		if (view == MAP_FAILED)
+			return -1;
+
+		const size_t pageSize = sysconf(_SC_PAGESIZE);
+		std::vector<unsigned char> pages((FileLength + pageSize - 1) / pageSize);
+		mincore(view, FileLength, pages.data());
+		munmap(view, FileLength);
+
+		const size_t resident = std::count_if(pages.begin(), pages.end(), [](unsigned char P) { return (P & 1) != 0; });
+		return resident * (double)pageSize / (1024.0 * 1024.0);
+	}
+
+	//
+	// Reads the whole file as a stream of 24 byte record headers and payloads, mostly small with the odd large one
+	//
+	uint64_t Consume(Reader& Source, uint64_t FileLength)
+	{
+		std::mt19937 rng(1);
+		std::vector<uint8_t> buffer(2 * 1024 * 1024);
+		uint64_t checksum = 0;
+
+		for (uint64_t position = 0; position < FileLength;)
+		{
+			const size_t payload = (rng() % 64 == 0) ? 64 * 1024 + rng() % (1024 * 1024) : 100 + rng() % 8192;
+
+			for (size_t size : { (size_t)24, payload })
+			{
+				const size_t count = std::min<uint64_t>(size, FileLength - position);
+				const uint64_t bytes = Source.Read(position, buffer.data(), count);
+
+				if (bytes == 0)
+					return checksum;
+
+				checksum += buffer[0] + buffer[bytes - 1];
+				position += bytes;
+			}
+		}
+
+		return checksum;
+	}
+
+	bool CreateFile(const char *Path, uint64_t Size)
+	{
+		FILE *f = fopen(Path, "wb");
+
+		if (!f)
+			return false;
+
+		std::mt19937_64 rng(2);
+		std::vector<uint64_t> chunk(1024 * 1024 / sizeof(uint64_t));
+
+		for (uint64_t written = 0; written < Size; written += 1024 * 1024)
+		{
+			for (auto& value : chunk)
+				value = rng();
+
+			fwrite(chunk.data(), 1024 * 1024, 1, f);
+		}
+
+		fclose(f);
+		return true;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	uint64_t sizeMB = 1024;
+	uint32_t passes = 3;
+	const char *path = nullptr;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "--size") && i + 1 < argc)
+			sizeMB = std::max(1, atoi(argv[++i]));
+		else if (!strcmp(argv[i], "--passes") && i + 1 < argc)
+			passes = std::max(1, atoi(argv[++i]));
+		else
+			path = argv[i];
+	}
+
+	if (!path)
+	{
+		path = "cold_read_benchmark.dat";
+
+		struct stat info;
+
+		if (stat(path, &info) != 0 || (uint64_t)info.st_size != sizeMB * 1024 * 1024)
+		{
+			fprintf(stderr, "Creating %s (%llu MB)\n", path, (unsigned long long)sizeMB);
+
+			if (!CreateFile(path, sizeMB * 1024 * 1024))
+				return 1;
+		}
+	}
+
+	struct stat info;
+
+	if (stat(path, &info) != 0)
+	{
+		fprintf(stderr, "%s: can't open file\n", path);
+		return 1;
+	}
+
+	const uint64_t fileLength = info.st_size;
+	const double fileMB = fileLength / (1024.0 * 1024.0);
+
+	const struct
+	{
+		const char *Name;
+		std::unique_ptr<Reader>(*Create)();
+	} modes[] =
+	{
+		{ "buffered read", []() -> std::unique_ptr<Reader> { return std::make_unique<BufferedReader>(); } },
+		{ "mapped", []() -> std::unique_ptr<Reader> { return std::make_unique<MappedReader>(); } },
+		{ "direct ring (8 x 4 MB)", []() -> std::unique_ptr<Reader> { return std::make_unique<DirectRingReader>(); } },
+	};
+
+	printf("%s, %.0f MB, best of %u cold passes\n", path, fileMB, passes);
+	uint64_t expected = 0;
+
+	for (auto& mode : modes)
+	{
+		double best = 1e30;
+		double resident = 0;
+
+		for (uint32_t pass = 0; pass < passes; pass++)
+		{
+			Evict(path);
+
+			auto reader = mode.Create();
+			const auto start = Clock::now();
+
+			if (!reader->Open(path, fileLength))
+			{
+				fprintf(stderr, "%s: can't open for %s\n", path, mode.Name);
+				return 1;
+			}
+
+			const uint64_t checksum = Consume(*reader, fileLength);
+			best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+
+			if (expected == 0)
+				expected = checksum;
+			else if (checksum != expected)
+				fprintf(stderr, "%s: read different data\n", mode.Name);
+
+			reader.reset();
+			resident = ResidentMB(path, fileLength);
+		}
+
+		printf("%-24s %9.1f MB/s %9.1f MB left in the page cache\n", mode.Name, fileMB / best, resident);
+	}
+
+	Evict(path);
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+//
+// Just enough of common.h to include the engine container headers (TES/BSTArray.h) outside the editor. Failed asserts
+// are reported and counted instead of breaking into the debugger, so a test can check that one fires.
+//
+inline int& AssertFailures()
+{
+	static int failures = 0;
+	return failures;
+}
+
+#define AssertMsg(Cond, Msg) \
+	if (!(Cond)) \
+	{ \
+		fprintf(stderr, "%s(%d): assert %s: %s\n", __FILE__, __LINE__, #Cond, Msg); \
+		AssertFailures()++; \
+	}
+
+// Layouts are checked by the editor build, GCC and Clang place base class members differently
+#define static_assert_offset(Structure, Member, Offset) static_assert(true, "")
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include <stdio.h>
+#include <chrono>
+#include <future>
+#include <random>
+#include <string>
+#include "FilterEngine.h"
+
+//
+// Times FilterEngine on 1M synthetic rows without any UI. Not part of ctest; run it from a release build.
+//
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	double Milliseconds(Clock::time_point Start, Clock::time_point End)
+	{
+		return std::chrono::duration<double, std::milli>(End - Start).count();
+	}
+}
+
+int main()
+{
+	constexpr uint32_t RowCount = 1000000;
+	constexpr int Iterations = 20;
+	const char *words[] = { "Weapon", "Armor", "Iron", "Steel", "Sword", "Helmet", "Laser", "Rifle", "Pipe", "Mod", "Receiver", "Barrel", "Combat", "Leather", "Raider", "Synth" };
+
+	std::mt19937 rng(1);
+	auto snapshot = std::make_shared<FilterSnapshot>();
+
+	auto start = Clock::now();
+	snapshot->Reserve(RowCount, RowCount * 24);
+
+	for (uint32_t i = 0; i < RowCount; i++)
+	{
+		std::string editorId;
+
+		for (int j = 0; j < 3; j++)
+			editorId += words[rng() % std::size(words)];
+
+		editorId += std::to_string(i);
+		snapshot->Add(((rng() % 4) << 24) | i, editorId.data(), editorId.size(), rng() % 8, rng() % 4);
+	}
+
+	printf("%-36s %8.2f ms\n", "Build snapshot", Milliseconds(start, Clock::now()));
+
+	const struct
+	{
+		const char *Name;
+		FilterQuery Query;
+	} cases[] =
+	{
+		{ "Empty text", { "" } },
+		{ "Common text \"iron\"", { "iron" } },
+		{ "Rare text \"swordswordsword\"", { "swordswordsword" } },
+		{ "No match \"zzz\"", { "zzz" } },
+		{ "Text with spaces \"iron sword\"", { "iron sword" } },
+		{ "Text + type + flags", { "steel", 3, 1, 2 } },
+	};
+
+	std::vector<uint32_t> rows;
+
+	for (const auto& c : cases)
+	{
+		start = Clock::now();
+
+		for (int i = 0; i < Iterations; i++)
+			FilterEngine::Evaluate(*snapshot, c.Query, rows);
+
+		printf("%-36s %8.2f ms (%u rows)\n", c.Name, Milliseconds(start, Clock::now()) / Iterations, (uint32_t)rows.size());
+	}
+
+	// Round trip through the worker, including the handoff of the result vector
+	FilterEngine engine;
+	start = Clock::now();
+
+	for (int i = 0; i < Iterations; i++)
+	{
+		std::promise<size_t> done;
+		engine.Submit(snapshot, { "iron" }, [&done](uint64_t, std::vector<uint32_t>&& Rows) { done.set_value(Rows.size()); });
+		done.get_future().wait();
+	}
+
+	printf("%-36s %8.2f ms\n", "Submit to callback \"iron\"", Milliseconds(start, Clock::now()) / Iterations);
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,249 @@
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "FilterEngine.h"
+#include "Check.h"
+
+namespace
+{
+	enum : uint32_t
+	{
+		TypeWeapon = 1,
+		TypeArmor = 2,
+
+		FlagDeleted = 1,
+		FlagModified = 2,
+	};
+
+	std::shared_ptr<FilterSnapshot> MakeSnapshot()
+	{
+		struct Entry
+		{
+			uint32_t FormID;
+			const char *EditorID;
+			uint32_t Type;
+			uint32_t Flags;
+		};
+
+		const Entry entries[] =
+		{
+			{ 0x00012345, "IronSword", TypeWeapon, 0 },
+			{ 0x0001ABCD, "Iron Sword Rusty", TypeWeapon, FlagModified },
+			{ 0x00020000, "SteelArmor", TypeArmor, 0 },
+			{ 0x0A000001, "ModArmor0x1", TypeArmor, FlagModified | FlagDeleted },
+			{ 0xFF000800, "iRoNhElMeT", TypeArmor, FlagDeleted },
+			{ 0x00000ADD, "Pad", TypeWeapon, 0 },
+		};
+
+		auto snapshot = std::make_shared<FilterSnapshot>();
+		snapshot->Reserve(std::size(entries), 64);
+
+		for (const Entry& entry : entries)
+			snapshot->Add(entry.FormID, entry.EditorID, strlen(entry.EditorID), entry.Type, entry.Flags);
+
+		return snapshot;
+	}
+
+	std::vector<uint32_t> Run(const FilterSnapshot& Snapshot, const char *Text, uint32_t Type = 0, uint32_t FlagsSet = 0, uint32_t FlagsClear = 0)
+	{
+		FilterQuery query;
+		query.Text = Text;
+		query.Type = Type;
+		query.FlagsSet = FlagsSet;
+		query.FlagsClear = FlagsClear;
+
+		std::vector<uint32_t> rows;
+		CHECK(FilterEngine::Evaluate(Snapshot, query, rows));
+		return rows;
+	}
+
+	using Rows = std::vector<uint32_t>;
+
+	void TestSnapshot()
+	{
+		auto snapshot = MakeSnapshot();
+
+		CHECK_EQ(snapshot->Count(), 6u);
+		CHECK(snapshot->GetEditorID(1) == "iron sword rusty");
+		CHECK_EQ(snapshot->GetRow(3).FormID, 0x0A000001u);
+		CHECK_EQ(snapshot->GetRow(3).Flags, (uint32_t)(FlagModified | FlagDeleted));
+	}
+
+	void TestLiteral()
+	{
+		auto snapshot = MakeSnapshot();
+
+		CHECK(Run(*snapshot, "") == (Rows { 0, 1, 2, 3, 4, 5 }));
+		CHECK(Run(*snapshot, "IRON") == (Rows { 0, 1, 4 }));
+
+		// Spaces are part of the text, not term separators
+		CHECK(Run(*snapshot, "iron sword") == (Rows { 1 }));
+		CHECK(Run(*snapshot, "sword rusty") == (Rows { 1 }));
+		CHECK(Run(*snapshot, "iron rusty") == (Rows {}));
+
+		// Hex looking text only matches editor IDs, never form IDs
+		CHECK(Run(*snapshot, "add") == (Rows {}));
+		CHECK(Run(*snapshot, "ad") == (Rows { 5 }));
+		CHECK(Run(*snapshot, "12345") == (Rows {}));
+	}
+
+	void TestHexText()
+	{
+		auto snapshot = MakeSnapshot();
+
+		// No form ID syntax, "0x" text is editor ID text like any other, same as the editor's filter
+		CHECK(Run(*snapshot, "0x") == (Rows { 3 }));
+		CHECK(Run(*snapshot, "0X1") == (Rows { 3 }));
+		CHECK(Run(*snapshot, "r0x1") == (Rows { 3 }));
+		CHECK(Run(*snapshot, "0x0001") == (Rows {}));
+		CHECK(Run(*snapshot, "0x00012345") == (Rows {}));
+		CHECK(Run(*snapshot, "0xFF000800") == (Rows {}));
+	}
+
+	void TestTypeAndFlags()
+	{
+		auto snapshot = MakeSnapshot();
+
+		CHECK(Run(*snapshot, "", TypeArmor) == (Rows { 2, 3, 4 }));
+		CHECK(Run(*snapshot, "iron", TypeWeapon) == (Rows { 0, 1 }));
+		CHECK(Run(*snapshot, "", 0, FlagModified) == (Rows { 1, 3 }));
+		CHECK(Run(*snapshot, "", 0, 0, FlagDeleted) == (Rows { 0, 1, 2, 5 }));
+		CHECK(Run(*snapshot, "", TypeArmor, FlagDeleted, FlagModified) == (Rows { 4 }));
+		CHECK(Run(*snapshot, "", TypeWeapon, 0, FlagModified) == (Rows { 0, 5 }));
+	}
+
+	void TestAbandonedEvaluate()
+	{
+		auto snapshot = MakeSnapshot();
+		std::atomic<uint64_t> generation(5);
+		std::vector<uint32_t> rows;
+
+		CHECK(FilterEngine::Evaluate(*snapshot, FilterQuery(), rows, &generation, 5));
+		CHECK_EQ(rows.size(), (size_t)6);
+		CHECK(!FilterEngine::Evaluate(*snapshot, FilterQuery(), rows, &generation, 4));
+	}
+
+	//
+	// Collects callbacks from the worker thread. Optionally blocks inside the first one so the test controls what's
+	// queued behind it.
+	//
+	struct Results
+	{
+		std::mutex Mutex;
+		std::condition_variable Changed;
+		std::vector<std::pair<uint64_t, std::vector<uint32_t>>> Completed;
+		bool Blocking = false;
+		bool Blocked = false;
+
+		FilterEngine::Callback Make()
+		{
+			return [this](uint64_t Generation, std::vector<uint32_t>&& Rows)
+			{
+				std::unique_lock<std::mutex> lock(Mutex);
+				Completed.emplace_back(Generation, std::move(Rows));
+
+				Blocked = Blocking;
+				Changed.notify_all();
+				Changed.wait(lock, [this]() { return !Blocked; });
+			};
+		}
+
+		bool WaitFor(size_t Count)
+		{
+			std::unique_lock<std::mutex> lock(Mutex);
+			return Changed.wait_for(lock, std::chrono::seconds(10), [&]() { return Completed.size() >= Count; });
+		}
+
+		void Release()
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			Blocking = false;
+			Blocked = false;
+			Changed.notify_all();
+		}
+	};
+
+	FilterQuery Query(const char *Text)
+	{
+		FilterQuery query;
+		query.Text = Text;
+		return query;
+	}
+
+	void TestEngine()
+	{
+		std::shared_ptr<const FilterSnapshot> snapshot = MakeSnapshot();
+		Results results;
+		results.Blocking = true;
+
+		{
+			FilterEngine engine;
+			CHECK_EQ(engine.CurrentGeneration(), 0u);
+
+			// The first query completes and parks the worker inside its callback
+			const uint64_t first = engine.Submit(snapshot, Query("iron"), results.Make());
+			CHECK_EQ(first, 1u);
+			CHECK(results.WaitFor(1));
+
+			// Queued behind it: a query that gets superseded by the next one before the worker sees it
+			const uint64_t superseded = engine.Submit(snapshot, Query("sword"), results.Make());
+			const uint64_t latest = engine.Submit(snapshot, Query("steel"), results.Make());
+			CHECK(latest > superseded);
+
+			results.Release();
+			CHECK(results.WaitFor(2));
+
+			engine.Cancel();
+			CHECK(engine.CurrentGeneration() > latest);
+
+			const uint64_t last = engine.Submit(snapshot, Query("pad"), results.Make());
+			CHECK(results.WaitFor(3));
+			CHECK_EQ(engine.CurrentGeneration(), last);
+
+			std::lock_guard<std::mutex> lock(results.Mutex);
+			CHECK_EQ(results.Completed.size(), (size_t)3);
+
+			if (results.Completed.size() == 3)
+			{
+				CHECK_EQ(results.Completed[0].first, first);
+				CHECK(results.Completed[0].second == (Rows { 0, 1, 4 }));
+				CHECK_EQ(results.Completed[1].first, latest);
+				CHECK(results.Completed[1].second == (Rows { 2 }));
+				CHECK_EQ(results.Completed[2].first, last);
+				CHECK(results.Completed[2].second == (Rows { 5 }));
+			}
+		}
+
+		// Cancelling a queued query means its callback never runs, even after the engine shuts down
+		Results cancelled;
+		cancelled.Blocking = true;
+
+		{
+			FilterEngine engine;
+
+			engine.Submit(snapshot, Query(""), cancelled.Make());
+			CHECK(cancelled.WaitFor(1));
+
+			engine.Submit(snapshot, Query("iron"), cancelled.Make());
+			engine.Cancel();
+			cancelled.Release();
+		}
+
+		CHECK_EQ(cancelled.Completed.size(), (size_t)1);
+	}
+}
+
+int main()
+{
+	TestSnapshot();
+	TestLiteral();
+	TestHexText();
+	TestTypeAndFlags();
+	TestAbandonedEvaluate();
+	TestEngine();
+
+	if (CheckFailures() == 0)
+		printf("FilterEngine: all checks passed\n");
+
+	return CheckFailures();
+}
\ No newline at end of file
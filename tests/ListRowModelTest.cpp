@@ -0,0 +1,250 @@
+#include <stdlib.h>
+#include <vector>
+#include "ListRowModel.h"
+#include "Check.h"
+
+namespace
+{
+	ListRowModel::Row R(uintptr_t Value)
+	{
+		return (ListRowModel::Row)Value;
+	}
+
+	uintptr_t V(ListRowModel::Row Value)
+	{
+		return (uintptr_t)Value;
+	}
+
+	// Visible rows as plain values, for comparing against an expected list
+	std::vector<uintptr_t> Visible(const ListRowModel& Model)
+	{
+		std::vector<uintptr_t> values;
+
+		for (uint32_t i = 0; i < Model.Count(); i++)
+			values.push_back(V(Model.At(i)));
+
+		return values;
+	}
+
+	void TestInsertRemove()
+	{
+		ListRowModel model;
+
+		CHECK_EQ(model.Count(), 0u);
+		CHECK_EQ(model.At(0), nullptr);
+
+		// Appends, then inserts at the front and in the middle
+		CHECK_EQ(model.Insert(ListRowModel::npos, R(1)), 0u);
+		CHECK_EQ(model.Insert(ListRowModel::npos, R(3)), 1u);
+		CHECK_EQ(model.Insert(0, R(0)), 0u);
+		CHECK_EQ(model.Insert(2, R(2)), 2u);
+		CHECK(Visible(model) == (std::vector<uintptr_t> { 0, 1, 2, 3 }));
+
+		const uint64_t version = model.Version();
+		CHECK(model.Set(1, R(10)));
+		CHECK(model.Version() != version);
+		CHECK(!model.Set(4, R(11)));
+
+		CHECK(model.Remove(0));
+		CHECK(Visible(model) == (std::vector<uintptr_t> { 10, 2, 3 }));
+		CHECK(!model.Remove(3));
+
+		const ListRowModel::Row batch[] = { R(4), R(5) };
+		model.Append(batch, 2);
+		CHECK(Visible(model) == (std::vector<uintptr_t> { 10, 2, 3, 4, 5 }));
+
+		model.Clear();
+		CHECK_EQ(model.Count(), 0u);
+		CHECK_EQ(model.TotalCount(), 0u);
+	}
+
+	void TestFilter()
+	{
+		ListRowModel model;
+
+		for (uintptr_t i = 0; i < 10; i++)
+			model.Insert(ListRowModel::npos, R(i));
+
+		const uint64_t version = model.Version();
+		model.Filter([](ListRowModel::Row Value) { return (V(Value) % 2) == 0; });
+
+		// Filtering doesn't count as a row change
+		CHECK_EQ(model.Version(), version);
+		CHECK(model.IsFiltered());
+		CHECK(Visible(model) == (std::vector<uintptr_t> { 0, 2, 4, 6, 8 }));
+		CHECK_EQ(model.TotalCount(), 10u);
+		CHECK_EQ(model.RowIndex(2), 4u);
+		CHECK_EQ(model.VisibleIndex(4), 2u);
+		CHECK_EQ(model.VisibleIndex(5), ListRowModel::npos);
+
+		// Inserted rows go through the predicate. A rejected one is stored but has no visible index.
+		CHECK_EQ(model.Insert(1, R(12)), 1u);
+		CHECK_EQ(model.Insert(1, R(13)), ListRowModel::npos);
+		CHECK(Visible(model) == (std::vector<uintptr_t> { 0, 12, 2, 4, 6, 8 }));
+		CHECK_EQ(model.TotalCount(), 12u);
+
+		// Removing a visible row shifts the ones after it
+		CHECK(model.Remove(0));
+		CHECK(Visible(model) == (std::vector<uintptr_t> { 12, 2, 4, 6, 8 }));
+
+		// A supplied visible set replaces the predicate. Out of range and duplicate indices are dropped.
+		model.SetVisibleRows({ 5, 0, 0, 100 });
+		CHECK_EQ(model.Count(), 2u);
+		CHECK_EQ(V(model.At(0)), V(model.AtRow(0)));
+		CHECK_EQ(V(model.At(1)), V(model.AtRow(5)));
+
+		model.ClearFilter();
+		CHECK(!model.IsFiltered());
+		CHECK_EQ(model.Count(), 11u);
+	}
+
+	void TestSort()
+	{
+		ListRowModel model;
+		const uintptr_t values[] = { 5, 3, 9, 3, 1, 7 };
+
+		for (uintptr_t value : values)
+			model.Insert(ListRowModel::npos, R(value));
+
+		model.Sort([](ListRowModel::Row A, ListRowModel::Row B) { return V(A) < V(B); });
+		CHECK(Visible(model) == (std::vector<uintptr_t> { 1, 3, 3, 5, 7, 9 }));
+
+		// Hidden rows are sorted too, and the same rows stay visible afterwards
+		model.Filter([](ListRowModel::Row Value) { return V(Value) > 4; });
+		CHECK(Visible(model) == (std::vector<uintptr_t> { 5, 7, 9 }));
+
+		model.Sort([](ListRowModel::Row A, ListRowModel::Row B) { return V(A) > V(B); });
+		CHECK(Visible(model) == (std::vector<uintptr_t> { 9, 7, 5 }));
+		CHECK_EQ(V(model.AtRow(5)), 1u);
+
+		// SortRows compares row indices from before the sort and is stable
+		ListRowModel pairs;
+		const uintptr_t keys[] = { 2, 1, 2, 1 };
+
+		for (uintptr_t i = 0; i < 4; i++)
+			pairs.Insert(ListRowModel::npos, R(i));
+
+		pairs.SortRows([&keys](uint32_t A, uint32_t B) { return keys[A] < keys[B]; });
+		CHECK(Visible(pairs) == (std::vector<uintptr_t> { 1, 3, 0, 2 }));
+	}
+
+	void TestFind()
+	{
+		// Short lists are scanned, long ones go through the lookup table. Both must give the same answers.
+		for (uint32_t count : { 16u, 1000u })
+		{
+			ListRowModel model;
+
+			for (uint32_t i = 0; i < count; i++)
+				model.Insert(ListRowModel::npos, R(100 + (i % (count / 2))));
+
+			const uint32_t half = count / 2;
+
+			CHECK_EQ(model.Find(R(100)), 0u);
+			CHECK_EQ(model.Find(R(100), 1), half);
+			CHECK_EQ(model.Find(R(100), half + 1), ListRowModel::npos);
+			CHECK_EQ(model.Find(R(99)), ListRowModel::npos);
+
+			// Appends patch the table, inserts and sets rebuild it
+			model.Insert(ListRowModel::npos, R(1));
+			CHECK_EQ(model.Find(R(1)), count);
+
+			model.Insert(0, R(2));
+			CHECK_EQ(model.Find(R(2)), 0u);
+			CHECK_EQ(model.Find(R(1)), count + 1);
+
+			model.Set(1, R(3));
+			CHECK_EQ(model.Find(R(3)), 1u);
+			CHECK_EQ(model.Find(R(100)), half + 1);
+
+			// Indices are visible ones while filtered
+			model.Filter([](ListRowModel::Row Value) { return V(Value) != 101; });
+			CHECK_EQ(model.Find(R(101)), ListRowModel::npos);
+			CHECK_EQ(model.Find(R(102)), 2u);
+		}
+	}
+
+	void TestRandomized()
+	{
+		// Every operation mirrored on a plain vector of (value, visible) pairs
+		ListRowModel model;
+		std::vector<uintptr_t> rows;
+		auto accepts = [](ListRowModel::Row Value) { return (V(Value) % 3) != 0; };
+		bool filtered = false;
+
+		srand(1234);
+
+		for (int step = 0; step < 20000; step++)
+		{
+			const int op = rand() % 10;
+			const uintptr_t value = rand() % 200;
+
+			std::vector<uint32_t> visibleRows;
+
+			for (uint32_t i = 0; i < rows.size(); i++)
+			{
+				if (!filtered || accepts(R(rows[i])))
+					visibleRows.push_back(i);
+			}
+
+			if (op < 4)
+			{
+				const uint32_t index = rand() % (visibleRows.size() + 2);
+				const uint32_t row = (index < visibleRows.size()) ? visibleRows[index] : (uint32_t)rows.size();
+
+				model.Insert(index, R(value));
+				rows.insert(rows.begin() + row, value);
+			}
+			else if (op < 6 && !visibleRows.empty())
+			{
+				const uint32_t index = rand() % visibleRows.size();
+
+				CHECK(model.Remove(index));
+				rows.erase(rows.begin() + visibleRows[index]);
+			}
+			else if (op == 6)
+			{
+				filtered = !filtered;
+
+				if (filtered)
+					model.Filter(accepts);
+				else
+					model.ClearFilter();
+			}
+			else
+			{
+				uint32_t expected = ListRowModel::npos;
+
+				for (uint32_t i = 0; i < visibleRows.size(); i++)
+				{
+					if (rows[visibleRows[i]] == value)
+					{
+						expected = i;
+						break;
+					}
+				}
+
+				CHECK_EQ(model.Find(R(value)), expected);
+			}
+
+			CHECK_EQ(model.TotalCount(), (uint32_t)rows.size());
+
+			if (CheckFailures() > 0)
+				break;
+		}
+	}
+}
+
+int main()
+{
+	TestInsertRemove();
+	TestFilter();
+	TestSort();
+	TestFind();
+	TestRandomized();
+
+	if (CheckFailures() == 0)
+		printf("ListRowModel: all checks passed\n");
+
+	return CheckFailures();
+}
\ No newline at end of file
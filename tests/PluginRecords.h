@@ -0,0 +1,142 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+//
+// Reads the compressed record payloads out of Fallout 4 plugin files (ESM/ESP/ESL) for the codec benchmark. Records and
+// groups share a 24 byte header. A group's size includes its header and its contents follow it directly, so the file
+// can be walked front to back without tracking nesting. Records with the compressed flag store the decompressed size
+// followed by a zlib stream.
+//
+namespace PluginRecords
+{
+	constexpr uint32_t HeaderSize = 24;
+	constexpr uint32_t CompressedFlag = 0x00040000;
+
+	constexpr uint32_t FourCC(const char *Type)
+	{
+		return (uint32_t)Type[0] | ((uint32_t)Type[1] << 8) | ((uint32_t)Type[2] << 16) | ((uint32_t)Type[3] << 24);
+	}
+
+	struct CompressedRecord
+	{
+		uint32_t Type;
+		uint32_t FormID;
+		uint32_t DecompressedSize;
+		std::vector<uint8_t> Data;		// zlib stream
+	};
+
+	inline uint32_t ReadU32(const uint8_t *Data)
+	{
+		uint32_t value;
+		memcpy(&value, Data, sizeof(value));
+		return value;
+	}
+
+	//
+	// Appends every compressed record in a plugin image to Records. Returns false if a header or payload runs past the
+	// end of the file, records found before that point are kept.
+	//
+	inline bool ExtractCompressedRecords(const uint8_t *Data, size_t Size, std::vector<CompressedRecord>& Records)
+	{
+		for (size_t offset = 0; offset < Size;)
+		{
+			if (Size - offset < HeaderSize)
+				return false;
+
+			const uint8_t *header = Data + offset;
+			const uint32_t type = ReadU32(header);
+
+			// Step into the group, its records come next
+			if (type == FourCC("GRUP"))
+			{
+				if (ReadU32(header + 4) < HeaderSize)
+					return false;
+
+				offset += HeaderSize;
+				continue;
+			}
+
+			const uint32_t dataSize = ReadU32(header + 4);
+			const uint32_t flags = ReadU32(header + 8);
+
+			if (Size - offset - HeaderSize < dataSize)
+				return false;
+
+			if ((flags & CompressedFlag) && dataSize >= sizeof(uint32_t))
+			{
+				const uint8_t *payload = header + HeaderSize;
+
+				CompressedRecord record;
+				record.Type = type;
+				record.FormID = ReadU32(header + 12);
+				record.DecompressedSize = ReadU32(payload);
+				record.Data.assign(payload + sizeof(uint32_t), payload + dataSize);
+				Records.push_back(std::move(record));
+			}
+
+			offset += HeaderSize + dataSize;
+		}
+
+		return true;
+	}
+
+	//
+	// Corpus files keep the extracted payloads so runs don't depend on the plugins being around: a magic, the record
+	// count, then type, form ID, decompressed size, compressed size and the zlib stream for each record.
+	//
+	constexpr uint32_t CorpusMagic = FourCC("CKRC");
+
+	inline bool WriteCorpus(FILE *File, const std::vector<CompressedRecord>& Records)
+	{
+		const uint32_t header[2] = { CorpusMagic, (uint32_t)Records.size() };
+
+		if (fwrite(header, sizeof(header), 1, File) != 1)
+			return false;
+
+		for (auto& record : Records)
+		{
+			const uint32_t fields[4] = { record.Type, record.FormID, record.DecompressedSize, (uint32_t)record.Data.size() };
+
+			if (fwrite(fields, sizeof(fields), 1, File) != 1)
+				return false;
+
+			if (!record.Data.empty() && fwrite(record.Data.data(), record.Data.size(), 1, File) != 1)
+				return false;
+		}
+
+		return true;
+	}
+
+	inline bool ReadCorpus(FILE *File, std::vector<CompressedRecord>& Records)
+	{
+		uint32_t header[2];
+
+		if (fread(header, sizeof(header), 1, File) != 1 || header[0] != CorpusMagic)
+			return false;
+
+		for (uint32_t i = 0; i < header[1]; i++)
+		{
+			uint32_t fields[4];
+
+			if (fread(fields, sizeof(fields), 1, File) != 1)
+				return false;
+
+			CompressedRecord record;
+			record.Type = fields[0];
+			record.FormID = fields[1];
+			record.DecompressedSize = fields[2];
+			record.Data.resize(fields[3]);
+
+			if (!record.Data.empty() && fread(record.Data.data(), record.Data.size(), 1, File) != 1)
+				return false;
+
+			Records.push_back(std::move(record));
+		}
+
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include <zlib.h>
+#include <string>
+#include "PluginRecords.h"
+#include "Check.h"
+
+namespace
+{
+	using namespace PluginRecords;
+	using Bytes = std::vector<uint8_t>;
+
+	void PutU32(Bytes& Out, uint32_t Value)
+	{
+		for (int i = 0; i < 4; i++)
+			Out.push_back((uint8_t)(Value >> (i * 8)));
+	}
+
+	void PutHeader(Bytes& Out, const char *Type, uint32_t Size, uint32_t Flags, uint32_t FormID)
+	{
+		PutU32(Out, FourCC(Type));
+		PutU32(Out, Size);
+		PutU32(Out, Flags);
+		PutU32(Out, FormID);
+		PutU32(Out, 0);		// Version control info
+		PutU32(Out, 131);	// Form version, unknown
+	}
+
+	void PutRecord(Bytes& Out, const char *Type, uint32_t FormID, const std::string& Data)
+	{
+		PutHeader(Out, Type, (uint32_t)Data.size(), 0, FormID);
+		Out.insert(Out.end(), Data.begin(), Data.end());
+	}
+
+	Bytes Compress(const std::string& Data)
+	{
+		uLongf size = compressBound((uLong)Data.size());
+		Bytes out(size);
+		compress(out.data(), &size, (const Bytef *)Data.data(), (uLong)Data.size());
+		out.resize(size);
+		return out;
+	}
+
+	void PutCompressedRecord(Bytes& Out, const char *Type, uint32_t FormID, const std::string& Data)
+	{
+		const Bytes stream = Compress(Data);
+
+		PutHeader(Out, Type, (uint32_t)(stream.size() + 4), CompressedFlag, FormID);
+		PutU32(Out, (uint32_t)Data.size());
+		Out.insert(Out.end(), stream.begin(), stream.end());
+	}
+
+	// Groups hold their own header in the size, Contents is everything that follows it
+	void PutGroup(Bytes& Out, const char *Label, uint32_t GroupType, const Bytes& Contents)
+	{
+		PutU32(Out, FourCC("GRUP"));
+		PutU32(Out, (uint32_t)(Contents.size() + HeaderSize));
+		PutU32(Out, FourCC(Label));
+		PutU32(Out, GroupType);
+		PutU32(Out, 0);
+		PutU32(Out, 0);
+		Out.insert(Out.end(), Contents.begin(), Contents.end());
+	}
+
+	std::string Inflate(const CompressedRecord& Record)
+	{
+		std::string out(Record.DecompressedSize, '\0');
+		uLongf size = Record.DecompressedSize;
+
+		if (uncompress((Bytef *)out.data(), &size, Record.Data.data(), (uLong)Record.Data.size()) != Z_OK)
+			return "<bad stream>";
+
+		out.resize(size);
+		return out;
+	}
+
+	const std::string NpcData = std::string("EDID\x08\x00MyNpc01\x00", 14) + std::string(300, 'x');
+	const std::string NavmData(4096, 'n');
+
+	Bytes MakePlugin()
+	{
+		Bytes plugin;
+		PutRecord(plugin, "TES4", 0, "HEDR");
+
+		Bytes weapons;
+		PutRecord(weapons, "WEAP", 0x0100ABCD, "EDID plain weapon");
+		PutRecord(weapons, "WEAP", 0x0100ABCE, "");
+		PutGroup(plugin, "WEAP", 0, weapons);
+
+		Bytes npcs;
+		PutCompressedRecord(npcs, "NPC_", 0x01000801, NpcData);
+		PutGroup(plugin, "NPC_", 0, npcs);
+
+		// Cell children nest groups inside groups
+		Bytes temporary;
+		PutCompressedRecord(temporary, "NAVM", 0x01000900, NavmData);
+		PutRecord(temporary, "REFR", 0x01000901, "DATA");
+
+		Bytes children;
+		PutGroup(children, "\x01\x09\x00\x01", 9, temporary);
+
+		Bytes cells;
+		PutRecord(cells, "CELL", 0x01000800, "FULL");
+		PutGroup(cells, "\x00\x08\x00\x01", 6, children);
+		PutGroup(plugin, "CELL", 0, cells);
+
+		return plugin;
+	}
+
+	void TestExtract()
+	{
+		const Bytes plugin = MakePlugin();
+		std::vector<CompressedRecord> records;
+
+		CHECK(ExtractCompressedRecords(plugin.data(), plugin.size(), records));
+		CHECK_EQ(records.size(), (size_t)2);
+
+		if (records.size() != 2)
+			return;
+
+		CHECK_EQ(records[0].Type, FourCC("NPC_"));
+		CHECK_EQ(records[0].FormID, 0x01000801u);
+		CHECK_EQ(records[0].DecompressedSize, (uint32_t)NpcData.size());
+		CHECK(Inflate(records[0]) == NpcData);
+
+		CHECK_EQ(records[1].Type, FourCC("NAVM"));
+		CHECK_EQ(records[1].FormID, 0x01000900u);
+		CHECK(Inflate(records[1]) == NavmData);
+
+		// Nothing to find in an empty file
+		std::vector<CompressedRecord> none;
+		CHECK(ExtractCompressedRecords(plugin.data(), 0, none));
+		CHECK(none.empty());
+	}
+
+	void TestTruncated()
+	{
+		const Bytes plugin = MakePlugin();
+
+		// Cut inside the last REFR, then inside the NAVM payload before it. Records ahead of the cut are still returned.
+		const struct
+		{
+			size_t Cut;
+			size_t Found;
+		} cuts[] = { { plugin.size() - 1, 2 }, { plugin.size() - 40, 1 } };
+
+		for (auto& cut : cuts)
+		{
+			std::vector<CompressedRecord> records;
+			CHECK(!ExtractCompressedRecords(plugin.data(), cut.Cut, records));
+			CHECK_EQ(records.size(), cut.Found);
+		}
+
+		// Cut inside a header
+		std::vector<CompressedRecord> records;
+		CHECK(!ExtractCompressedRecords(plugin.data(), 10, records));
+		CHECK(records.empty());
+
+		// A group can't be smaller than its own header
+		Bytes bad;
+		PutU32(bad, FourCC("GRUP"));
+		PutU32(bad, 8);
+		bad.resize(HeaderSize);
+		CHECK(!ExtractCompressedRecords(bad.data(), bad.size(), records));
+	}
+
+	void TestCorpus()
+	{
+		const Bytes plugin = MakePlugin();
+		std::vector<CompressedRecord> records;
+		ExtractCompressedRecords(plugin.data(), plugin.size(), records);
+
+		FILE *f = tmpfile();
+		CHECK(f != nullptr);
+
+		if (!f)
+			return;
+
+		CHECK(WriteCorpus(f, records));
+		rewind(f);
+
+		std::vector<CompressedRecord> loaded;
+		CHECK(ReadCorpus(f, loaded));
+		CHECK_EQ(loaded.size(), records.size());
+
+		for (size_t i = 0; i < loaded.size() && i < records.size(); i++)
+		{
+			CHECK_EQ(loaded[i].Type, records[i].Type);
+			CHECK_EQ(loaded[i].FormID, records[i].FormID);
+			CHECK_EQ(loaded[i].DecompressedSize, records[i].DecompressedSize);
+			CHECK(loaded[i].Data == records[i].Data);
+		}
+
+		// A plugin isn't a corpus
+		rewind(f);
+		fwrite(plugin.data(), plugin.size(), 1, f);
+		rewind(f);
+		loaded.clear();
+		CHECK(!ReadCorpus(f, loaded));
+
+		fclose(f);
+	}
+}
+
+int main()
+{
+	TestExtract();
+	TestTruncated();
+	TestCorpus();
+
+	if (CheckFailures() == 0)
+		printf("PluginRecords: all checks passed\n");
+
+	return CheckFailures();
+}
\ No newline at end of file
@@ -0,0 +1,217 @@
+#include <random>
+#include <vector>
+#include "PointerSearchIndex.h"
+#include "Check.h"
+
+namespace
+{
+	using Index = PointerSearchIndex;
+
+	//
+	// Same loop as sub_1405B31C0, the scan the index replaces through g_PointerSearchScan
+	//
+	uint32_t LinearScan(const void *const *Data, uint32_t Size, const void *Target)
+	{
+		for (uint32_t i = 0; i < Size; i++)
+		{
+			if (Data[i] == Target)
+				return i;
+		}
+
+		return 0xFFFFFFFF;
+	}
+
+	const void *Value(uintptr_t Id)
+	{
+		return (const void *)(Id * 16);
+	}
+
+	//
+	// Stand-in for a BSTArray: a buffer that's replaced when it fills up, plus a size
+	//
+	struct Array
+	{
+		std::vector<const void *> Buffer = std::vector<const void *>(4);
+		uint32_t Size = 0;
+
+		const void *const *Data() const
+		{
+			return Buffer.data();
+		}
+
+		void PushBack(const void *Value)
+		{
+			if (Size == Buffer.size())
+			{
+				std::vector<const void *> grown(Buffer.size() * 2);
+				std::copy(Buffer.begin(), Buffer.end(), grown.begin());
+				Buffer.swap(grown);
+			}
+
+			Buffer[Size++] = Value;
+		}
+
+		void Erase(uint32_t Position)
+		{
+			std::copy(Buffer.begin() + Position + 1, Buffer.begin() + Size, Buffer.begin() + Position);
+			Size--;
+		}
+
+		void EraseFast(uint32_t Position)
+		{
+			Buffer[Position] = Buffer[Size - 1];
+			Size--;
+		}
+	};
+
+	// Every value in the pool plus one that was never stored
+	void CheckAgainstScan(Index& PointerIndex, const Array& Values, uintptr_t Pool)
+	{
+		PointerIndex.Update(Values.Data(), Values.Size);
+
+		for (uintptr_t id = 0; id <= Pool; id++)
+		{
+			const uint32_t expected = LinearScan(Values.Data(), Values.Size, Value(id));
+
+			if (PointerIndex.Find(Value(id)) != expected)
+			{
+				CHECK_EQ(PointerIndex.Find(Value(id)), expected);
+				return;
+			}
+		}
+	}
+
+	void TestAppend()
+	{
+		Index pointerIndex;
+		Array values;
+
+		// Duplicates and nulls report their first position
+		for (uintptr_t i = 0; i < 3000; i++)
+			values.PushBack(Value(i % 1000));
+
+		pointerIndex.Update(values.Data(), values.Size);
+		CHECK_EQ(pointerIndex.Find(Value(5)), 5u);
+		CHECK_EQ(pointerIndex.Find(Value(0)), 0u);
+		CHECK_EQ(pointerIndex.Find(Value(1000)), Index::npos);
+		CHECK_EQ(pointerIndex.Size(), 3000u);
+
+		// Appends and reallocations are followed without starting over
+		values.PushBack(Value(1000));
+		pointerIndex.Update(values.Data(), values.Size);
+		CHECK_EQ(pointerIndex.Find(Value(1000)), 3000u);
+
+		for (uintptr_t i = 0; i < 5000; i++)
+			values.PushBack(Value(2000 + i));
+
+		pointerIndex.Update(values.Data(), values.Size);
+		CHECK_EQ(pointerIndex.Find(Value(6999)), 8000u);
+		CHECK_EQ(pointerIndex.Resyncs(), 0u);
+	}
+
+	void TestErase()
+	{
+		Index pointerIndex;
+		Array values;
+
+		for (uintptr_t i = 0; i < 2000; i++)
+			values.PushBack(Value(i % 500));
+
+		pointerIndex.Update(values.Data(), values.Size);
+		CHECK_EQ(pointerIndex.Find(Value(7)), 7u);
+
+		// The first copy goes away, the next one is found without a scan
+		values.Erase(7);
+		pointerIndex.Update(values.Data(), values.Size);
+		CHECK_EQ(pointerIndex.Find(Value(7)), 506u);
+		CHECK_EQ(pointerIndex.Find(Value(8)), 7u);
+
+		// Erase then append keeps the size but moves the last element
+		values.Erase(0);
+		values.PushBack(Value(9999));
+		pointerIndex.Update(values.Data(), values.Size);
+		CHECK_EQ(pointerIndex.Find(Value(9999)), values.Size - 1);
+		CHECK_EQ(pointerIndex.Find(Value(0)), 498u);
+
+		// Truncation drops values that only lived in the tail
+		values.PushBack(Value(12345));
+		pointerIndex.Update(values.Data(), values.Size);
+		values.Size = 10;
+		pointerIndex.Update(values.Data(), values.Size);
+		CHECK_EQ(pointerIndex.Find(Value(12345)), Index::npos);
+		CHECK_EQ(pointerIndex.Find(Value(9999)), Index::npos);
+		CHECK_EQ(pointerIndex.Size(), 10u);
+
+		values.Size = 0;
+		pointerIndex.Update(values.Data(), values.Size);
+		CHECK_EQ(pointerIndex.Find(Value(1)), Index::npos);
+	}
+
+	void TestInPlace()
+	{
+		Index pointerIndex;
+		Array values;
+
+		for (uintptr_t i = 0; i < 2000; i++)
+			values.PushBack(Value(i));
+
+		pointerIndex.Update(values.Data(), values.Size);
+
+		// A hit that no longer holds its value is caught and the index brought up to date
+		values.Buffer[10] = Value(50);
+		pointerIndex.Update(values.Data(), values.Size);
+		CHECK_EQ(pointerIndex.Find(Value(10)), Index::npos);
+		CHECK_EQ(pointerIndex.Find(Value(50)), 10u);
+		CHECK_EQ(pointerIndex.Resyncs(), 1u);
+	}
+
+	void TestRandom()
+	{
+		// Random appends, erases, swap-removes, replacements and truncations, checked against the scan after every step
+		constexpr uintptr_t Pool = 300;
+
+		std::mt19937 rng(7);
+		Index pointerIndex;
+		Array values;
+
+		for (int step = 0; step < 4000 && CheckFailures() == 0; step++)
+		{
+			const uint32_t op = rng() % 10;
+
+			if (op < 6 || values.Size == 0)
+			{
+				const uint32_t count = 1 + rng() % 20;
+
+				for (uint32_t i = 0; i < count; i++)
+					values.PushBack((rng() % 50) ? Value(rng() % Pool) : nullptr);
+			}
+			else if (op < 8)
+				values.Erase(rng() % values.Size);
+			else if (op < 9)
+				values.EraseFast(rng() % values.Size);
+			else if (rng() % 2)
+			{
+				// Same size, different contents
+				values.Erase(rng() % values.Size);
+				values.PushBack(Value(rng() % Pool));
+			}
+			else
+				values.Size = rng() % (values.Size + 1);
+
+			CheckAgainstScan(pointerIndex, values, Pool);
+		}
+	}
+}
+
+int main()
+{
+	TestAppend();
+	TestErase();
+	TestInPlace();
+	TestRandom();
+
+	if (CheckFailures() == 0)
+		printf("PointerSearchIndex: all checks passed\n");
+
+	return CheckFailures();
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "RadixSort.h"
+
+//
+// Times TryRadixSort against std::sort on shuffled form arrays from 100K to 10M elements, with a form ID comparator
+// (accepted) and a descending one (rejected on the first sort, then skipped). Not part of ctest; run it from a release
+// build.
+//
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	double Milliseconds(Clock::time_point Start, Clock::time_point End)
+	{
+		return std::chrono::duration<double, std::milli>(End - Start).count();
+	}
+
+	struct Form
+	{
+		uint32_t FormID;
+	};
+
+	const RadixSortKey<Form *> g_Keys[2] =
+	{
+		{ [](Form *const& F) -> uint64_t { return F->FormID; }, sizeof(uint32_t) },
+		{ [](Form *const& F) -> uint64_t { return (uintptr_t)F; }, sizeof(uintptr_t) },
+	};
+
+	int CompareFormID(const void *A, const void *B)
+	{
+		const uint32_t a = ((const Form *)A)->FormID;
+		const uint32_t b = ((const Form *)B)->FormID;
+		return (a < b) ? -1 : (a > b) ? 1 : 0;
+	}
+
+	int CompareFormIDDescending(const void *A, const void *B)
+	{
+		return CompareFormID(B, A);
+	}
+
+	template<typename Func>
+	double Measure(std::vector<Form *>& Array, const std::vector<Form *>& Shuffled, Func&& Function)
+	{
+		double best = 1e30;
+
+		for (int i = 0; i < 3; i++)
+		{
+			Array = Shuffled;
+
+			const auto start = Clock::now();
+			Function();
+			best = std::min(best, Milliseconds(start, Clock::now()));
+		}
+
+		return best;
+	}
+}
+
+int main()
+{
+	for (uint32_t count : { 100000u, 1000000u, 10000000u })
+	{
+		std::mt19937 rng(count);
+		std::vector<Form> storage(count);
+		std::vector<Form *> shuffled;
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			storage[i].FormID = (rng() % 8) << 24 | i;
+			shuffled.push_back(&storage[i]);
+		}
+
+		std::shuffle(shuffled.begin(), shuffled.end(), rng);
+
+		for (auto comparator : { CompareFormID, CompareFormIDDescending })
+		{
+			auto compare = [comparator](Form *const& A, Form *const& B)
+			{
+				return comparator(A, B) == -1;
+			};
+
+			std::vector<Form *> array;
+			RadixSortVerdicts verdicts;
+
+			const double sorted = Measure(array, shuffled, [&]
+			{
+				std::sort(array.begin(), array.end(), compare);
+			});
+
+			const double radix = Measure(array, shuffled, [&]
+			{
+				if (!TryRadixSort(array.data(), array.data() + array.size(), compare, (uintptr_t)comparator, g_Keys, 2, verdicts))
+					std::sort(array.begin(), array.end(), compare);
+			});
+
+			printf("%8u %-12s std::sort %9.2f ms   radix %9.2f ms   %5.2fx\n", count,
+				(comparator == CompareFormID) ? "form ID" : "descending", sorted, radix, sorted / radix);
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
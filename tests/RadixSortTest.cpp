@@ -0,0 +1,216 @@
+#include <string.h>
+#include <random>
+#include <string>
+#include <vector>
+#include "RadixSort.h"
+#include "Check.h"
+
+namespace
+{
+	//
+	// Stand-in for TESForm_CK: the editor sorts arrays of form pointers with C style comparators
+	//
+	struct Form
+	{
+		uint32_t FormID;
+		std::string EditorID;
+	};
+
+	using Forms = std::vector<Form *>;
+
+	uint32_t g_KeyReads;
+
+	const RadixSortKey<Form *> g_Keys[2] =
+	{
+		{ [](Form *const& F) -> uint64_t { g_KeyReads++; return F->FormID; }, sizeof(uint32_t) },
+		{ [](Form *const& F) -> uint64_t { g_KeyReads++; return (uintptr_t)F; }, sizeof(uintptr_t) },
+	};
+
+	int CompareFormID(const void *A, const void *B)
+	{
+		const uint32_t a = ((const Form *)A)->FormID;
+		const uint32_t b = ((const Form *)B)->FormID;
+		return (a < b) ? -1 : (a > b) ? 1 : 0;
+	}
+
+	int CompareFormIDDescending(const void *A, const void *B)
+	{
+		return CompareFormID(B, A);
+	}
+
+	int CompareAddress(const void *A, const void *B)
+	{
+		return (A < B) ? -1 : (A > B) ? 1 : 0;
+	}
+
+	int CompareEditorID(const void *A, const void *B)
+	{
+		const int result = strcmp(((const Form *)A)->EditorID.c_str(), ((const Form *)B)->EditorID.c_str());
+		return (result < 0) ? -1 : (result > 0) ? 1 : 0;
+	}
+
+	// Same adapter ArrayQuickSortRecursive wraps the editor's comparators in
+	bool Sort(Forms& Array, int(*SortFunction)(const void *, const void *), RadixSortVerdicts& Verdicts)
+	{
+		auto compare = [SortFunction](Form *const& A, Form *const& B)
+		{
+			return SortFunction(A, B) == -1;
+		};
+
+		if (TryRadixSort(Array.data(), Array.data() + Array.size(), compare, (uintptr_t)SortFunction, g_Keys, 2, Verdicts))
+			return true;
+
+		std::sort(Array.begin(), Array.end(), compare);
+		return false;
+	}
+
+	Forms Reference(Forms Array, int(*SortFunction)(const void *, const void *))
+	{
+		std::sort(Array.begin(), Array.end(), [SortFunction](Form *A, Form *B) { return SortFunction(A, B) == -1; });
+		return Array;
+	}
+
+	struct Plugin
+	{
+		std::vector<Form> Storage;
+		Forms Array;
+
+		Plugin(uint32_t Count, uint32_t Seed, uint32_t IdRange = 0)
+		{
+			std::mt19937 rng(Seed);
+			Storage.resize(Count);
+
+			for (uint32_t i = 0; i < Count; i++)
+			{
+				// Load order index in the top byte like real form IDs, optionally with collisions
+				Storage[i].FormID = (rng() % 3) << 24 | (IdRange ? rng() % IdRange : i);
+				Storage[i].EditorID = "Form" + std::to_string(rng() % 100000);
+				Array.push_back(&Storage[i]);
+			}
+
+			std::shuffle(Array.begin(), Array.end(), rng);
+		}
+	};
+
+	void TestByKey()
+	{
+		std::mt19937_64 rng(7);
+		std::vector<std::pair<uint64_t, uint32_t>> values;
+
+		// Mixed widths so some passes are skipped and others aren't
+		for (uint32_t i = 0; i < 5000; i++)
+			values.emplace_back((i % 4 == 0) ? rng() : (rng() & 0xFF00FF), i);
+
+		std::vector<std::pair<uint64_t, uint32_t> *> array;
+
+		for (auto& value : values)
+			array.push_back(&value);
+
+		const RadixSortKey<std::pair<uint64_t, uint32_t> *> key = { [](auto *const& P) -> uint64_t { return P->first; }, 8 };
+		auto expected = array;
+
+		std::stable_sort(expected.begin(), expected.end(), [](auto *A, auto *B) { return A->first < B->first; });
+		RadixSortByKey(array.data(), array.data() + array.size(), key);
+
+		// LSD passes are stable, equal keys keep their original order
+		CHECK(array == expected);
+
+		// Narrow keys only look at their low bytes
+		const RadixSortKey<std::pair<uint64_t, uint32_t> *> low = { [](auto *const& P) -> uint64_t { return P->second; }, 2 };
+		RadixSortByKey(array.data(), array.data() + array.size(), low);
+
+		for (uint32_t i = 0; i < array.size(); i++)
+			CHECK_EQ(array[i]->second, i);
+
+		// Nothing to do
+		RadixSortByKey(array.data(), array.data(), key);
+		RadixSortByKey(array.data(), array.data() + 1, key);
+		CHECK_EQ(array[0]->second, 0u);
+	}
+
+	void TestFormID()
+	{
+		RadixSortVerdicts verdicts;
+		Plugin plugin(20000, 1);
+
+		const Forms expected = Reference(plugin.Array, CompareFormID);
+		CHECK(Sort(plugin.Array, CompareFormID, verdicts));
+		CHECK(plugin.Array == expected);
+
+		// Duplicate IDs: any order of equal elements is a valid unstable sort
+		Plugin duplicates(20000, 2, 500);
+		CHECK(Sort(duplicates.Array, CompareFormID, verdicts));
+		CHECK(std::is_sorted(duplicates.Array.begin(), duplicates.Array.end(), [](Form *A, Form *B) { return CompareFormID(A, B) == -1; }));
+		CHECK(!verdicts.IsRejected((uintptr_t)&CompareFormID, 0));
+	}
+
+	void TestAddress()
+	{
+		RadixSortVerdicts verdicts;
+		Plugin plugin(20000, 3);
+
+		const Forms expected = Reference(plugin.Array, CompareAddress);
+		CHECK(Sort(plugin.Array, CompareAddress, verdicts));
+		CHECK(plugin.Array == expected);
+
+		// The form ID key was tried first and failed the check, so the next sort goes straight to the address
+		CHECK(verdicts.IsRejected((uintptr_t)&CompareAddress, 0));
+		CHECK(!verdicts.IsRejected((uintptr_t)&CompareAddress, 1));
+
+		std::shuffle(plugin.Array.begin(), plugin.Array.end(), std::mt19937(4));
+		g_KeyReads = 0;
+		CHECK(Sort(plugin.Array, CompareAddress, verdicts));
+		CHECK(plugin.Array == expected);
+		CHECK_EQ(g_KeyReads, 20000u);
+	}
+
+	void TestNotKeyOrdered()
+	{
+		for (auto comparator : { CompareFormIDDescending, CompareEditorID })
+		{
+			RadixSortVerdicts verdicts;
+			Plugin plugin(5000, 5);
+
+			const Forms expected = Reference(plugin.Array, comparator);
+			CHECK(!Sort(plugin.Array, comparator, verdicts));
+			CHECK(plugin.Array.size() == expected.size());
+			CHECK(std::is_sorted(plugin.Array.begin(), plugin.Array.end(), [comparator](Form *A, Form *B) { return comparator(A, B) == -1; }));
+			CHECK(std::is_permutation(plugin.Array.begin(), plugin.Array.end(), expected.begin()));
+
+			// Both keys are rejected once, later sorts never read a key
+			std::shuffle(plugin.Array.begin(), plugin.Array.end(), std::mt19937(6));
+			g_KeyReads = 0;
+			CHECK(!Sort(plugin.Array, comparator, verdicts));
+			CHECK_EQ(g_KeyReads, 0u);
+		}
+	}
+
+	void TestVerdictsPerComparator()
+	{
+		RadixSortVerdicts verdicts;
+		verdicts.Reject((uintptr_t)&CompareAddress, 0);
+
+		CHECK(verdicts.IsRejected((uintptr_t)&CompareAddress, 0));
+		CHECK(!verdicts.IsRejected((uintptr_t)&CompareAddress, 1));
+		CHECK(!verdicts.IsRejected((uintptr_t)&CompareFormID, 0));
+
+		// A rejection for one comparator doesn't affect another
+		Plugin plugin(1000, 8);
+		CHECK(Sort(plugin.Array, CompareFormID, verdicts));
+		CHECK(plugin.Array == Reference(plugin.Array, CompareFormID));
+	}
+}
+
+int main()
+{
+	TestByKey();
+	TestFormID();
+	TestAddress();
+	TestNotKeyOrdered();
+	TestVerdictsPerComparator();
+
+	if (CheckFailures() == 0)
+		printf("RadixSort: all checks passed\n");
+
+	return CheckFailures();
+}
\ No newline at end of file
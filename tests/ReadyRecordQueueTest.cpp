@@ -0,0 +1,243 @@
+#include <string.h>
+#include <chrono>
+#include <future>
+#include <thread>
+#include "ReadyRecordQueue.h"
+#include "Check.h"
+
+namespace
+{
+	using Queue = ReadyRecordQueue;
+
+	// Stand-ins for two file jobs. Only their addresses matter.
+	int g_FileA;
+	int g_FileB;
+
+	//
+	// A record whose "compressed input" is just the key's bytes, so Take can confirm it
+	//
+	Queue::Record MakeRecord(const void *Owner, uint64_t Sequence, uint64_t Key, uint32_t Reserved)
+	{
+		const uint32_t length = Reserved - sizeof(Key);
+		auto data = std::make_unique<uint8_t[]>(Reserved);
+
+		memset(data.get(), (int)Key, length);
+		memcpy(data.get() + length, &Key, sizeof(Key));
+
+		return { Owner, Sequence, length, (uint32_t)sizeof(Key), Reserved, std::move(data) };
+	}
+
+	Queue::TakeResult TakeKey(Queue& Records, uint64_t Key, Queue::Record *Value)
+	{
+		return Records.Take(Key, &Key, sizeof(Key), UINT32_MAX, Value);
+	}
+
+	// Reserves and publishes one record the way the scanner and a worker would
+	bool Produce(Queue& Records, const void *Owner, uint64_t Key, uint32_t Size, const std::atomic_bool& Cancel)
+	{
+		uint64_t sequence;
+
+		if (!Records.Reserve(Size, Cancel, &sequence))
+			return false;
+
+		return Records.Publish(Key, MakeRecord(Owner, sequence, Key, Size));
+	}
+
+	//
+	// Runs a reservation that might block on another thread. Returns false if it's still waiting after the timeout,
+	// in which case it's cancelled so the test can carry on.
+	//
+	bool ReserveWithin(Queue& Records, uint32_t Size, std::chrono::milliseconds Timeout, bool *Reserved = nullptr)
+	{
+		std::atomic_bool cancel(false);
+		uint64_t sequence = 0;
+
+		auto result = std::async(std::launch::async, [&]() { return Records.Reserve(Size, cancel, &sequence); });
+
+		if (result.wait_for(Timeout) != std::future_status::ready)
+		{
+			cancel = true;
+			Records.WakeAll();
+			result.wait();
+			return false;
+		}
+
+		const bool reserved = result.get();
+
+		if (Reserved)
+			*Reserved = reserved;
+
+		return true;
+	}
+
+	void TestTakeAndCollision()
+	{
+		Queue records;
+		std::atomic_bool cancel(false);
+		records.SetBudget(1000);
+
+		CHECK(records.Empty());
+		CHECK(Produce(records, &g_FileA, 1, 100, cancel));
+		CHECK(!records.Empty());
+		CHECK_EQ(records.ReservedBytes(), (size_t)100);
+
+		// A second copy of the same payload is dropped and its space handed back
+		CHECK(!Produce(records, &g_FileA, 1, 200, cancel));
+		CHECK_EQ(records.ReservedBytes(), (size_t)100);
+
+		// Same key, different input
+		Queue::Record record;
+		const uint64_t other = 2;
+		CHECK(records.Take(1, &other, sizeof(other), UINT32_MAX, &record) == Queue::TakeResult::Collision);
+
+		// Output buffer too small
+		const uint64_t key = 1;
+		CHECK(records.Take(1, &key, sizeof(key), 10, &record) == Queue::TakeResult::Missing);
+		CHECK(TakeKey(records, 3, &record) == Queue::TakeResult::Missing);
+
+		CHECK(TakeKey(records, 1, &record) == Queue::TakeResult::Taken);
+		CHECK_EQ(record.Length, 100u - 8u);
+		CHECK_EQ(record.Data[0], 1);
+		CHECK(records.Empty());
+		CHECK_EQ(records.ReservedBytes(), (size_t)0);
+	}
+
+	void TestReleaseOnFailure()
+	{
+		Queue records;
+		std::atomic_bool cancel(false);
+		uint64_t sequence;
+		records.SetBudget(1000);
+
+		// A worker that fails to inflate gives its reservation back
+		CHECK(records.Reserve(600, cancel, &sequence));
+		records.Release(600);
+		CHECK_EQ(records.ReservedBytes(), (size_t)0);
+		CHECK(ReserveWithin(records, 1000, std::chrono::seconds(5)));
+	}
+
+	void TestReopenAfterPartialRead()
+	{
+		// Open, read part of the file, close, open another. The first file's leftovers must not hold the budget.
+		Queue records;
+		std::atomic_bool cancelA(false);
+		std::atomic_bool cancelB(false);
+		records.SetBudget(1000);
+
+		CHECK(Produce(records, &g_FileA, 10, 300, cancelA));
+		CHECK(Produce(records, &g_FileA, 11, 300, cancelA));
+		CHECK(Produce(records, &g_FileA, 12, 300, cancelA));
+
+		// The loader only reads the header record, i.e. the Data dialog
+		Queue::Record record;
+		CHECK(TakeKey(records, 10, &record) == Queue::TakeResult::Taken);
+		CHECK_EQ(records.ReservedBytes(), (size_t)600);
+
+		// Closing the file
+		cancelA = true;
+		records.WakeAll();
+		records.DropOwner(&g_FileA);
+
+		CHECK(records.Empty());
+		CHECK_EQ(records.ReservedBytes(), (size_t)0);
+		CHECK(TakeKey(records, 11, &record) == Queue::TakeResult::Missing);
+
+		// The next file gets the whole budget right away. Without the drop this would wait forever.
+		bool reserved = false;
+
+		if (!ReserveWithin(records, 1000, std::chrono::seconds(5), &reserved))
+		{
+			CHECK(!"Reservation blocked by a closed file's records");
+			return;
+		}
+
+		CHECK(reserved);
+		records.Release(1000);
+
+		CHECK(Produce(records, &g_FileB, 20, 300, cancelB));
+		CHECK(Produce(records, &g_FileB, 21, 300, cancelB));
+		CHECK(Produce(records, &g_FileB, 22, 300, cancelB));
+		CHECK_EQ(records.ReservedBytes(), (size_t)900);
+
+		// Reopening the first file while the second is still open only drops the right records
+		std::atomic_bool cancelA2(false);
+		int fileA2;
+		records.SetBudget(2000);
+		CHECK(Produce(records, &fileA2, 10, 300, cancelA2));
+		records.DropOwner(&g_FileB);
+		CHECK_EQ(records.ReservedBytes(), (size_t)300);
+		CHECK(TakeKey(records, 21, &record) == Queue::TakeResult::Missing);
+		CHECK(TakeKey(records, 10, &record) == Queue::TakeResult::Taken);
+		CHECK_EQ(record.Owner, (const void *)&fileA2);
+	}
+
+	void TestBlockedScanner()
+	{
+		// A scanner waiting for space is let through when a closed file's records are dropped
+		Queue records;
+		std::atomic_bool cancelA(false);
+		records.SetBudget(1000);
+
+		CHECK(Produce(records, &g_FileA, 1, 500, cancelA));
+		CHECK(Produce(records, &g_FileA, 2, 500, cancelA));
+
+		// Still blocked while the records are held
+		bool reserved = false;
+		CHECK(!ReserveWithin(records, 500, std::chrono::milliseconds(200)));
+
+		std::atomic_bool cancelB(false);
+		uint64_t sequence = 0;
+		auto waiting = std::async(std::launch::async, [&]() { return records.Reserve(500, cancelB, &sequence); });
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		records.DropOwner(&g_FileA);
+
+		if (waiting.wait_for(std::chrono::seconds(5)) != std::future_status::ready)
+		{
+			CHECK(!"Reservation still blocked after the owner was dropped");
+			cancelB = true;
+			records.WakeAll();
+		}
+
+		reserved = waiting.get();
+		CHECK(reserved);
+		CHECK_EQ(records.ReservedBytes(), (size_t)500);
+
+		// Cancelling a blocked reservation returns without charging anything
+		CHECK(ReserveWithin(records, 600, std::chrono::milliseconds(100)) == false);
+		CHECK_EQ(records.ReservedBytes(), (size_t)500);
+	}
+
+	void TestEvictConsumed()
+	{
+		// Records scanned before the last one taken are dropped when space runs out
+		Queue records;
+		std::atomic_bool cancel(false);
+		records.SetBudget(1000);
+
+		CHECK(Produce(records, &g_FileA, 1, 400, cancel));
+		CHECK(Produce(records, &g_FileA, 2, 400, cancel));
+
+		Queue::Record record;
+		CHECK(TakeKey(records, 2, &record) == Queue::TakeResult::Taken);
+
+		bool reserved = false;
+		CHECK(ReserveWithin(records, 900, std::chrono::seconds(5), &reserved));
+		CHECK(reserved);
+		CHECK(TakeKey(records, 1, &record) == Queue::TakeResult::Missing);
+	}
+}
+
+int main()
+{
+	TestTakeAndCollision();
+	TestReleaseOnFailure();
+	TestReopenAfterPartialRead();
+	TestBlockedScanner();
+	TestEvictConsumed();
+
+	if (CheckFailures() == 0)
+		printf("ReadyRecordQueue: all checks passed\n");
+
+	return CheckFailures();
+}
\ No newline at end of file
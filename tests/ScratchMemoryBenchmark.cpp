@@ -0,0 +1,216 @@
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "ScratchMemory.h"
+
+//
+// Counts heap allocations and times the hook-local patterns SmallVector and FrameArena replaced, before and after:
+// deferred combo box inserts, log lines and signature parsing. malloc/free are interposed (glibc only), so every heap
+// call is counted, including the ones inside strdup and operator new. Not part of ctest; run it from a release build.
+//
+extern "C"
+{
+	void *__libc_malloc(size_t Size);
+	void *__libc_calloc(size_t Count, size_t Size);
+	void *__libc_realloc(void *Memory, size_t Size);
+	void __libc_free(void *Memory);
+}
+
+namespace
+{
+	size_t g_HeapCalls;
+}
+
+extern "C"
+{
+	void *malloc(size_t Size)
+	{
+		g_HeapCalls++;
+		return __libc_malloc(Size);
+	}
+
+	void *calloc(size_t Count, size_t Size)
+	{
+		g_HeapCalls++;
+		return __libc_calloc(Count, Size);
+	}
+
+	void *realloc(void *Memory, size_t Size)
+	{
+		g_HeapCalls++;
+		return __libc_realloc(Memory, Size);
+	}
+
+	void free(void *Memory)
+	{
+		if (Memory)
+			g_HeapCalls++;
+
+		__libc_free(Memory);
+	}
+}
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr int Frames = 200;
+
+	//
+	// Runs Frames frames after one warm-up frame and reports heap calls (allocations plus frees) and time per item
+	//
+	template<typename Func>
+	void Measure(const char *Name, size_t ItemsPerFrame, Func&& Frame)
+	{
+		Frame();
+
+		const size_t calls = g_HeapCalls;
+		const auto start = Clock::now();
+
+		for (int i = 0; i < Frames; i++)
+			Frame();
+
+		const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+		const double items = (double)ItemsPerFrame * Frames;
+
+		printf("%-34s %10.3f heap calls/item %10.1f heap calls/frame %8.1f ns/item\n", Name, (g_HeapCalls - calls) / items,
+			(g_HeapCalls - calls) / (double)Frames, ns / items);
+	}
+
+	std::vector<std::string> MakeStrings(size_t Count, size_t MinLength, size_t MaxLength, uint32_t Seed)
+	{
+		std::mt19937 rng(Seed);
+		std::vector<std::string> strings;
+
+		for (size_t i = 0; i < Count; i++)
+		{
+			std::string s(MinLength + rng() % (MaxLength - MinLength + 1), 'a');
+
+			for (auto& c : s)
+				c = (char)('a' + rng() % 26);
+
+			strings.push_back(std::move(s));
+		}
+
+		return strings;
+	}
+
+	void ComboBoxRefresh()
+	{
+		// One deferred refresh of a form combo box: editor ID like display strings, copied on insert, dropped after
+		const auto names = MakeStrings(5000, 8, 40, 1);
+		std::vector<std::pair<const char *, void *>> items;
+
+		Measure("Combo box refresh, strdup", names.size(), [&]
+		{
+			for (auto& name : names)
+				items.emplace_back(strdup(name.c_str()), nullptr);
+
+			for (auto& item : items)
+				free((void *)item.first);
+
+			items.clear();
+		});
+
+		FrameArena strings;
+
+		Measure("Combo box refresh, FrameArena", names.size(), [&]
+		{
+			for (auto& name : names)
+				items.emplace_back(strings.Strdup(name.c_str()), nullptr);
+
+			items.clear();
+			strings.Reset();
+		});
+	}
+
+	void LogLines()
+	{
+		// Lines written between two log window timer ticks
+		const auto lines = MakeStrings(2000, 30, 160, 2);
+		std::vector<const char *> messages;
+
+		Measure("Log lines, strdup", lines.size(), [&]
+		{
+			for (auto& line : lines)
+				messages.push_back(strdup(line.c_str()));
+
+			for (const char *message : messages)
+				free((void *)message);
+
+			messages.clear();
+		});
+
+		FrameArena strings;
+
+		Measure("Log lines, FrameArena batch", lines.size(), [&]
+		{
+			for (auto& line : lines)
+				messages.push_back(strings.Strdup(line.c_str()));
+
+			messages.clear();
+			strings.Reset();
+		});
+	}
+
+	template<typename Container>
+	size_t ParseSignature(Container& Pattern, const char *Mask)
+	{
+		// Same parse as XUtil::FindPattern
+		for (size_t i = 0; i < strlen(Mask);)
+		{
+			if (Mask[i] != '?')
+			{
+				Pattern.emplace_back((uint8_t)strtoul(&Mask[i], nullptr, 16), false);
+				i += 3;
+			}
+			else
+			{
+				Pattern.emplace_back(0x00, true);
+				i += 2;
+			}
+		}
+
+		return Pattern.size();
+	}
+
+	void Signatures()
+	{
+		const char *mask = "48 89 5C 24 ? 57 48 83 EC 20 8B 05 ? ? ? ? 48 8B D9 E8 ? ? ? ? 84 C0";
+		constexpr size_t SignaturesPerFrame = 100;
+		size_t sink = 0;
+
+		Measure("Signature parse, std::vector", SignaturesPerFrame, [&]
+		{
+			for (size_t i = 0; i < SignaturesPerFrame; i++)
+			{
+				std::vector<std::pair<uint8_t, bool>> pattern;
+				sink += ParseSignature(pattern, mask);
+			}
+		});
+
+		Measure("Signature parse, SmallVector", SignaturesPerFrame, [&]
+		{
+			for (size_t i = 0; i < SignaturesPerFrame; i++)
+			{
+				SmallVector<std::pair<uint8_t, bool>, 64> pattern;
+				sink += ParseSignature(pattern, mask);
+			}
+		});
+
+		if (sink == 0)
+			printf("unreachable\n");
+	}
+}
+
+int main()
+{
+	ComboBoxRefresh();
+	LogLines();
+	Signatures();
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "TypeAheadIndex.h"
+
+//
+// Times TypeAheadIndex on 1M editor ID like strings. Not part of ctest; run it from a release build.
+//
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	double Microseconds(Clock::time_point Start, Clock::time_point End)
+	{
+		return std::chrono::duration<double, std::micro>(End - Start).count();
+	}
+
+	template<typename Func>
+	void Measure(const char *Name, uint32_t Iterations, Func&& Function)
+	{
+		uint64_t sink = 0;
+		const auto start = Clock::now();
+
+		for (uint32_t i = 0; i < Iterations; i++)
+			sink += Function(i);
+
+		const auto end = Clock::now();
+		printf("%-40s %10.2f us/query (checksum %llu)\n", Name, Microseconds(start, end) / Iterations, (unsigned long long)sink);
+	}
+}
+
+int main()
+{
+	constexpr uint32_t ItemCount = 1000000;
+	const char *words[] = { "Weapon", "Armor", "Iron", "Steel", "Sword", "Helmet", "Laser", "Rifle", "Pipe", "Mod", "Receiver", "Barrel", "Combat", "Leather", "Raider", "Synth" };
+
+	std::mt19937 rng(1);
+	std::vector<std::string> items;
+	items.reserve(ItemCount);
+
+	for (uint32_t i = 0; i < ItemCount; i++)
+	{
+		std::string value;
+
+		for (int j = 0; j < 3; j++)
+			value += words[rng() % std::size(words)];
+
+		value += std::to_string(rng() % 100000);
+		items.push_back(std::move(value));
+	}
+
+	TypeAheadIndex index;
+
+	auto start = Clock::now();
+	for (const std::string& item : items)
+		index.Add(item.data(), item.size());
+	index.Finalize();
+	printf("%-40s %10.2f ms\n", "Build (Add + Finalize)", Microseconds(start, Clock::now()) / 1000.0);
+
+	start = Clock::now();
+	index.FindSubstring("xyz", 3);
+	printf("%-40s %10.2f ms\n", "First substring query (trigram build)", Microseconds(start, Clock::now()) / 1000.0);
+
+	const std::vector<std::string> prefixes = { "w", "steel", "ironsword", "laserriflemod", "piperaiderbarrel1" };
+	const std::vector<std::string> substrings = { "ord", "riflemod", "synthsynth", "helmet42", "zzz" };
+
+	for (const std::string& prefix : prefixes)
+	{
+		const std::string name = "FindPrefix \"" + prefix + "\"";
+		Measure(name.c_str(), 10000, [&](uint32_t i) { return index.FindPrefix(prefix.data(), prefix.size(), (i * 7919) % ItemCount); });
+	}
+
+	for (const std::string& value : substrings)
+	{
+		const std::string name = "FindSubstring \"" + value + "\"";
+		Measure(name.c_str(), 1000, [&](uint32_t i) { return index.FindSubstring(value.data(), value.size(), (i * 7919) % ItemCount); });
+	}
+
+	Measure("FindSubstring \"ir\" (scan)", 1000, [&](uint32_t i) { return index.FindSubstring("ir", 2, (i * 7919) % ItemCount); });
+	return 0;
+}
\ No newline at end of file
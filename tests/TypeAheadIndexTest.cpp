@@ -0,0 +1,226 @@
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include "TypeAheadIndex.h"
+#include "Check.h"
+
+namespace
+{
+	enum class Mode
+	{
+		Prefix,
+		Exact,
+		Substring,
+	};
+
+	std::string Lower(const std::string& Value)
+	{
+		std::string lowered = Value;
+
+		for (char& c : lowered)
+			c = TypeAheadIndex::Fold(c);
+
+		return lowered;
+	}
+
+	// Straight scan over the original strings, used as the expected answer
+	uint32_t Reference(const std::vector<std::string>& Items, Mode Mode, const std::string& Query, uint32_t Start)
+	{
+		const std::string query = Lower(Query);
+
+		for (uint32_t i = Start; i < Items.size(); i++)
+		{
+			const std::string item = Lower(Items[i]);
+			bool match = false;
+
+			switch (Mode)
+			{
+			case Mode::Prefix: match = item.compare(0, query.size(), query) == 0; break;
+			case Mode::Exact: match = item == query; break;
+			case Mode::Substring: match = item.find(query) != std::string::npos; break;
+			}
+
+			if (match)
+				return i;
+		}
+
+		return TypeAheadIndex::npos;
+	}
+
+	uint32_t Find(const TypeAheadIndex& Index, Mode Mode, const std::string& Query, uint32_t Start)
+	{
+		switch (Mode)
+		{
+		case Mode::Prefix: return Index.FindPrefix(Query.data(), Query.size(), Start);
+		case Mode::Exact: return Index.FindExact(Query.data(), Query.size(), Start);
+		default: return Index.FindSubstring(Query.data(), Query.size(), Start);
+		}
+	}
+
+	// Same as ComboBoxSearch: search from Start, then from the top
+	uint32_t FindWrapped(const TypeAheadIndex& Index, Mode Mode, const std::string& Query, uint32_t Start)
+	{
+		uint32_t item = Find(Index, Mode, Query, Start);
+
+		if (item == TypeAheadIndex::npos && Start > 0)
+			item = Find(Index, Mode, Query, 0);
+
+		return item;
+	}
+
+	void Build(TypeAheadIndex& Index, const std::vector<std::string>& Items)
+	{
+		Index.Clear();
+
+		for (const std::string& item : Items)
+			Index.Add(item.data(), item.size());
+
+		Index.Finalize();
+	}
+
+	void TestBasics()
+	{
+		const std::vector<std::string> items = { "Iron", "ironSword", "Steel", "IRON", "SteelSword", "", "Wood" };
+		TypeAheadIndex index;
+
+		Build(index, items);
+
+		CHECK_EQ(index.Count(), 7u);
+		CHECK(index.GetLowered(2) == "steel");
+
+		CHECK_EQ(index.FindPrefix("IRON", 4), 0u);
+		CHECK_EQ(index.FindPrefix("iron", 4, 1), 1u);
+		CHECK_EQ(index.FindPrefix("iron", 4, 2), 3u);
+		CHECK_EQ(index.FindPrefix("iron", 4, 4), TypeAheadIndex::npos);
+		CHECK_EQ(index.FindPrefix("", 0, 5), 5u);
+
+		CHECK_EQ(index.FindExact("iron", 4, 1), 3u);
+		CHECK_EQ(index.FindExact("ironsword", 9), 1u);
+		CHECK_EQ(index.FindExact("ironswor", 8), TypeAheadIndex::npos);
+		CHECK_EQ(index.FindExact("", 0), 5u);
+
+		CHECK_EQ(index.FindSubstring("SWORD", 5), 1u);
+		CHECK_EQ(index.FindSubstring("sword", 5, 2), 4u);
+		CHECK_EQ(index.FindSubstring("sword", 5, 5), TypeAheadIndex::npos);
+		CHECK_EQ(index.FindSubstring("el", 2), 2u);
+		CHECK_EQ(index.FindSubstring("xyz", 3), TypeAheadIndex::npos);
+		CHECK_EQ(index.FindSubstring("", 0, 6), 6u);
+		CHECK_EQ(index.FindSubstring("", 0, 7), TypeAheadIndex::npos);
+
+		// Start at or past the end never matches
+		CHECK_EQ(index.FindPrefix("iron", 4, 7), TypeAheadIndex::npos);
+		CHECK_EQ(index.FindExact("iron", 4, TypeAheadIndex::npos), TypeAheadIndex::npos);
+		CHECK_EQ(index.FindSubstring("iron", 4, 100), TypeAheadIndex::npos);
+
+		// Wraparound: nothing after Start, so the search restarts at the top
+		CHECK_EQ(FindWrapped(index, Mode::Prefix, "iron", 4), 0u);
+		CHECK_EQ(FindWrapped(index, Mode::Substring, "sword", 5), 1u);
+		CHECK_EQ(FindWrapped(index, Mode::Exact, "wood", 6), 6u);
+		CHECK_EQ(FindWrapped(index, Mode::Exact, "stone", 3), TypeAheadIndex::npos);
+
+		index.Clear();
+		CHECK_EQ(index.Count(), 0u);
+		index.Finalize();
+		CHECK_EQ(index.FindPrefix("a", 1), TypeAheadIndex::npos);
+		CHECK_EQ(index.FindSubstring("abc", 3), TypeAheadIndex::npos);
+	}
+
+	void TestBlockBoundaries()
+	{
+		// 1000 items where every fifth one shares a prefix, so the matching range in sorted order spans several
+		// 256 item blocks, starts and ends mid block, and covers whole blocks in between
+		std::vector<std::string> items;
+
+		for (uint32_t i = 0; i < 1000; i++)
+		{
+			char buffer[64];
+			snprintf(buffer, sizeof(buffer), (i % 5) == 0 ? "Shared%04u" : "Item%04uX", 999 - i);
+			items.push_back(buffer);
+		}
+
+		TypeAheadIndex index;
+		Build(index, items);
+
+		const std::vector<std::pair<Mode, std::string>> queries =
+		{
+			{ Mode::Prefix, "shared" },
+			{ Mode::Prefix, "item" },
+			{ Mode::Prefix, "item05" },
+			{ Mode::Prefix, "SHARED09" },
+			{ Mode::Prefix, "s" },
+			{ Mode::Prefix, "z" },
+			{ Mode::Exact, "item0500x" },
+			{ Mode::Exact, "shared0999" },
+			{ Mode::Substring, "ed0" },
+			{ Mode::Substring, "99x" },
+			{ Mode::Substring, "0x" },
+			{ Mode::Substring, "9" },
+		};
+
+		for (const auto& [mode, query] : queries)
+		{
+			for (uint32_t start : { 0u, 1u, 255u, 256u, 257u, 511u, 512u, 700u, 995u, 999u, 1000u, 5000u })
+			{
+				CHECK_EQ(Find(index, mode, query, start), Reference(items, mode, query, start));
+
+				const uint32_t expected = Reference(items, mode, query, start);
+				const uint32_t wrapped = (expected == TypeAheadIndex::npos && start > 0) ? Reference(items, mode, query, 0) : expected;
+				CHECK_EQ(FindWrapped(index, mode, query, start), wrapped);
+			}
+		}
+	}
+
+	void TestRandomized()
+	{
+		// Short strings over a small alphabet give plenty of duplicates and overlapping matches
+		srand(42);
+
+		for (uint32_t count : { 1u, 255u, 256u, 257u, 3000u })
+		{
+			std::vector<std::string> items;
+
+			for (uint32_t i = 0; i < count; i++)
+			{
+				std::string value;
+				const int length = rand() % 7;
+
+				for (int j = 0; j < length; j++)
+					value.push_back("abcABC"[rand() % 6]);
+
+				items.push_back(value);
+			}
+
+			TypeAheadIndex index;
+			Build(index, items);
+
+			for (int q = 0; q < 300; q++)
+			{
+				std::string query;
+				const int length = rand() % 5;
+
+				for (int j = 0; j < length; j++)
+					query.push_back("abcAB"[rand() % 5]);
+
+				const Mode mode = (Mode)(rand() % 3);
+				const uint32_t start = rand() % (count + 2);
+
+				CHECK_EQ(Find(index, mode, query, start), Reference(items, mode, query, start));
+			}
+
+			if (CheckFailures() > 0)
+				break;
+		}
+	}
+}
+
+int main()
+{
+	TestBasics();
+	TestBlockBoundaries();
+	TestRandomized();
+
+	if (CheckFailures() == 0)
+		printf("TypeAheadIndex: all checks passed\n");
+
+	return CheckFailures();
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "WildcardMatch.h"
+#include "Check.h"
+
+namespace
+{
+	//
+	// What the directory cache does for one entry: translate the (uppercase) mask, then try the long and 8.3 names
+	//
+	bool Matches(const wchar_t *Mask, const wchar_t *Name, const wchar_t *ShortName = L"")
+	{
+		const std::wstring expression = TranslateFindMask(Mask);
+		return WildcardMatch(expression, Name) || (*ShortName && WildcardMatch(expression, ShortName));
+	}
+
+	void TestTranslate()
+	{
+		CHECK(TranslateFindMask(L"*.*") == L"*");
+		CHECK(TranslateFindMask(L"*") == L"*");
+		CHECK(TranslateFindMask(L"*.ESP") == L"<.ESP");
+		CHECK(TranslateFindMask(L"FOO.*") == L"FOO\"*");
+		CHECK(TranslateFindMask(L"A?C.T?T") == L"A>C.T>T");
+		CHECK(TranslateFindMask(L"????????.???") == L">>>>>>>>\">>>");
+		CHECK(TranslateFindMask(L"*.*.*") == L"<\"<\"*");
+	}
+
+	void TestCacheable()
+	{
+		CHECK(IsCacheableFindMask(L"*"));
+		CHECK(IsCacheableFindMask(L"*.*"));
+		CHECK(IsCacheableFindMask(L"*.esm"));
+		CHECK(IsCacheableFindMask(L"Fallout4?.esm"));
+
+		// Literal names are single file lookups
+		CHECK(!IsCacheableFindMask(L""));
+		CHECK(!IsCacheableFindMask(L"Fallout4.esm"));
+
+		// Trailing dots
+		CHECK(!IsCacheableFindMask(L"*."));
+		CHECK(!IsCacheableFindMask(L"*.esm."));
+
+		// DOS wildcards passed in directly
+		CHECK(!IsCacheableFindMask(L"<.esm"));
+		CHECK(!IsCacheableFindMask(L"a>b*"));
+		CHECK(!IsCacheableFindMask(L"*\"esm"));
+	}
+
+	void TestStar()
+	{
+		// "*.*" and "*" list everything, including names without a dot
+		for (const wchar_t *mask : { L"*.*", L"*" })
+		{
+			CHECK(Matches(mask, L"README"));
+			CHECK(Matches(mask, L"FALLOUT4.ESM"));
+			CHECK(Matches(mask, L".GITIGNORE"));
+			CHECK(Matches(mask, L"A.B.C"));
+		}
+
+		CHECK(Matches(L"*.ESM", L"FALLOUT4.ESM"));
+		CHECK(Matches(L"*.ESM", L"DLC.ROBOT.ESM"));
+		CHECK(Matches(L"*.ESM", L".ESM"));
+		CHECK(!Matches(L"*.ESM", L"FALLOUT4.ESP"));
+		CHECK(!Matches(L"*.ESM", L"FALLOUT4.ESM.BAK"));
+		CHECK(!Matches(L"*.ESM", L"ESM"));
+
+		// "*." can't run past the last dot, and ".?" also matches no extension at all
+		CHECK(Matches(L"*.?", L"ABC"));
+		CHECK(Matches(L"*.?", L"A.BC.D"));
+		CHECK(!Matches(L"*.?", L"A.BC"));
+		CHECK(Matches(L"*.E*", L"A.ESM.BAK"));
+		CHECK(!Matches(L"*.E*", L"A.BAK"));
+
+		CHECK(Matches(L"FALLOUT4*", L"FALLOUT4.ESM"));
+		CHECK(Matches(L"FALLOUT4*", L"FALLOUT4"));
+		CHECK(Matches(L"*4*", L"FALLOUT4.ESM"));
+		CHECK(!Matches(L"*5*", L"FALLOUT4.ESM"));
+		CHECK(Matches(L"DLC*.B*", L"DLCROBOT - MAIN.BA2"));
+
+		// Matching is exact, callers uppercase both sides
+		CHECK(!Matches(L"*.ESM", L"fallout4.esm"));
+	}
+
+	void TestDotStar()
+	{
+		// ".*" also matches a name without an extension
+		CHECK(Matches(L"FOO.*", L"FOO"));
+		CHECK(Matches(L"FOO.*", L"FOO."));
+		CHECK(Matches(L"FOO.*", L"FOO.TXT"));
+		CHECK(Matches(L"FOO.*", L"FOO.TAR.GZ"));
+		CHECK(!Matches(L"FOO.*", L"FOOD"));
+		CHECK(!Matches(L"FOO.*", L"FOOD.TXT"));
+	}
+
+	void TestQuestionMark()
+	{
+		// One character, or nothing right before a dot or at the end
+		CHECK(Matches(L"FILE?.TXT", L"FILE1.TXT"));
+		CHECK(Matches(L"FILE?.TXT", L"FILE.TXT"));
+		CHECK(!Matches(L"FILE?.TXT", L"FILE12.TXT"));
+		CHECK(Matches(L"AB?", L"AB"));
+		CHECK(Matches(L"AB?", L"ABC"));
+		CHECK(!Matches(L"A?C", L"AC"));
+		CHECK(Matches(L"A?C", L"ABC"));
+		CHECK(!Matches(L"A?C", L"A.C"));
+
+		// The classic 8.3 "everything" mask
+		CHECK(Matches(L"????????.???", L"README"));
+		CHECK(Matches(L"????????.???", L"A.B"));
+		CHECK(Matches(L"????????.???", L"FALLOUT4.ESM"));
+		CHECK(!Matches(L"????????.???", L"FALLOUT4.ESMX"));
+		CHECK(!Matches(L"????????.???", L"CREATIONKIT.EXE"));
+	}
+
+	void TestShortNames()
+	{
+		// Long names are also tried as their 8.3 alias, which is why "*.HTM" lists ".HTML" files
+		CHECK(Matches(L"*.HTM", L"PAGE.HTML", L"PAGE~1.HTM"));
+		CHECK(!Matches(L"*.HTM", L"PAGE.HTML"));
+		CHECK(Matches(L"CREATI~1.*", L"CREATIONKIT.EXE", L"CREATI~1.EXE"));
+		CHECK(Matches(L"????????.???", L"CREATIONKIT.EXE", L"CREATI~1.EXE"));
+		CHECK(!Matches(L"*.ESP", L"FALLOUT4.ESM", L"FALLOU~1.ESM"));
+	}
+}
+
+int main()
+{
+	TestTranslate();
+	TestCacheable();
+	TestStar();
+	TestDotStar();
+	TestQuestionMark();
+	TestShortNames();
+
+	if (CheckFailures() == 0)
+		printf("WildcardMatch: all checks passed\n");
+
+	return CheckFailures();
+}
\ No newline at end of file
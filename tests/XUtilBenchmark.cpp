@@ -0,0 +1,111 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <vector>
+#include "xutil_portable.h"
+
+//
+// Google Benchmark timings for XUtil::FindPattern/FindPatterns (offset signature scans over the CK's .text) and
+// XUtil::MurmurHash64A (log message blacklist, inflate cache keys). Not part of ctest; run it from a release build,
+// i.e. XUtilBenchmark --benchmark_repetitions=5 --benchmark_report_aggregates_only=true for comparable numbers.
+//
+namespace
+{
+	// Signature shaped like the ones in offsets.cpp, with a wildcard displacement
+	const char *SignatureMask = "48 89 5C 24 ? 57 48 83 EC 20 8B 05 ? ? ? ? 48 8B D9";
+	const uint8_t SignatureBytes[] = { 0x48, 0x89, 0x5C, 0x24, 0x08, 0x57, 0x48, 0x83, 0xEC, 0x20, 0x8B, 0x05, 0x11, 0x22, 0x33, 0x44, 0x48, 0x8B, 0xD9 };
+
+	//
+	// Stand-in for a code section. x64 code is far from uniform (REX prefixes, 0x8B, 0xCC padding), so a quarter of the
+	// bytes come from a small set of common opcodes. That gives the scan as many false starts on 0x48 as real code does.
+	//
+	std::vector<uint8_t> MakeCode(size_t Size, uint32_t Copies)
+	{
+		std::mt19937 rng(1);
+		const uint8_t common[] = { 0x48, 0x89, 0x8B, 0xE8, 0xCC, 0x0F, 0x4C, 0x83 };
+		std::vector<uint8_t> code(Size + 1);
+
+		for (auto& byte : code)
+			byte = (rng() % 4 == 0) ? common[rng() % std::size(common)] : (uint8_t)rng();
+
+		// Planted copies, the last one at the end so FindPattern always walks the whole buffer
+		for (uint32_t i = 1; i <= Copies; i++)
+		{
+			const size_t offset = (Size / Copies) * i - sizeof(SignatureBytes);
+			std::copy(std::begin(SignatureBytes), std::end(SignatureBytes), code.begin() + offset);
+		}
+
+		return code;
+	}
+
+	void BM_FindPattern(benchmark::State& State)
+	{
+		const auto code = MakeCode(State.range(0), 1);
+		const uintptr_t start = (uintptr_t)code.data();
+
+		for (auto _ : State)
+			benchmark::DoNotOptimize(XUtil::FindPattern(start, State.range(0), SignatureMask));
+
+		State.SetBytesProcessed(State.iterations() * State.range(0));
+	}
+
+	void BM_FindPatterns(benchmark::State& State)
+	{
+		const auto code = MakeCode(State.range(0), 16);
+		const uintptr_t start = (uintptr_t)code.data();
+
+		for (auto _ : State)
+		{
+			auto results = XUtil::FindPatterns(start, State.range(0), SignatureMask);
+			benchmark::DoNotOptimize(results.data());
+		}
+
+		State.SetBytesProcessed(State.iterations() * State.range(0));
+	}
+
+	void BM_MurmurHash64A(benchmark::State& State)
+	{
+		std::mt19937 rng(2);
+		std::vector<uint8_t> data(State.range(0));
+
+		for (auto& byte : data)
+			byte = (uint8_t)rng();
+
+		for (auto _ : State)
+			benchmark::DoNotOptimize(XUtil::MurmurHash64A(data.data(), data.size(), data.size()));
+
+		State.SetBytesProcessed(State.iterations() * State.range(0));
+	}
+
+	void BM_MurmurHash64AMessages(benchmark::State& State)
+	{
+		// Log window lines: mostly 40-200 characters
+		std::mt19937 rng(3);
+		std::vector<std::string> messages;
+
+		for (int i = 0; i < 1024; i++)
+			messages.emplace_back(40 + rng() % 160, (char)('A' + i % 26));
+
+		size_t bytes = 0;
+		size_t i = 0;
+
+		for (auto _ : State)
+		{
+			const std::string& message = messages[i++ & 1023];
+			benchmark::DoNotOptimize(XUtil::MurmurHash64A(message.c_str(), message.length()));
+			bytes += message.length();
+		}
+
+		State.SetBytesProcessed(bytes);
+	}
+}
+
+// 1MB to 64MB, the CK's code section is in that range
+BENCHMARK(BM_FindPattern)->RangeMultiplier(4)->Range(1 << 20, 64 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_FindPatterns)->RangeMultiplier(4)->Range(1 << 20, 64 << 20)->Unit(benchmark::kMillisecond);
+
+// Odd sizes go through the tail switch, the largest is a big compressed record
+BENCHMARK(BM_MurmurHash64A)->Arg(7)->Arg(8)->Arg(64)->Arg(255)->Arg(4096)->Arg(65536)->Arg(1 << 20);
+BENCHMARK(BM_MurmurHash64AMessages);
+
+BENCHMARK_MAIN();
\ No newline at end of file